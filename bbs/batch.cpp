@@ -127,14 +127,12 @@ static void downloaded(const string& file_name, long lCharsPerSecond) {
       if (nRecNum > 0) {
         File file(a()->download_filename_);
         file.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile);
-        FileAreaSetRecord(file, nRecNum);
-        file.Read(&u, sizeof(uploadsrec));
+        FileAreaReadRecord(file, nRecNum, &u);
         a()->user()->SetFilesDownloaded(a()->user()->GetFilesDownloaded() + 1);
         a()->user()->SetDownloadK(a()->user()->GetDownloadK() +
             static_cast<int>(bytes_to_k(u.numbytes)));
         ++u.numdloads;
-        FileAreaSetRecord(file, nRecNum);
-        file.Write(&u, sizeof(uploadsrec));
+        FileAreaWriteRecord(file, nRecNum, &u);
         file.Close();
         if (lCharsPerSecond) {
           sysoplog() << "Downloaded '" << u.filename << "' (" << lCharsPerSecond << " cps).";
@@ -173,8 +171,7 @@ void didnt_upload(const batchrec& b) {
     File file(a()->download_filename_);
     file.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite, File::shareDenyNone);
     do {
-      FileAreaSetRecord(file, nRecNum);
-      file.Read(&u, sizeof(uploadsrec));
+      FileAreaReadRecord(file, nRecNum, &u);
       if (u.numbytes != 0) {
         file.Close();
         nRecNum = nrecno(b.filename, nRecNum);
@@ -187,18 +184,14 @@ void didnt_upload(const batchrec& b) {
         delete_extended_description(u.filename);
       }
       for (int i1 = nRecNum; i1 < a()->numf; i1++) {
-        FileAreaSetRecord(file, i1 + 1);
-        file.Read(&u, sizeof(uploadsrec));
-        FileAreaSetRecord(file, i1);
-        file.Write(&u, sizeof(uploadsrec));
+        FileAreaReadRecord(file, i1 + 1, &u);
+        FileAreaWriteRecord(file, i1, &u);
       }
       --nRecNum;
       --a()->numf;
-      FileAreaSetRecord(file, 0);
-      file.Read(&u, sizeof(uploadsrec));
+      FileAreaReadRecord(file, 0, &u);
       u.numbytes = a()->numf;
-      FileAreaSetRecord(file, 0);
-      file.Write(&u, sizeof(uploadsrec));
+      FileAreaWriteRecord(file, 0, &u);
       return;
     }
   }
@@ -217,8 +210,7 @@ static void uploaded(const string& file_name, long lCharsPerSecond) {
         File downFile(a()->download_filename_);
         downFile.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
         do {
-          FileAreaSetRecord(downFile, nRecNum);
-          downFile.Read(&u, sizeof(uploadsrec));
+          FileAreaReadRecord(downFile, nRecNum, &u);
           if (u.numbytes != 0) {
             nRecNum = nrecno(b.filename, nRecNum);
           }
@@ -267,8 +259,7 @@ static void uploaded(const string& file_name, long lCharsPerSecond) {
               });
               File fileDn(a()->download_filename_);
               fileDn.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
-              FileAreaSetRecord(fileDn, nRecNum);
-              fileDn.Write(&u, sizeof(uploadsrec));
+              FileAreaWriteRecord(fileDn, nRecNum, &u);
               fileDn.Close();
               sysoplog() << StringPrintf("+ \"%s\" uploaded on %s (%ld cps)", u.filename, a()->directories[b.dir].name, lCharsPerSecond);
               bout << "Uploaded '" << u.filename << "' to "  << a()->directories[b.dir].name 
@@ -373,8 +364,7 @@ void zmbatchdl(bool bHangupAfterDl) {
               ctim(a()->batch().dl_time_in_secs()), "\r\n"));
         File file(a()->download_filename_);
         file.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
-        FileAreaSetRecord(file, nRecordNumber);
-        file.Read(&u, sizeof(uploadsrec));
+        FileAreaReadRecord(file, nRecordNumber, &u);
         file.Close();
         auto send_filename =
             FilePath(a()->directories[a()->batch().entry[cur].dir].path, u.filename);
@@ -454,8 +444,7 @@ void ymbatchdl(bool bHangupAfterDl) {
               ", Time left - ", ctim(a()->batch().dl_time_in_secs()),"\r\n"));
         File file(a()->download_filename_);
         file.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
-        FileAreaSetRecord(file, nRecordNumber);
-        file.Read(&u, sizeof(uploadsrec));
+        FileAreaReadRecord(file, nRecordNumber, &u);
         file.Close();
         auto send_filename =
             FilePath(a()->directories[a()->batch().entry[cur].dir].path, u.filename);
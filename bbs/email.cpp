@@ -213,12 +213,10 @@ void sendout_email(EmailData& data) {
       i = 0;
     } else {
       i = nEmailFileLen - 1;
-      pFileEmail->Seek(i * sizeof(mailrec), File::Whence::begin);
-      pFileEmail->Read(&messageRecord, sizeof(mailrec));
+      pFileEmail->ReadAt(i * sizeof(mailrec), &messageRecord, sizeof(mailrec));
       while (i > 0 && messageRecord.tosys == 0 && messageRecord.touser == 0) {
         --i;
-        pFileEmail->Seek(i * sizeof(mailrec), File::Whence::begin);
-        int i1 = pFileEmail->Read(&messageRecord, sizeof(mailrec));
+        int i1 = pFileEmail->ReadAt(i * sizeof(mailrec), &messageRecord, sizeof(mailrec));
         if (i1 == -1) {
           bout << "|#6DIDN'T READ WRITE!\r\n";
         }
@@ -228,8 +226,7 @@ void sendout_email(EmailData& data) {
       }
     }
 
-    pFileEmail->Seek(i * sizeof(mailrec), File::Whence::begin);
-    int nBytesWritten = pFileEmail->Write(&m, sizeof(mailrec));
+    int nBytesWritten = pFileEmail->WriteAt(i * sizeof(mailrec), &m, sizeof(mailrec));
     pFileEmail->Close();
     if (nBytesWritten == -1) {
       bout << "|#6DIDN'T SAVE RIGHT!\r\n";
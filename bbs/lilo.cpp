@@ -1009,8 +1009,7 @@ void logoff() {
       int r = 0;
       int w = 0;
       while (r < num_records) {
-        pFileEmail->Seek(static_cast<long>(sizeof(mailrec)) * static_cast<long>(r), File::Whence::begin);
-        pFileEmail->Read(&m, sizeof(mailrec));
+        pFileEmail->ReadAt(static_cast<long>(sizeof(mailrec)) * static_cast<long>(r), &m, sizeof(mailrec));
         if (m.tosys != 0 || m.touser != 0) {
           if (m.tosys == 0 && m.touser == a()->usernum) {
             if (a()->user()->GetNumMailWaiting() != 255) {
@@ -1018,8 +1017,7 @@ void logoff() {
             }
           }
           if (r != w) {
-            pFileEmail->Seek(static_cast<long>(sizeof(mailrec)) * static_cast<long>(w), File::Whence::begin);
-            pFileEmail->Write(&m, sizeof(mailrec));
+            pFileEmail->WriteAt(static_cast<long>(sizeof(mailrec)) * static_cast<long>(w), &m, sizeof(mailrec));
           }
           ++w;
         }
@@ -1029,8 +1027,7 @@ void logoff() {
         m.tosys = 0;
         m.touser = 0;
         for (int w1 = w; w1 < r; w1++) {
-          pFileEmail->Seek(static_cast<long>(sizeof(mailrec)) * static_cast<long>(w1), File::Whence::begin);
-          pFileEmail->Write(&m, sizeof(mailrec));
+          pFileEmail->WriteAt(static_cast<long>(sizeof(mailrec)) * static_cast<long>(w1), &m, sizeof(mailrec));
         }
       }
       pFileEmail->set_length(static_cast<long>(sizeof(mailrec)) * static_cast<long>(w));
@@ -1195,8 +1195,7 @@ static int rename_filename(const char *file_name, int dn) {
       break;
     }
     cp = i;
-    FileAreaSetRecord(fileDownload, i);
-    fileDownload.Read(&u, sizeof(uploadsrec));
+    FileAreaReadRecord(fileDownload, i, &u);
     fileDownload.Close();
     bout.nl();
     printfileinfo(&u, dn);
@@ -1279,8 +1278,7 @@ static int rename_filename(const char *file_name, int dn) {
       u.mask &= ~mask_extended;
     }
     if (fileDownload.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite)) {
-      FileAreaSetRecord(fileDownload, i);
-      fileDownload.Write(&u, sizeof(uploadsrec));
+      FileAreaWriteRecord(fileDownload, i, &u);
       fileDownload.Close();
     }
     i = nrecno(orig_aligned_filename, cp);
@@ -1310,8 +1308,7 @@ static int remove_filename(const char *file_name, int dn) {
   while (!a()->hangup_ && i > 0 && !abort) {
     File fileDownload(a()->download_filename_);
     if (fileDownload.Open(File::modeReadOnly | File::modeBinary)) {
-      FileAreaSetRecord(fileDownload, i);
-      fileDownload.Read(&u, sizeof(uploadsrec));
+      FileAreaReadRecord(fileDownload, i, &u);
       fileDownload.Close();
     }
     if (dcs() || (u.ownersys == 0 && u.ownerusr == a()->usernum)) {
@@ -1363,18 +1360,14 @@ static int remove_filename(const char *file_name, int dn) {
 
         if (fileDownload.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite)) {
           for (int i1 = i; i1 < a()->numf; i1++) {
-            FileAreaSetRecord(fileDownload, i1 + 1);
-            fileDownload.Read(&u, sizeof(uploadsrec));
-            FileAreaSetRecord(fileDownload, i1);
-            fileDownload.Write(&u, sizeof(uploadsrec));
+            FileAreaReadRecord(fileDownload, i1 + 1, &u);
+            FileAreaWriteRecord(fileDownload, i1, &u);
           }
           --i;
           --a()->numf;
-          FileAreaSetRecord(fileDownload, 0);
-          fileDownload.Read(&u, sizeof(uploadsrec));
+          FileAreaReadRecord(fileDownload, 0, &u);
           u.numbytes = a()->numf;
-          FileAreaSetRecord(fileDownload, 0);
-          fileDownload.Write(&u, sizeof(uploadsrec));
+          FileAreaWriteRecord(fileDownload, 0, &u);
           fileDownload.Close();
         }
       }
@@ -1407,8 +1400,7 @@ static int move_filename(const char *file_name, int dn) {
     int cp = nRecNum;
     File fileDownload(a()->download_filename_);
     if (fileDownload.Open(File::modeBinary | File::modeReadOnly)) {
-      FileAreaSetRecord(fileDownload, nRecNum);
-      fileDownload.Read(&u, sizeof(uploadsrec));
+      FileAreaReadRecord(fileDownload, nRecNum, &u);
       fileDownload.Close();
     }
     bout.nl();
@@ -1498,17 +1490,13 @@ static int move_filename(const char *file_name, int dn) {
       --cp;
       if (fileDownload.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite)) {
         for (int i2 = nRecNum; i2 < a()->numf; i2++) {
-          FileAreaSetRecord(fileDownload, i2 + 1);
-          fileDownload.Read(&u1, sizeof(uploadsrec));
-          FileAreaSetRecord(fileDownload, i2);
-          fileDownload.Write(&u1, sizeof(uploadsrec));
+          FileAreaReadRecord(fileDownload, i2 + 1, &u1);
+          FileAreaWriteRecord(fileDownload, i2, &u1);
         }
         --a()->numf;
-        FileAreaSetRecord(fileDownload, 0);
-        fileDownload.Read(&u1, sizeof(uploadsrec));
+        FileAreaReadRecord(fileDownload, 0, &u1);
         u1.numbytes = a()->numf;
-        FileAreaSetRecord(fileDownload, 0);
-        fileDownload.Write(&u1, sizeof(uploadsrec));
+        FileAreaWriteRecord(fileDownload, 0, &u1);
         fileDownload.Close();
       }
       string ss = read_extended_description(u.filename);
@@ -1519,22 +1507,17 @@ static int move_filename(const char *file_name, int dn) {
       dliscan1(nDestDirNum);
       if (fileDownload.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite)) {
         for (int i = a()->numf; i >= 1; i--) {
-          FileAreaSetRecord(fileDownload, i);
-          fileDownload.Read(&u1, sizeof(uploadsrec));
-          FileAreaSetRecord(fileDownload, i + 1);
-          fileDownload.Write(&u1, sizeof(uploadsrec));
+          FileAreaReadRecord(fileDownload, i, &u1);
+          FileAreaWriteRecord(fileDownload, i + 1, &u1);
         }
-        FileAreaSetRecord(fileDownload, 1);
-        fileDownload.Write(&u, sizeof(uploadsrec));
+        FileAreaWriteRecord(fileDownload, 1, &u);
         ++a()->numf;
-        FileAreaSetRecord(fileDownload, 0);
-        fileDownload.Read(&u1, sizeof(uploadsrec));
+        FileAreaReadRecord(fileDownload, 0, &u1);
         u1.numbytes = a()->numf;
         if (u.daten > u1.daten) {
           u1.daten = u.daten;
         }
-        FileAreaSetRecord(fileDownload, 0);
-        fileDownload.Write(&u1, sizeof(uploadsrec));
+        FileAreaWriteRecord(fileDownload, 0, &u1);
         fileDownload.Close();
       }
       if (!ss.empty()) {
@@ -1748,8 +1731,7 @@ void view_file(const char *file_name) {
       uploadsrec u{};
       File fileDownload(a()->download_filename_);
       if (fileDownload.Open(File::modeBinary | File::modeReadOnly)) {
-        FileAreaSetRecord(fileDownload, i);
-        fileDownload.Read(&u, sizeof(uploadsrec));
+        FileAreaReadRecord(fileDownload, i, &u);
         fileDownload.Close();
       }
       int i1 = list_arc_out(stripfn(u.filename), a()->directories[a()->current_user_dir().subnum].path);
@@ -1783,8 +1765,7 @@ int lp_try_to_download(const char *file_mask, int dn) {
     a()->tleft(true);
     File fileDownload(a()->download_filename_);
     fileDownload.Open(File::modeBinary | File::modeReadOnly);
-    FileAreaSetRecord(fileDownload, i);
-    fileDownload.Read(&u, sizeof(uploadsrec));
+    FileAreaReadRecord(fileDownload, i, &u);
     fileDownload.Close();
 
     ok2 = 0;
@@ -183,8 +183,7 @@ int listfiles_plus_function(int type) {
         if (a()->numf) {
           changedir = 0;
           bool force_menu = false;
-          FileAreaSetRecord(fileDownload, first_file + amount);
-          fileDownload.Read(file_recs[matches], sizeof(uploadsrec));
+          FileAreaReadRecord(fileDownload, first_file + amount, file_recs[matches]);
           if (compare_criteria(&search_rec, file_recs[matches])) {
             int lines_left = max_lines - lines;
             int needed = check_lines_needed(file_recs[matches]);
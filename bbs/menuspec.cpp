@@ -103,8 +103,7 @@ int MenuDownload(const std::string& dir_fn, const std::string& dl_fn, bool bFree
     a()->tleft(true);
     File fileDownload(a()->download_filename_);
     fileDownload.Open(File::modeBinary | File::modeReadOnly);
-    FileAreaSetRecord(fileDownload, nRecordNumber);
-    fileDownload.Read(&u, sizeof(uploadsrec));
+    FileAreaReadRecord(fileDownload, nRecordNumber, &u);
     fileDownload.Close();
     bout.nl();
 
@@ -142,8 +141,7 @@ int MenuDownload(const std::string& dir_fn, const std::string& dl_fn, bool bFree
         }
         ++u.numdloads;
         fileDownload.Open(File::modeBinary | File::modeReadWrite);
-        FileAreaSetRecord(fileDownload, nRecordNumber);
-        fileDownload.Write(&u, sizeof(uploadsrec));
+        FileAreaWriteRecord(fileDownload, nRecordNumber, &u);
         fileDownload.Close();
 
         sysoplog() << "Downloaded '" << u.filename << "'.";
@@ -75,8 +75,7 @@ void kill_old_email() {
 
   bool done = false;
   do {
-    pFileEmail->Seek(cur * sizeof(mailrec), File::Whence::begin);
-    pFileEmail->Read(&m, sizeof(mailrec));
+    pFileEmail->ReadAt(cur * sizeof(mailrec), &m, sizeof(mailrec));
     while ((m.fromsys != 0 || m.fromuser != a()->usernum || m.touser == 0) && cur < max && cur >= 0) {
       if (forward) {
         --cur;
@@ -84,8 +83,7 @@ void kill_old_email() {
         ++cur;
       }
       if (cur < max && cur >= 0) {
-        pFileEmail->Seek(cur * sizeof(mailrec), File::Whence::begin);
-        pFileEmail->Read(&m, sizeof(mailrec));
+        pFileEmail->ReadAt(cur * sizeof(mailrec), &m, sizeof(mailrec));
       }
     }
     if (m.fromsys != 0 || m.fromuser != a()->usernum || m.touser == 0 || cur >= max || cur < 0) {
@@ -329,9 +329,9 @@ void post(const PostData& post_data) {
 
 void add_ftn_msgid(const wwiv::sdk::Config& config, FidoAddress addr, const std::string& msgid,
                    MessageEditorData* data) {
-  FtnMessageDupe dupe(config);
-  if (dupe.IsInitialized()) {
-    auto new_msgid = dupe.CreateMessageID(addr);
+  // Only the MSGID is needed here, so don't open the dupe file.
+  if (!config.datadir().empty()) {
+    auto new_msgid = FtnMessageDupe::CreateMessageID(config.datadir(), addr);
     WWIVParsedMessageText pmt(data->text);
     // TODO(rushfan): Should we keep removing them while they exist in case
     // there are more than 1??
@@ -404,10 +404,8 @@ void qscan(uint16_t start_subnum, bool& nextsub) {
     bout.bprintf("\r\n\n|#1< Q-scan %s %s - %lu msgs >\r\n", a()->current_sub().name.c_str(),
                  a()->current_user_sub().keys, a()->GetNumMessagesInCurrentMessageArea());
 
-    int i;
-    for (i = a()->GetNumMessagesInCurrentMessageArea();
-         (i > 1) && (get_post(i - 1)->qscan > memory_last_read); i--)
-      ;
+    int i = std::min(first_post_after_qscan(memory_last_read),
+                     a()->GetNumMessagesInCurrentMessageArea());
 
     if (a()->GetNumMessagesInCurrentMessageArea() > 0 &&
         i <= a()->GetNumMessagesInCurrentMessageArea() &&
@@ -346,12 +346,13 @@ static FullScreenView CreateFullScreenListTitlesView() {
   return FullScreenView(num_header_lines, screen_width, screen_length);
 }
 
-static std::string CreateLine(std::unique_ptr<wwiv::sdk::msgapi::Message>&& msg, const int msgnum) {
-  if (!msg) {
+static std::string CreateLine(std::unique_ptr<wwiv::sdk::msgapi::MessageHeader>&& header,
+                              const int msgnum) {
+  if (!header) {
     return "";
   }
   string tmpbuf;
-  const auto& h = msg->header();
+  const auto& h = *header;
   if (h.local() && h.from_usernum() == a()->usernum) {
     tmpbuf = StringPrintf("|09[|11%d|09]", msgnum);
   }
@@ -413,7 +414,7 @@ static std::string CreateLine(std::unique_ptr<wwiv::sdk::msgapi::Message>&& msg,
 static std::vector<std::string> CreateMessageTitleVector(MessageArea* area, int start, int num) {
   vector<string> lines;
   for (auto i = start; i < (start + num); i++) {
-    auto line = CreateLine(area->ReadMessage(i), i);
+    auto line = CreateLine(area->ReadMessageHeader(i), i);
     if (!line.empty()) {
       lines.push_back(line);
     }
@@ -642,7 +643,7 @@ static void HandleListTitles(int &msgnum, MsgScanOption& scan_option_type) {
   int i = 0;
   while (!abort && ++i <= num_title_lines) {
     ++msgnum;
-    const string line = CreateLine(area->ReadMessage(msgnum), msgnum);
+    const string line = CreateLine(area->ReadMessageHeader(msgnum), msgnum);
     bout.bpla(line, &abort);
     if (msgnum >= num_msgs_in_area) {
       abort = true;
@@ -269,20 +269,15 @@ void normalupload(int dn) {
           File fileDownload(a()->download_filename_);
           fileDownload.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
           for (int j = a()->numf; j >= 1; j--) {
-            FileAreaSetRecord(fileDownload, j);
-            fileDownload.Read(&u1, sizeof(uploadsrec));
-            FileAreaSetRecord(fileDownload, j + 1);
-            fileDownload.Write(&u1, sizeof(uploadsrec));
+            FileAreaReadRecord(fileDownload, j, &u1);
+            FileAreaWriteRecord(fileDownload, j + 1, &u1);
           }
-          FileAreaSetRecord(fileDownload, 1);
-          fileDownload.Write(&u, sizeof(uploadsrec));
+          FileAreaWriteRecord(fileDownload, 1, &u);
           ++a()->numf;
-          FileAreaSetRecord(fileDownload, 0);
-          fileDownload.Read(&u1, sizeof(uploadsrec));
+          FileAreaReadRecord(fileDownload, 0, &u1);
           u1.numbytes = a()->numf;
           u1.daten = static_cast<uint32_t>(lCurrentTime);
-          FileAreaSetRecord(fileDownload, 0);
-          fileDownload.Write(&u1, sizeof(uploadsrec));
+          FileAreaWriteRecord(fileDownload, 0, &u1);
           fileDownload.Close();
           if (ok == 1) {
             a()->status_manager()->Run([](WStatus& s) {
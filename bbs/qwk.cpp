@@ -256,8 +256,7 @@ void qwk_gather_sub(int bn, struct qwk_junk *qwk_info) {
 
     if (!qwk_percent) {
       // Find out what message number we are on
-      for (i = a()->GetNumMessagesInCurrentMessageArea(); (i > 1) && (get_post(i - 1)->qscan > qscnptrx); i--)
-        ;
+      i = std::min(first_post_after_qscan(qscnptrx), a()->GetNumMessagesInCurrentMessageArea());
     } else { // Get last qwk_percent of messages in sub
       temp_percent = static_cast<float>(qwk_percent) / 100;
       if (temp_percent > 1.0) {
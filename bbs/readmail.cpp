@@ -114,8 +114,7 @@ static void purgemail(vector<tmpmailrec>& mloc, int mw, int *curmail, mailrec *
     }
     for (int i = 0; i < mw; i++) {
       if (mloc[i].index >= 0) {
-        pFileEmail->Seek(mloc[i].index * sizeof(mailrec), File::Whence::begin);
-        pFileEmail->Read(&m, sizeof(mailrec));
+        pFileEmail->ReadAt(mloc[i].index * sizeof(mailrec), &m, sizeof(mailrec));
         if (same_email(mloc[i], m)) {
           if (m.fromuser == m1->fromuser && m.fromsys == m1->fromsys) {
             bout << "Deleting mail msg #" << i + 1 << wwiv::endl;
@@ -153,8 +152,7 @@ static void resynch_email(vector<tmpmailrec>& mloc, int mw, int rec, mailrec * m
     int mp = 0;
 
     for (i = 0; i < mfl; i++) {
-      pFileEmail->Seek(i * sizeof(mailrec), File::Whence::begin);
-      pFileEmail->Read(&m1, sizeof(mailrec));
+      pFileEmail->ReadAt(i * sizeof(mailrec), &m1, sizeof(mailrec));
 
       if (m1.tosys == 0 && m1.touser == a()->usernum) {
         for (i1 = mp; i1 < mw; i1++) {
@@ -178,8 +176,7 @@ static void resynch_email(vector<tmpmailrec>& mloc, int mw, int rec, mailrec * m
 
     if (stat && !del && (mloc[rec].index >= 0)) {
       m->status |= stat;
-      pFileEmail->Seek(mloc[rec].index * sizeof(mailrec), File::Whence::begin);
-      pFileEmail->Write(m, sizeof(mailrec));
+      pFileEmail->WriteAt(mloc[rec].index * sizeof(mailrec), m, sizeof(mailrec));
     }
     if (del && (mloc[rec].index >= 0)) {
       if (del == 2) {
@@ -188,8 +185,7 @@ static void resynch_email(vector<tmpmailrec>& mloc, int mw, int rec, mailrec * m
         m->daten = 0xffffffff;
         m->msg.storage_type = 0;
         m->msg.stored_as = 0xffffffff;
-        pFileEmail->Seek(mloc[rec].index * sizeof(mailrec), File::Whence::begin);
-        pFileEmail->Write(m, sizeof(mailrec));
+        pFileEmail->WriteAt(mloc[rec].index * sizeof(mailrec), m, sizeof(mailrec));
       } else {
         delmail(*pFileEmail.get(), mloc[rec].index);
       }
@@ -208,8 +204,7 @@ bool read_same_email(std::vector<tmpmailrec>& mloc, int mw, int rec, mailrec& m,
   }
 
   unique_ptr<File> pFileEmail(OpenEmailFile(del || stat));
-  pFileEmail->Seek(mloc[rec].index * sizeof(mailrec), File::Whence::begin);
-  pFileEmail->Read(&m, sizeof(mailrec));
+  pFileEmail->ReadAt(mloc[rec].index * sizeof(mailrec), &m, sizeof(mailrec));
 
   if (!same_email(mloc[rec], m)) {
     pFileEmail->Close();
@@ -222,8 +217,7 @@ bool read_same_email(std::vector<tmpmailrec>& mloc, int mw, int rec, mailrec& m,
   } else {
     if (stat && !del && (mloc[rec].index >= 0)) {
       m.status |= stat;
-      pFileEmail->Seek(mloc[rec].index * sizeof(mailrec), File::Whence::begin);
-      pFileEmail->Write(&m, sizeof(mailrec));
+      pFileEmail->WriteAt(mloc[rec].index * sizeof(mailrec), &m, sizeof(mailrec));
     }
     if (del) {
       if (del == 2) {
@@ -232,8 +226,7 @@ bool read_same_email(std::vector<tmpmailrec>& mloc, int mw, int rec, mailrec& m,
         m.daten = 0xffffffff;
         m.msg.storage_type = 0;
         m.msg.stored_as = 0xffffffff;
-        pFileEmail->Seek(mloc[rec].index * sizeof(mailrec), File::Whence::begin);
-        pFileEmail->Write(&m, sizeof(mailrec));
+        pFileEmail->WriteAt(mloc[rec].index * sizeof(mailrec), &m, sizeof(mailrec));
       } else {
         delmail(*pFileEmail.get(), mloc[rec].index);
       }
@@ -374,8 +367,7 @@ void readmail(int mode) {
     }
     int mfl = pFileEmail->length() / sizeof(mailrec);
     for (i = 0; (i < mfl) && (mw < MAXMAIL); i++) {
-      pFileEmail->Seek(i * sizeof(mailrec), File::Whence::begin);
-      pFileEmail->Read(&m, sizeof(mailrec));
+      pFileEmail->ReadAt(i * sizeof(mailrec), &m, sizeof(mailrec));
       if ((m.tosys == 0) && (m.touser == a()->usernum)) {
         tmpmailrec r = {};
         r.index = static_cast<int16_t>(i);
@@ -1008,8 +1000,7 @@ void readmail(int mode) {
                 if (!pFileEmail->IsOpen()) {
                   break;
                 }
-                pFileEmail->Seek(mloc[curmail].index * sizeof(mailrec), File::Whence::begin);
-                pFileEmail->Read(&m, sizeof(mailrec));
+                pFileEmail->ReadAt(mloc[curmail].index * sizeof(mailrec), &m, sizeof(mailrec));
                 if (!same_email(mloc[curmail], m)) {
                   bout << "Error, mail moved.\r\n";
                   break;
@@ -1025,8 +1016,7 @@ void readmail(int mode) {
                   m1.daten = 0xffffffff;
                   m1.msg.storage_type = 0;
                   m1.msg.stored_as = 0xffffffff;
-                  pFileEmail->Seek(mloc[curmail].index * sizeof(mailrec), File::Whence::begin);
-                  pFileEmail->Write(&m1, sizeof(mailrec));
+                  pFileEmail->WriteAt(mloc[curmail].index * sizeof(mailrec), &m1, sizeof(mailrec));
                 }
                 else {
                   string b;
@@ -1250,8 +1240,7 @@ int check_new_mail(int user_number) {
     int mWaiting = 0;   // number of mail waiting
     for (int i = 0; (i < mfLength) && (mWaiting < MAXMAIL); i++) {
       mailrec m;
-      pFileEmail->Seek(i * sizeof(mailrec), File::Whence::begin);
-      pFileEmail->Read(&m, sizeof(mailrec));
+      pFileEmail->ReadAt(i * sizeof(mailrec), &m, sizeof(mailrec));
       if (m.tosys == 0 && m.touser == user_number) {
         if (!(m.status & status_seen)) {
           nNumNewMessages++;
@@ -18,6 +18,8 @@
 /**************************************************************************/
 #include "bbs/subacc.h"
 
+#include <algorithm>
+#include <cstring>
 #include <memory>
 #include <string>
 
@@ -36,6 +38,8 @@
 #include "core/wwivassert.h"
 #include "core/wwivport.h"
 #include "core/datetime.h"
+#include "sdk/msgapi/message_api_wwiv.h"
+#include "sdk/msgapi/sub_cache_wwiv.h"
 #include "sdk/status.h"
 #include "sdk/subxtr.h"
 #include "sdk/vardec.h"
@@ -56,9 +60,29 @@ static char subdat_fn[MAX_PATH];      // filename of .sub file
 
 using std::unique_ptr;
 using namespace wwiv::core;
+using namespace wwiv::sdk::msgapi;
 using namespace wwiv::stl;
 using namespace wwiv::strings;
 
+static WWIVSubCache& sub_cache() { return a()->msgapi_email()->sub_cache(); }
+
+// Number of posts in the sub, not counting the ones deleted through the
+// message API that haven't been compacted yet. Only 5.x headers have those.
+static int live_message_count(const subfile_header_t& h) {
+  if (strncmp(h.signature, "WWIV\x1A", 5) != 0) {
+    return h.active_message_count;
+  }
+  return h.active_message_count - std::min(h.tombstone_message_count, h.active_message_count);
+}
+
+// Message numbers skip those deleted posts, this returns the record number
+// in the .sub file for message number mn.
+static int record_number(int mn) {
+  const auto* index = sub_cache().get(subdat_fn);
+  const auto record = index ? index->record_number(mn) : 0;
+  return record > 0 ? record : mn;
+}
+
 void close_sub() {
   if (fileSub) {
     fileSub.reset();
@@ -72,9 +96,9 @@ bool open_sub(bool wr) {
     if (fileSub->IsOpen()) {
       // re-read info from file, to be safe
       fileSub->Seek(0L, File::Whence::begin);
-      postrec p{};
-      fileSub->Read(&p, sizeof(postrec));
-      a()->SetNumMessagesInCurrentMessageArea(p.owneruser);
+      subfile_header_t h{};
+      fileSub->Read(&h, sizeof(subfile_header_t));
+      a()->SetNumMessagesInCurrentMessageArea(live_message_count(h));
     }
   } else {
     fileSub->Open(File::modeReadOnly | File::modeBinary);
@@ -99,22 +123,15 @@ uint32_t WWIVReadLastRead(int sub_number) {
     return 1;
   }
 
-  if (!subFile.Open(File::modeBinary | File::modeReadOnly)) {
+  const auto* index = sub_cache().get(subFile.full_pathname());
+  if (!index) {
     return 0;
   }
-  // read in first rec, specifying # posts
-  // p.owneruser contains # of posts.
-  subFile.Read(&p, sizeof(postrec));
-
-  if (p.owneruser == 0) {
+  if (index->number_of_messages() == 0) {
     // Not sure why but iscan1 returned 1 for empty subs.
     return 1;
   }
-
-  // read in sub date, if don't already know it
-  subFile.Seek(p.owneruser * sizeof(postrec), File::Whence::begin);
-  subFile.Read(&p, sizeof(postrec));
-  return p.qscan;
+  return index->last_qscan();
 }
 
 // Initializes use of a sub value (a()->subs().subs()[], not a()->usub[]).  If quick, then
@@ -145,7 +162,10 @@ bool iscan1(int sub_index) {
     }
     p.owneruser = 0;
     fileSub->Write(&p, sizeof(postrec));
-  } else if (!open_sub(false)) {
+    close_sub();
+  }
+  const auto* index = sub_cache().get(subdat_fn);
+  if (!index) {
     return false;
   }
 
@@ -153,17 +173,13 @@ bool iscan1(int sub_index) {
   a()->SetCurrentReadMessageArea(sub_index);
   a()->subchg = 0;
 
-  // read in first rec, specifying # posts
-  fileSub->Seek(0L, File::Whence::begin);
-  fileSub->Read(&p, sizeof(postrec));
-  a()->SetNumMessagesInCurrentMessageArea(p.owneruser);
+  // # posts comes from the header, the cache only rereads it once the
+  // sub has changed.
+  a()->SetNumMessagesInCurrentMessageArea(index->number_of_messages());
 
   // We used to read in sub date, if don't already know it
   // Not callers should use WWIVReadLastRead to get it.
 
-  // close file
-  close_sub();
-
   // iscanned correctly
   return true;
 }
@@ -188,7 +204,7 @@ postrec* get_post(int mn) {
   }
   // read in post
   static postrec p;
-  fileSub->Seek(mn * sizeof(postrec), File::Whence::begin);
+  fileSub->Seek(record_number(mn) * sizeof(postrec), File::Whence::begin);
   fileSub->Read(&p, sizeof(postrec));
 
   if (need_close) {
@@ -197,11 +213,21 @@ postrec* get_post(int mn) {
   return &p;
 }
 
+// Returns the number of the first post in the current sub with a qscan
+// pointer newer than qscan, or the number of posts + 1 if there are none.
+int first_post_after_qscan(uint32_t qscan) {
+  const auto* index = sub_cache().get(subdat_fn);
+  if (!index) {
+    return a()->GetNumMessagesInCurrentMessageArea() + 1;
+  }
+  return index->first_message_after(qscan);
+}
+
 void write_post(int mn, postrec* pp) {
   if (!fileSub || !fileSub->IsOpen()) {
     return;
   }
-  fileSub->Seek(mn * sizeof(postrec), File::Whence::begin);
+  fileSub->Seek(record_number(mn) * sizeof(postrec), File::Whence::begin);
   fileSub->Write(pp, sizeof(postrec));
 }
 
@@ -236,12 +262,12 @@ void add_post(postrec* pp) {
   // one more post
   p.active_message_count++;
   p.mod_count++;
-  a()->SetNumMessagesInCurrentMessageArea(p.active_message_count);
+  a()->SetNumMessagesInCurrentMessageArea(live_message_count(p));
   fileSub->Seek(0L, File::Whence::begin);
   fileSub->Write(&p, sizeof(postrec));
 
   // add the new post
-  fileSub->Seek(a()->GetNumMessagesInCurrentMessageArea() * sizeof(postrec), File::Whence::begin);
+  fileSub->Seek(p.active_message_count * sizeof(postrec), File::Whence::begin);
   fileSub->Write(pp, sizeof(postrec));
 
   // we've modified the sub
@@ -272,8 +298,12 @@ void delete_message(int mn) {
         postrec* p1 = get_post(mn);
         remove_link(&(p1->msg), a()->current_sub().filename);
 
-        auto cp = static_cast<long>(mn + 1) * sizeof(postrec);
-        auto len = static_cast<long>(a()->GetNumMessagesInCurrentMessageArea() + 1) * sizeof(postrec);
+        subfile_header_t p{};
+        fileSub->Seek(0L, File::Whence::begin);
+        fileSub->Read(&p, sizeof(subfile_header_t));
+
+        auto cp = static_cast<long>(record_number(mn) + 1) * sizeof(postrec);
+        auto len = static_cast<long>(p.active_message_count + 1) * sizeof(postrec);
 
         unsigned int nb = 0;
         do {
@@ -289,13 +319,10 @@ void delete_message(int mn) {
         } while (nb == BUFSIZE);
 
         // update # msgs
-        postrec p;
-        fileSub->Seek(0L, File::Whence::begin);
-        fileSub->Read(&p, sizeof(postrec));
-        p.owneruser--;
-        a()->SetNumMessagesInCurrentMessageArea(p.owneruser);
+        p.active_message_count--;
+        a()->SetNumMessagesInCurrentMessageArea(live_message_count(p));
         fileSub->Seek(0L, File::Whence::begin);
-        fileSub->Write(&p, sizeof(postrec));
+        fileSub->Write(&p, sizeof(subfile_header_t));
         free(buffer);
       }
     }
@@ -27,6 +27,7 @@ uint32_t WWIVReadLastRead(int sub_number);
 bool iscan1(int si);
 int iscan(int b);
 postrec *get_post(int mn);
+int first_post_after_qscan(uint32_t qscan);
 void delete_message(int mn);
 void write_post(int mn, postrec * pp);
 void add_post(postrec * pp);
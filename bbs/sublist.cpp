@@ -222,11 +222,7 @@ void SubList() {
         } else {
           strcpy(s3, "|#7>|#1LOCAL|#7<  ");
         }
-        msgIndex = 1;
-        while ((msgIndex <= a()->GetNumMessagesInCurrentMessageArea()) &&
-               (get_post(msgIndex)->qscan <= a()->context().qsc_p[a()->usub[i1].subnum])) {
-          ++msgIndex;
-        }
+        msgIndex = first_post_after_qscan(a()->context().qsc_p[a()->usub[i1].subnum]);
         newTally = a()->GetNumMessagesInCurrentMessageArea() - msgIndex + 1;
         if (a()->current_user_sub().subnum == a()->usub[i1].subnum) {
           sprintf(sdf, " |#9%-3.3d |#9\xB3 %3s |#9\xB3 %6s |#9\xB3 |17|15%-36.36s |#9\xB3 |#9%5d |#9\xB3 |#%c%5u |#9",
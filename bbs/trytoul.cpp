@@ -359,21 +359,16 @@ static int try_to_ul_wh(const string& orig_file_name) {
   File fileDownload(a()->download_filename_);
   fileDownload.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
   for (int i = a()->numf; i >= 1; i--) {
-    FileAreaSetRecord(fileDownload, i);
-    fileDownload.Read(&u1, sizeof(uploadsrec));
-    FileAreaSetRecord(fileDownload, i + 1);
-    fileDownload.Write(&u1, sizeof(uploadsrec));
+    FileAreaReadRecord(fileDownload, i, &u1);
+    FileAreaWriteRecord(fileDownload, i + 1, &u1);
   }
 
-  FileAreaSetRecord(fileDownload, 1);
-  fileDownload.Write(&u, sizeof(uploadsrec));
+  FileAreaWriteRecord(fileDownload, 1, &u);
   ++a()->numf;
-  FileAreaSetRecord(fileDownload, 0);
-  fileDownload.Read(&u1, sizeof(uploadsrec));
+  FileAreaReadRecord(fileDownload, 0, &u1);
   u1.numbytes = a()->numf;
   u1.daten = current_daten;
-  FileAreaSetRecord(fileDownload, 0);
-  fileDownload.Write(&u1, sizeof(uploadsrec));
+  FileAreaWriteRecord(fileDownload, 0, &u1);
   fileDownload.Close();
 
   add_to_file_database(u.filename);
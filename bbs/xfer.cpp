@@ -335,19 +335,16 @@ void dliscan1(int directory_num) {
     memset(&u, 0, sizeof(uploadsrec));
     to_char_array(u.filename, "|MARKER|");
     u.daten = daten_t_now();
-    FileAreaSetRecord(fileDownload, 0);
-    fileDownload.Write(&u, sizeof(uploadsrec));
+    FileAreaWriteRecord(fileDownload, 0, &u);
   } else {
-    FileAreaSetRecord(fileDownload, 0);
-    fileDownload.Read(&u, sizeof(uploadsrec));
+    FileAreaReadRecord(fileDownload, 0, &u);
     if (!IsEquals(u.filename, "|MARKER|")) {
       a()->numf = u.numbytes;
       memset(&u, 0, sizeof(uploadsrec));
       to_char_array(u.filename, "|MARKER|");
       u.daten = daten_t_now();
       u.numbytes = a()->numf;
-      FileAreaSetRecord(fileDownload, 0);
-      fileDownload.Write(&u, sizeof(uploadsrec));
+      FileAreaWriteRecord(fileDownload, 0, &u);
     }
   }
   fileDownload.Close();
@@ -725,9 +722,8 @@ void listfiles() {
   fileDownload.Open(File::modeBinary | File::modeReadOnly);
   bool abort = false;
   for (int i = 1; i <= a()->numf && !abort && !a()->hangup_; i++) {
-    FileAreaSetRecord(fileDownload, i);
     uploadsrec u;
-    fileDownload.Read(&u, sizeof(uploadsrec));
+    FileAreaReadRecord(fileDownload, i, &u);
     if (compare(filemask.c_str(), u.filename)) {
       fileDownload.Close();
 
@@ -769,9 +765,8 @@ void nscandir(uint16_t nDirNum, bool& need_title, bool *abort) {
     fileDownload.Open(File::modeBinary | File::modeReadOnly);
     for (int i = 1; i <= a()->numf && !(*abort) && !a()->hangup_; i++) {
       CheckForHangup();
-      FileAreaSetRecord(fileDownload, i);
       uploadsrec u;
-      fileDownload.Read(&u, sizeof(uploadsrec));
+      FileAreaReadRecord(fileDownload, i, &u);
       if (u.daten >= a()->context().nscandate()) {
         fileDownload.Close();
 
@@ -905,9 +900,8 @@ void searchall() {
       File fileDownload(a()->download_filename_);
       fileDownload.Open(File::modeBinary | File::modeReadOnly);
       for (int i1 = 1; i1 <= a()->numf && !abort && !a()->hangup_; i1++) {
-        FileAreaSetRecord(fileDownload, i1);
         uploadsrec u;
-        fileDownload.Read(&u, sizeof(uploadsrec));
+        FileAreaReadRecord(fileDownload, i1, &u);
         if (compare(filemask.c_str(), u.filename)) {
           fileDownload.Close();
           if (need_title) {
@@ -947,13 +941,11 @@ int nrecno(const std::string& file_mask, int nStartingRec) {
 
   File fileDownload(a()->download_filename_);
   fileDownload.Open(File::modeBinary | File::modeReadOnly);
-  FileAreaSetRecord(fileDownload, nRecNum);
   uploadsrec u{};
-  fileDownload.Read(&u, sizeof(uploadsrec));
+  FileAreaReadRecord(fileDownload, nRecNum, &u);
   while ((nRecNum < a()->numf) && (compare(file_mask.c_str(), u.filename) == 0)) {
     ++nRecNum;
-    FileAreaSetRecord(fileDownload, nRecNum);
-    fileDownload.Read(&u, sizeof(uploadsrec));
+    FileAreaReadRecord(fileDownload, nRecNum, &u);
   }
   fileDownload.Close();
   return (compare(file_mask.c_str(), u.filename)) ? nRecNum : -1;
@@ -1002,6 +994,12 @@ void remlist(const char *file_name) {
   }
 }
 
-int FileAreaSetRecord(File &file, int nRecordNumber) {
-  return file.Seek(nRecordNumber * sizeof(uploadsrec), File::Whence::begin);
+bool FileAreaReadRecord(File& file, int nRecordNumber, uploadsrec* u) {
+  return file.ReadAt(nRecordNumber * sizeof(uploadsrec), u, sizeof(uploadsrec)) ==
+         static_cast<ssize_t>(sizeof(uploadsrec));
+}
+
+bool FileAreaWriteRecord(File& file, int nRecordNumber, const uploadsrec* u) {
+  return file.WriteAt(nRecordNumber * sizeof(uploadsrec), u, sizeof(uploadsrec)) ==
+         static_cast<ssize_t>(sizeof(uploadsrec));
 }
@@ -52,6 +52,8 @@ int  recno(const std::string& file_mask);
 int  nrecno(const std::string& file_mask, int nStartingRec);
 int  printfileinfo(uploadsrec* upload_record, int directory_num);
 void remlist(const char *file_name);
-int FileAreaSetRecord(wwiv::core::File& file, int nRecordNumber);
+// Reads or writes record nRecordNumber of a *.dir file with a single call.
+bool FileAreaReadRecord(wwiv::core::File& file, int nRecordNumber, uploadsrec* u);
+bool FileAreaWriteRecord(wwiv::core::File& file, int nRecordNumber, const uploadsrec* u);
 
 #endif  // __INCLUDED_BBS_XFER_H__
\ No newline at end of file
@@ -87,8 +87,7 @@ void move_file() {
     int nCurrentPos = nCurRecNum;
     File fileDownload(a()->download_filename_);
     fileDownload.Open(File::modeBinary | File::modeReadOnly);
-    FileAreaSetRecord(fileDownload, nCurRecNum);
-    fileDownload.Read(&u, sizeof(uploadsrec));
+    FileAreaReadRecord(fileDownload, nCurRecNum, &u);
     fileDownload.Close();
     bout.nl();
     printfileinfo(&u, a()->current_user_dir().subnum);
@@ -149,17 +148,13 @@ void move_file() {
       --nCurrentPos;
       fileDownload.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
       for (int i1 = nCurRecNum; i1 < a()->numf; i1++) {
-        FileAreaSetRecord(fileDownload, i1 + 1);
-        fileDownload.Read(&u1, sizeof(uploadsrec));
-        FileAreaSetRecord(fileDownload, i1);
-        fileDownload.Write(&u1, sizeof(uploadsrec));
+        FileAreaReadRecord(fileDownload, i1 + 1, &u1);
+        FileAreaWriteRecord(fileDownload, i1, &u1);
       }
       --a()->numf;
-      FileAreaSetRecord(fileDownload, 0);
-      fileDownload.Read(&u1, sizeof(uploadsrec));
+      FileAreaReadRecord(fileDownload, 0, &u1);
       u1.numbytes = a()->numf;
-      FileAreaSetRecord(fileDownload, 0);
-      fileDownload.Write(&u1, sizeof(uploadsrec));
+      FileAreaWriteRecord(fileDownload, 0, &u1);
       fileDownload.Close();
       string ss = read_extended_description(u.filename);
       if (!ss.empty()) {
@@ -170,22 +165,17 @@ void move_file() {
       dliscan1(d1);
       fileDownload.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
       for (int i = a()->numf; i >= 1; i--) {
-        FileAreaSetRecord(fileDownload, i);
-        fileDownload.Read(&u1, sizeof(uploadsrec));
-        FileAreaSetRecord(fileDownload, i + 1);
-        fileDownload.Write(&u1, sizeof(uploadsrec));
+        FileAreaReadRecord(fileDownload, i, &u1);
+        FileAreaWriteRecord(fileDownload, i + 1, &u1);
       }
-      FileAreaSetRecord(fileDownload, 1);
-      fileDownload.Write(&u, sizeof(uploadsrec));
+      FileAreaWriteRecord(fileDownload, 1, &u);
       ++a()->numf;
-      FileAreaSetRecord(fileDownload, 0);
-      fileDownload.Read(&u1, sizeof(uploadsrec));
+      FileAreaReadRecord(fileDownload, 0, &u1);
       u1.numbytes = a()->numf;
       if (u.daten > u1.daten) {
         u1.daten = u.daten;
       }
-      FileAreaSetRecord(fileDownload, 0);
-      fileDownload.Write(&u1, sizeof(uploadsrec));
+      FileAreaWriteRecord(fileDownload, 0, &u1);
       fileDownload.Close();
       if (!ss.empty()) {
         add_extended_description(u.filename, ss);
@@ -248,27 +238,20 @@ static void quicksort(int l, int r, int type) {
   File fileDownload(a()->download_filename_);
   fileDownload.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
 
-  FileAreaSetRecord(fileDownload, ((l + r) / 2));
-  fileDownload.Read(&x, sizeof(uploadsrec));
+  FileAreaReadRecord(fileDownload, ((l + r) / 2), &x);
   do {
-    FileAreaSetRecord(fileDownload, i);
-    fileDownload.Read(&ua, sizeof(uploadsrec));
+    FileAreaReadRecord(fileDownload, i, &ua);
     while (comparedl(&ua, &x, type) < 0) {
-      FileAreaSetRecord(fileDownload, ++i);
-      fileDownload.Read(&ua, sizeof(uploadsrec));
+      FileAreaReadRecord(fileDownload, ++i, &ua);
     }
-    FileAreaSetRecord(fileDownload, j);
-    fileDownload.Read(&a2, sizeof(uploadsrec));
+    FileAreaReadRecord(fileDownload, j, &a2);
     while (comparedl(&a2, &x, type) > 0) {
-      FileAreaSetRecord(fileDownload, --j);
-      fileDownload.Read(&a2, sizeof(uploadsrec));
+      FileAreaReadRecord(fileDownload, --j, &a2);
     }
     if (i <= j) {
       if (i != j) {
-        FileAreaSetRecord(fileDownload, i);
-        fileDownload.Write(&a2, sizeof(uploadsrec));
-        FileAreaSetRecord(fileDownload, j);
-        fileDownload.Write(&a2, sizeof(uploadsrec));
+        FileAreaWriteRecord(fileDownload, i, &a2);
+        FileAreaWriteRecord(fileDownload, j, &a2);
       }
       i++;
       j--;
@@ -323,8 +306,7 @@ void rename_file() {
     File fileDownload(a()->download_filename_);
     fileDownload.Open(File::modeBinary | File::modeReadOnly);
     int nCurRecNum = nRecNum;
-    FileAreaSetRecord(fileDownload, nRecNum);
-    fileDownload.Read(&u, sizeof(uploadsrec));
+    FileAreaReadRecord(fileDownload, nRecNum, &u);
     fileDownload.Close();
     bout.nl();
     printfileinfo(&u, a()->current_user_dir().subnum);
@@ -407,8 +389,7 @@ void rename_file() {
       u.mask &= ~mask_extended;
     }
     fileDownload.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
-    FileAreaSetRecord(fileDownload, nRecNum);
-    fileDownload.Write(&u, sizeof(uploadsrec));
+    FileAreaWriteRecord(fileDownload, nRecNum, &u);
     fileDownload.Close();
     nRecNum = nrecno(s3, nCurRecNum);
   }
@@ -482,20 +463,15 @@ static bool upload_file(const std::string& file_name, uint16_t directory_num, co
     File fileDownload(a()->download_filename_);
     fileDownload.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
     for (int i = a()->numf; i >= 1; i--) {
-      FileAreaSetRecord(fileDownload, i);
-      fileDownload.Read(&u1, sizeof(uploadsrec));
-      FileAreaSetRecord(fileDownload, i + 1);
-      fileDownload.Write(&u1, sizeof(uploadsrec));
+      FileAreaReadRecord(fileDownload, i, &u1);
+      FileAreaWriteRecord(fileDownload, i + 1, &u1);
     }
-    FileAreaSetRecord(fileDownload, 1);
-    fileDownload.Write(&u, sizeof(uploadsrec));
+    FileAreaWriteRecord(fileDownload, 1, &u);
     ++a()->numf;
-    FileAreaSetRecord(fileDownload, 0);
-    fileDownload.Read(&u1, sizeof(uploadsrec));
+    FileAreaReadRecord(fileDownload, 0, &u1);
     u1.numbytes = a()->numf;
     u1.daten = daten_t_now();
-    FileAreaSetRecord(fileDownload, 0);
-    fileDownload.Write(&u1, sizeof(uploadsrec));
+    FileAreaWriteRecord(fileDownload, 0, &u1);
     fileDownload.Close();
     auto status = a()->status_manager()->BeginTransaction();
     status->IncrementNumUploadsToday();
@@ -539,8 +515,7 @@ bool maybe_upload(const std::string& file_name, uint16_t directory_num, const ch
   } else {
     File fileDownload(a()->download_filename_);
     fileDownload.Open(File::modeBinary | File::modeReadOnly);
-    FileAreaSetRecord(fileDownload, i);
-    fileDownload.Read(&u, sizeof(uploadsrec));
+    FileAreaReadRecord(fileDownload, i, &u);
     fileDownload.Close();
     auto ocd = a()->current_user_dir_num();
     a()->set_current_user_dir_num(directory_num);
@@ -625,14 +600,12 @@ void upload_files(const char* file_name, uint16_t directory_num, int type) {
           if (last_fn[0] && ext && *ext) {
             File fileDownload(a()->download_filename_);
             fileDownload.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
-            FileAreaSetRecord(fileDownload, 1);
-            fileDownload.Read(&u, sizeof(uploadsrec));
+            FileAreaReadRecord(fileDownload, 1, &u);
             if (IsEquals(last_fn, u.filename)) {
               add_to_file_database(u.filename);
               add_extended_description(last_fn, ext);
               u.mask |= mask_extended;
-              FileAreaSetRecord(fileDownload, 1);
-              fileDownload.Write(&u, sizeof(uploadsrec));
+              FileAreaWriteRecord(fileDownload, 1, &u);
             }
             fileDownload.Close();
             *ext = 0;
@@ -659,14 +632,12 @@ void upload_files(const char* file_name, uint16_t directory_num, int type) {
     if (ok && last_fn[0] && ext && *ext) {
       File fileDownload(a()->download_filename_);
       fileDownload.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
-      FileAreaSetRecord(fileDownload, 1);
-      fileDownload.Read(&u, sizeof(uploadsrec));
+      FileAreaReadRecord(fileDownload, 1, &u);
       if (IsEquals(last_fn, u.filename)) {
         add_to_file_database(u.filename);
         add_extended_description(last_fn, ext);
         u.mask |= mask_extended;
-        FileAreaSetRecord(fileDownload, 1);
-        fileDownload.Write(&u, sizeof(uploadsrec));
+        FileAreaWriteRecord(fileDownload, 1, &u);
       }
       fileDownload.Close();
     }
@@ -1116,8 +1087,7 @@ void finddescription() {
       File fileDownload(a()->download_filename_);
       fileDownload.Open(File::modeBinary | File::modeReadOnly);
       for (auto i1 = 1; i1 <= a()->numf && !abort && !a()->hangup_; i1++) {
-        FileAreaSetRecord(fileDownload, i1);
-        fileDownload.Read(&u, sizeof(uploadsrec));
+        FileAreaReadRecord(fileDownload, i1, &u);
         strcpy(s, u.description);
         for (i2 = 0; i2 < size_int(s); i2++) {
           s[i2] = upcase(s[i2]);
@@ -1172,8 +1142,7 @@ void arc_l() {
     if (nRecordNum > 0) {
       File fileDownload(a()->download_filename_);
       fileDownload.Open(File::modeBinary | File::modeReadOnly);
-      FileAreaSetRecord(fileDownload, nRecordNum);
-      fileDownload.Read(&u, sizeof(uploadsrec));
+      FileAreaReadRecord(fileDownload, nRecordNum, &u);
       fileDownload.Close();
       int i1 =
           list_arc_out(stripfn(u.filename), a()->directories[a()->current_user_dir().subnum].path);
@@ -330,8 +330,7 @@ int read_idz(int mode, int tempdir) {
   File fileDownload(a()->download_filename_);
   fileDownload.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
   for (i = 1; (i <= a()->numf) && (!a()->hangup_) && !abort; i++) {
-    FileAreaSetRecord(fileDownload, i);
-    fileDownload.Read(&u, sizeof(uploadsrec));
+    FileAreaReadRecord(fileDownload, i, &u);
     if ((compare(s.c_str(), u.filename)) &&
         (strstr(u.filename, ".COM") == nullptr) &&
         (strstr(u.filename, ".EXE") == nullptr)) {
@@ -342,8 +341,7 @@ int read_idz(int mode, int tempdir) {
         if (get_file_idz(&u, a()->udir[tempdir].subnum)) {
           count++;
         }
-        FileAreaSetRecord(fileDownload, i);
-        fileDownload.Write(&u, sizeof(uploadsrec));
+        FileAreaWriteRecord(fileDownload, i, &u);
       }
     }
     checka(&abort);
@@ -771,8 +769,7 @@ int try_to_download(const char *file_mask, int dn) {
     a()->tleft(true);
     File fileDownload(a()->download_filename_);
     fileDownload.Open(File::modeBinary | File::modeReadOnly);
-    FileAreaSetRecord(fileDownload, i);
-    fileDownload.Read(&u, sizeof(uploadsrec));
+    FileAreaReadRecord(fileDownload, i, &u);
     fileDownload.Close();
 
     if (!(u.mask & mask_no_ratio) && !ratio_ok()) {
@@ -1102,8 +1099,7 @@ void removefilesnotthere(int dn, int *autodel) {
     char szCandidateFileName[MAX_PATH];
     File fileDownload(a()->download_filename_);
     fileDownload.Open(File::modeBinary | File::modeReadOnly);
-    FileAreaSetRecord(fileDownload, i);
-    fileDownload.Read(&u, sizeof(uploadsrec));
+    FileAreaReadRecord(fileDownload, i, &u);
     fileDownload.Close();
     sprintf(szCandidateFileName, "%s%s", a()->directories[dn].path, u.filename);
     StringRemoveWhitespace(szCandidateFileName);
@@ -1132,18 +1128,14 @@ void removefilesnotthere(int dn, int *autodel) {
         sysoplog() << "- '" << u.filename << "' Removed from " << a()->directories[dn].name;
         fileDownload.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
         for (int i1 = i; i1 < a()->numf; i1++) {
-          FileAreaSetRecord(fileDownload, i1 + 1);
-          fileDownload.Read(&u, sizeof(uploadsrec));
-          FileAreaSetRecord(fileDownload, i1);
-          fileDownload.Write(&u, sizeof(uploadsrec));
+          FileAreaReadRecord(fileDownload, i1 + 1, &u);
+          FileAreaWriteRecord(fileDownload, i1, &u);
         }
         --i;
         --a()->numf;
-        FileAreaSetRecord(fileDownload, 0);
-        fileDownload.Read(&u, sizeof(uploadsrec));
+        FileAreaReadRecord(fileDownload, 0, &u);
         u.numbytes = a()->numf;
-        FileAreaSetRecord(fileDownload, 0);
-        fileDownload.Write(&u, sizeof(uploadsrec));
+        FileAreaWriteRecord(fileDownload, 0, &u);
         fileDownload.Close();
       } else if (ch == 'Q') {
         abort = true;
@@ -563,8 +563,7 @@ void temp_extract() {
   while ((i > 0) && ok && !a()->hangup_) {
     File fileDownload(a()->download_filename_);
     fileDownload.Open(File::modeBinary | File::modeReadOnly);
-    FileAreaSetRecord(fileDownload, i);
-    fileDownload.Read(&u, sizeof(uploadsrec));
+    FileAreaReadRecord(fileDownload, i, &u);
     fileDownload.Close();
     sprintf(s2, "%s%s", a()->directories[a()->current_user_dir().subnum].path, u.filename);
     StringRemoveWhitespace(s2);
@@ -757,8 +756,7 @@ void move_file_t() {
       nCurPos = nTempRecordNum;
       File fileDownload(a()->download_filename_);
       fileDownload.Open(File::modeReadOnly | File::modeBinary);
-      FileAreaSetRecord(fileDownload, nTempRecordNum);
-      fileDownload.Read(&u, sizeof(uploadsrec));
+      FileAreaReadRecord(fileDownload, nTempRecordNum, &u);
       fileDownload.Close();
       printfileinfo(&u, a()->batch().entry[nCurBatchPos].dir);
       bout << "|#5Move this (Y/N/Q)? ";
@@ -819,17 +817,13 @@ void move_file_t() {
         --nCurPos;
         fileDownload.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
         for (int i1 = nTempRecordNum; i1 < a()->numf; i1++) {
-          FileAreaSetRecord(fileDownload, i1 + 1);
-          fileDownload.Read(&u1, sizeof(uploadsrec));
-          FileAreaSetRecord(fileDownload, i1);
-          fileDownload.Write(&u1, sizeof(uploadsrec));
+          FileAreaReadRecord(fileDownload, i1 + 1, &u1);
+          FileAreaWriteRecord(fileDownload, i1, &u1);
         }
         --a()->numf;
-        FileAreaSetRecord(fileDownload, 0);
-        fileDownload.Read(&u1, sizeof(uploadsrec));
+        FileAreaReadRecord(fileDownload, 0, &u1);
         u1.numbytes = a()->numf;
-        FileAreaSetRecord(fileDownload, 0);
-        fileDownload.Write(&u1, sizeof(uploadsrec));
+        FileAreaWriteRecord(fileDownload, 0, &u1);
         fileDownload.Close();
         string ext_desc = read_extended_description(u.filename);
         if (!ext_desc.empty()) {
@@ -841,22 +835,17 @@ void move_file_t() {
         dliscan1(d1);
         fileDownload.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
         for (int i = a()->numf; i >= 1; i--) {
-          FileAreaSetRecord(fileDownload, i);
-          fileDownload.Read(&u1, sizeof(uploadsrec));
-          FileAreaSetRecord(fileDownload, i + 1);
-          fileDownload.Write(&u1, sizeof(uploadsrec));
+          FileAreaReadRecord(fileDownload, i, &u1);
+          FileAreaWriteRecord(fileDownload, i + 1, &u1);
         }
-        FileAreaSetRecord(fileDownload, 1);
-        fileDownload.Write(&u, sizeof(uploadsrec));
+        FileAreaWriteRecord(fileDownload, 1, &u);
         ++a()->numf;
-        FileAreaSetRecord(fileDownload, 0);
-        fileDownload.Read(&u1, sizeof(uploadsrec));
+        FileAreaReadRecord(fileDownload, 0, &u1);
         u1.numbytes = a()->numf;
         if (u.daten > u1.daten) {
           u1.daten = u.daten;
         }
-        FileAreaSetRecord(fileDownload, 0);
-        fileDownload.Write(&u1, sizeof(uploadsrec));
+        FileAreaWriteRecord(fileDownload, 0, &u1);
         fileDownload.Close();
         if (!ext_desc.empty()) {
           add_extended_description(u.filename, ext_desc);
@@ -917,8 +906,7 @@ void removefile() {
   while (!a()->hangup_ && (i > 0) && !abort) {
     File fileDownload(a()->download_filename_);
     fileDownload.Open(File::modeBinary | File::modeReadOnly);
-    FileAreaSetRecord(fileDownload, i);
-    fileDownload.Read(&u, sizeof(uploadsrec));
+    FileAreaReadRecord(fileDownload, i, &u);
     fileDownload.Close();
     if ((dcs()) || ((u.ownersys == 0) && (u.ownerusr == a()->usernum))) {
       bout.nl();
@@ -973,18 +961,14 @@ void removefile() {
           sysoplog() << StringPrintf("- \"%s\" removed off of %s", u.filename, a()->directories[a()->current_user_dir().subnum].name);
           fileDownload.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite);
           for (int i1 = i; i1 < a()->numf; i1++) {
-            FileAreaSetRecord(fileDownload, i1 + 1);
-            fileDownload.Read(&u, sizeof(uploadsrec));
-            FileAreaSetRecord(fileDownload, i1);
-            fileDownload.Write(&u, sizeof(uploadsrec));
+            FileAreaReadRecord(fileDownload, i1 + 1, &u);
+            FileAreaWriteRecord(fileDownload, i1, &u);
           }
           --i;
           --a()->numf;
-          FileAreaSetRecord(fileDownload, 0);
-          fileDownload.Read(&u, sizeof(uploadsrec));
+          FileAreaReadRecord(fileDownload, 0, &u);
           u.numbytes = a()->numf;
-          FileAreaSetRecord(fileDownload, 0);
-          fileDownload.Write(&u, sizeof(uploadsrec));
+          FileAreaWriteRecord(fileDownload, 0, &u);
           fileDownload.Close();
         }
       }
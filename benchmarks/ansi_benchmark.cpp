@@ -0,0 +1,69 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "benchmark/benchmark.h"
+
+#include <string>
+
+#include "benchmarks/benchmark_helper.h"
+#include "core/strings.h"
+#include "sdk/ansi/ansi.h"
+#include "sdk/ansi/framebuffer.h"
+
+using std::string;
+using namespace wwiv::sdk::ansi;
+using namespace wwiv::strings;
+
+/** Creates about num_screens 80x24 screens of ANSI art. */
+static string CreateAnsi(DataGenerator& gen, int num_screens) {
+  string s = "\x1b[0m\x1b[2J";
+  for (int screen = 0; screen < num_screens; screen++) {
+    for (int row = 1; row <= 24; row++) {
+      s.append(StrCat("\x1b[", row, ";1H"));
+      int col = 0;
+      while (col < 72) {
+        s.append(StrCat("\x1b[", gen.Next(0, 1), ";", 30 + gen.Next(0, 7), ";",
+                        40 + gen.Next(0, 7), "m"));
+        // Blocks and line drawing characters, mostly runs like real art.
+        const auto ch = static_cast<char>(gen.Next(0, 3) == 0 ? 0xdb : 0xb0 + gen.Next(0, 2));
+        const auto len = gen.Next(1, 8);
+        s.append(len, ch);
+        col += len;
+        if (gen.Next(0, 5) == 0) {
+          s.append(StrCat("\x1b[", gen.Next(1, 4), "C"));
+        }
+      }
+      s.append("\r\n");
+    }
+  }
+  s.append("\x1b[0m");
+  return s;
+}
+
+static void BM_AnsiFrameBuffer(benchmark::State& state) {
+  DataGenerator gen;
+  const auto ansi_text = CreateAnsi(gen, static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    FrameBuffer b(80);
+    Ansi ansi(&b, {}, 0x07);
+    ansi.write(ansi_text);
+    b.close();
+    benchmark::DoNotOptimize(b.rows());
+  }
+  state.SetBytesProcessed(state.iterations() * ansi_text.size());
+}
+BENCHMARK(BM_AnsiFrameBuffer)->Arg(1)->Arg(10)->Arg(100);
@@ -0,0 +1,181 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "benchmarks/benchmark_helper.h"
+
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+#include "core/datetime.h"
+#include "core/file.h"
+#include "core/strings.h"
+#include "core/version.h"
+#include "sdk/filenames.h"
+#include "sdk/vardec.h"
+
+using std::string;
+using namespace wwiv::core;
+using namespace wwiv::strings;
+
+namespace fs = std::filesystem;
+
+static const char* const WORDS[] = {
+    "the",     "wwiv",   "network", "message", "board",  "sysop",   "modem",  "baud",
+    "file",    "area",   "door",    "game",    "call",   "node",    "echo",   "zone",
+    "packet",  "mail",   "reply",   "thread",  "ansi",   "color",   "upload", "download",
+    "chat",    "user",   "config",  "system",  "route",  "connect", "binkp",  "fido",
+    "and",     "of",     "to",      "is",      "in",     "for",     "with",   "on",
+    "anyone",  "know",   "how",     "why",     "what",   "when",    "thanks", "cheers"};
+static constexpr int NUM_WORDS = sizeof(WORDS) / sizeof(WORDS[0]);
+
+static statusrec_t create_status() {
+  statusrec_t s{};
+  const string now(time_t_to_mmddyy(time_t_now()));
+  to_char_array(s.date1, now);
+  strcpy(s.date2, "00/00/00");
+  strcpy(s.date3, "00/00/00");
+  strcpy(s.log1, "000000.log");
+  strcpy(s.log2, "000000.log");
+  to_char_array(s.gfiledate, now);
+  s.callernum = 65535;
+  s.qscanptr = 2;
+  s.net_bias = 0.001f;
+  s.net_req_free = 3.0;
+  return s;
+}
+
+BenchmarkHelper::BenchmarkHelper() {
+  std::random_device rd;
+  for (int tries = 0; tries < 100; tries++) {
+    auto dir = fs::temp_directory_path() / StrCat("wwiv_benchmark_", rd());
+    if (fs::create_directory(dir)) {
+      root_ = dir.string();
+      break;
+    }
+  }
+  if (root_.empty()) {
+    throw std::runtime_error("failed to create temp directory");
+  }
+  data_ = CreatePath("data");
+  msgs_ = CreatePath("msgs");
+
+  {
+    configrec c{};
+    to_char_array(c.msgsdir, "msgs");
+    to_char_array(c.datadir, "data");
+    configrec_header_t h{};
+    h.config_size = sizeof(configrec);
+    h.written_by_wwiv_num_version = wwiv_num_version;
+    to_char_array(h.signature, "WWIV");
+    c.userreclen = sizeof(userrec);
+    c.header.header = h;
+
+    File cfile(FilePath(root_, CONFIG_DAT));
+    if (!cfile.Open(File::modeBinary | File::modeCreateFile | File::modeWriteOnly)) {
+      throw std::runtime_error("failed to create config.dat");
+    }
+    cfile.Write(&c, sizeof(configrec));
+  }
+
+  {
+    File sfile(FilePath(data_, STATUS_DAT));
+    if (!sfile.Open(File::modeBinary | File::modeCreateFile | File::modeWriteOnly)) {
+      throw std::runtime_error("failed to create status.dat");
+    }
+    statusrec_t s = create_status();
+    sfile.Write(&s, sizeof(statusrec_t));
+  }
+}
+
+BenchmarkHelper::~BenchmarkHelper() {
+  std::error_code ec;
+  fs::remove_all(root_, ec);
+}
+
+string BenchmarkHelper::CreatePath(const string& name) {
+  const auto path = FilePath(root_, name);
+  File::mkdirs(path);
+  return path;
+}
+
+string BenchmarkHelper::CreateTempFile(const string& name, const string& contents) {
+  const auto path = FilePath(root_, name);
+  File f(path);
+  if (!f.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite | File::modeTruncate)) {
+    throw std::runtime_error(StrCat("failed to create ", path));
+  }
+  f.Write(contents);
+  return path;
+}
+
+int DataGenerator::Next(int lo, int hi) {
+  std::uniform_int_distribution<int> dist(lo, hi);
+  return dist(rng_);
+}
+
+string DataGenerator::Word() { return WORDS[Next(0, NUM_WORDS - 1)]; }
+
+string DataGenerator::Sentence(int min_words, int max_words) {
+  string s = Word();
+  s[0] = static_cast<char>(toupper(s[0]));
+  const auto num = Next(min_words, max_words);
+  for (int i = 1; i < num; i++) {
+    s.push_back(' ');
+    s.append(Word());
+  }
+  return s;
+}
+
+string DataGenerator::MessageText(int size) {
+  string text;
+  text.reserve(size + 80);
+  while (static_cast<int>(text.size()) < size) {
+    auto line = Sentence(4, 12);
+    switch (Next(0, 9)) {
+    case 0:
+      // Quoted line from the previous message.
+      line = StrCat("RS> ", line);
+      break;
+    case 1:
+      // Some heart color codes like the bbs writes.
+      line = StrCat("\x03", Next(1, 9), line, "\x03", "0");
+      break;
+    case 2:
+      // Paragraph break.
+      text.append("\r\n");
+      break;
+    }
+    text.append(line).append(".\r\n");
+  }
+  return text;
+}
+
+string DataGenerator::Title() {
+  auto title = Sentence(2, 6);
+  if (Next(0, 2) == 0) {
+    title = StrCat("Re: ", title);
+  }
+  return title.substr(0, 60);
+}
+
+string DataGenerator::UserName() {
+  auto name = Word();
+  name[0] = static_cast<char>(toupper(name[0]));
+  return StrCat(name, " #", Next(1, 500));
+}
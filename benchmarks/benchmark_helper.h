@@ -0,0 +1,74 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef __INCLUDED_BENCHMARKS_BENCHMARK_HELPER_H__
+#define __INCLUDED_BENCHMARKS_BENCHMARK_HELPER_H__
+
+#include <cstdint>
+#include <random>
+#include <string>
+
+/**
+ * Creates a throw away BBS directory (config.dat, data/status.dat, msgs)
+ * under the system temp directory, and removes it again when destroyed.
+ *
+ * This is the benchmark equivalent of SdkHelper, without needing gtest.
+ */
+class BenchmarkHelper {
+public:
+  BenchmarkHelper();
+  ~BenchmarkHelper();
+
+  const std::string& root() const { return root_; }
+  const std::string& data() const { return data_; }
+  const std::string& msgs() const { return msgs_; }
+
+  /** Creates a file named name under root() containing contents. */
+  std::string CreateTempFile(const std::string& name, const std::string& contents);
+
+private:
+  std::string CreatePath(const std::string& name);
+
+  std::string root_;
+  std::string data_;
+  std::string msgs_;
+};
+
+/**
+ * Generates repeatable, message-like test data.  Every generator is seeded
+ * the same way so runs are comparable between builds.
+ */
+class DataGenerator {
+public:
+  explicit DataGenerator(uint32_t seed = 5381) : rng_(seed) {}
+
+  int Next(int lo, int hi);
+  std::string Word();
+  /** Returns a sentence of between min_words and max_words words. */
+  std::string Sentence(int min_words, int max_words);
+  /** Returns a message body of about size bytes, lines end in \r\n. */
+  std::string MessageText(int size);
+  /** Returns a subject line, 1 in 3 are replies ("Re: "). */
+  std::string Title();
+  /** Returns a user name like "Rushfan #1". */
+  std::string UserName();
+
+private:
+  std::mt19937 rng_;
+};
+
+#endif  // __INCLUDED_BENCHMARKS_BENCHMARK_HELPER_H__
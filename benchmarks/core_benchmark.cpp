@@ -0,0 +1,94 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "benchmark/benchmark.h"
+
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "benchmarks/benchmark_helper.h"
+#include "core/crc32.h"
+#include "core/graphs.h"
+#include "core/strings.h"
+
+using std::string;
+using std::vector;
+using namespace wwiv::core;
+using namespace wwiv::strings;
+
+static void BM_Crc32File(benchmark::State& state) {
+  BenchmarkHelper helper;
+  DataGenerator gen;
+  string contents;
+  while (contents.size() < static_cast<size_t>(state.range(0))) {
+    contents.append(gen.MessageText(4096));
+  }
+  contents.resize(state.range(0));
+  const auto path = helper.CreateTempFile("crc.dat", contents);
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(crc32file(path));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Crc32File)->RangeMultiplier(16)->Range(4 << 10, 16 << 20);
+
+static void BM_StripColors(benchmark::State& state) {
+  DataGenerator gen;
+  // A screen full of text with pipe, heart and ansi color codes.
+  string line;
+  for (int i = 0; i < 24; i++) {
+    line.append(StrCat("|#", i % 10, gen.Sentence(3, 6), " |", 10 + i % 6, gen.Word()));
+    line.append(StrCat(" \x1b[", 30 + i % 8, ";1m", gen.Sentence(2, 4), "\x1b[0m\r\n"));
+  }
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(stripcolors(line));
+  }
+  state.SetBytesProcessed(state.iterations() * line.size());
+}
+BENCHMARK(BM_StripColors);
+
+static void BM_GraphShortestPaths(benchmark::State& state) {
+  // A network of range(0) nodes each connected to a few others, routed
+  // from node 1 to every node like network3 does for bbslist.net.
+  DataGenerator gen;
+  const auto num_nodes = static_cast<int>(state.range(0));
+  struct link { uint16_t a; uint16_t b; float cost; };
+  vector<link> links;
+  for (int n = 2; n <= num_nodes; n++) {
+    for (int i = 0; i < 3; i++) {
+      links.push_back({static_cast<uint16_t>(n), static_cast<uint16_t>(gen.Next(1, n - 1)),
+                       static_cast<float>(gen.Next(0, 20)) / 10.0f});
+    }
+  }
+
+  for (auto _ : state) {
+    wwiv::graphs::Graph graph(1, std::numeric_limits<uint16_t>::max());
+    for (const auto& l : links) {
+      graph.add_edge(l.a, l.b, l.cost);
+      graph.add_edge(l.b, l.a, l.cost);
+    }
+    for (int n = 1; n <= num_nodes; n++) {
+      benchmark::DoNotOptimize(graph.shortest_path_to(static_cast<uint16_t>(n)));
+      benchmark::DoNotOptimize(graph.cost_to(static_cast<uint16_t>(n)));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * num_nodes);
+}
+BENCHMARK(BM_GraphShortestPaths)->RangeMultiplier(8)->Range(64, 4096);
@@ -0,0 +1,407 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "benchmark/benchmark.h"
+
+#include <string>
+#include <vector>
+
+#include "benchmarks/benchmark_helper.h"
+#include "core/file.h"
+#include "core/stl.h"
+#include "core/strings.h"
+#include "sdk/filenames.h"
+#include "sdk/ftn_msgdupe.h"
+#include "sdk/fido/fido_address.h"
+#include "sdk/fido/fido_packets.h"
+#include "sdk/fido/nodelist.h"
+#include "sdk/fido/nodelist_index.h"
+
+using std::string;
+using std::vector;
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+using namespace wwiv::sdk::fido;
+using namespace wwiv::sdk::net;
+using namespace wwiv::strings;
+
+static string NodelistLine(DataGenerator& gen, const string& keyword, int number) {
+  return StrCat(keyword, ",", number, ",", gen.Word(), "_", gen.Word(), "_BBS,", gen.Word(),
+                "_CA,Sysop_", gen.Word(), ",-Unpublished-,300,CM,XX,INA:bbs", number, ".",
+                gen.Word(), ".org,IBN\r\n");
+}
+
+/**
+ * Creates a nodelist of about num_nodes nodes spread over a few zones,
+ * with regions, hosts and hubs like the FidoNet nodelist.
+ */
+static string CreateNodelist(DataGenerator& gen, int num_nodes) {
+  string text = ";A FidoNet Nodelist for Friday, January 1, 2017 -- Day number 001 : 12345\r\n";
+  for (int zone = 1; zone <= 4; zone++) {
+    text.append(NodelistLine(gen, "Zone", zone));
+    for (int region = 1; region <= 9; region++) {
+      text.append(NodelistLine(gen, "Region", zone * 10 + region));
+      for (int host = 0; host < 10; host++) {
+        text.append(";\r\n");
+        text.append(NodelistLine(gen, "Host", zone * 100 + region * 10 + host));
+        const auto per_net = gen.Next(1, num_nodes / 180 + 1);
+        for (int node = 1; node <= per_net; node++) {
+          text.append(NodelistLine(gen, node % 50 == 1 ? "Hub" : "", node));
+        }
+      }
+    }
+  }
+  return text;
+}
+
+static void BM_NodelistLoad(benchmark::State& state) {
+  BenchmarkHelper helper;
+  DataGenerator gen;
+  const auto path = helper.CreateTempFile("nodelist.001", CreateNodelist(gen, state.range(0)));
+  const auto index_path = NodelistIndex::index_filename(path);
+  for (auto _ : state) {
+    // Parse the text each time, this includes writing the index.
+    state.PauseTiming();
+    File::Remove(index_path);
+    state.ResumeTiming();
+    Nodelist n(path);
+    if (!n) {
+      state.SkipWithError("Unable to load nodelist");
+      break;
+    }
+    benchmark::DoNotOptimize(n);
+  }
+  state.SetBytesProcessed(state.iterations() * File(path).length());
+}
+BENCHMARK(BM_NodelistLoad)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+static void BM_NodelistLoadIndex(benchmark::State& state) {
+  BenchmarkHelper helper;
+  DataGenerator gen;
+  const auto path = helper.CreateTempFile("nodelist.001", CreateNodelist(gen, state.range(0)));
+  // Compiles the index.
+  if (!Nodelist(path)) {
+    state.SkipWithError("Unable to load nodelist");
+  }
+  for (auto _ : state) {
+    Nodelist n(path);
+    if (!n) {
+      state.SkipWithError("Unable to load nodelist");
+      break;
+    }
+    benchmark::DoNotOptimize(n);
+  }
+  state.SetBytesProcessed(state.iterations() * File(path).length());
+}
+BENCHMARK(BM_NodelistLoadIndex)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+
+// The SplitString based nodelist line parser, kept to compare against
+// NodelistEntry::ParseDataLine.
+static NodelistKeyword legacy_to_keyword(const std::string& k) {
+  if (k.empty()) {
+    return NodelistKeyword::node;
+  }
+
+  if (k == "Down") return NodelistKeyword::down;
+  if (k == "Host") return NodelistKeyword::host;
+  if (k == "Hub") return NodelistKeyword::hub;
+  if (k == "Pvt") return NodelistKeyword::pvt;
+  if (k == "Region") return NodelistKeyword::region;
+  if (k == "Zone") return NodelistKeyword::zone;
+
+  return NodelistKeyword::node;
+}
+
+static inline bool bool_flag(const std::string& value, const std::string& flag_name, bool& f) {
+  if (value == flag_name) {
+    f = true;
+    return true;
+  }
+  return false;
+}
+
+static bool internet_flag(const std::string& value, const std::string& flag_name, bool& f, string& host, uint16_t& port) {
+  if (!wwiv::stl::contains(value, ':')) return false;
+  vector<string> parts = SplitString(value, ":");
+  if (parts.size() > 3) return false;
+
+  if (parts.front() == flag_name) {
+    f = true;
+    if (parts.size() > 1) {
+      port = to_number<uint16_t>(parts.back());
+    }
+    if (parts.size() == 3) {
+      // flag:host:port
+      host = parts.at(1);
+    }
+    return true;
+  }
+  return false;
+}
+
+static bool bool_flag(const std::string& value, const std::string& flag_name, bool& f, string& fs) {
+  if (!wwiv::stl::contains(value, ':')) return false;
+  vector<string> parts = SplitString(value, ":");
+  if (parts.size() > 2) return false;
+
+  if (parts.front() == flag_name) {
+    f = true;
+    if (parts.size() > 1) {
+      fs = parts.back();
+//      StringTrim(&fs);
+    }
+    return true;
+  }
+  return false;
+}
+
+static string LegacyToSpaces(const std::string& orig) {
+  string s(orig);
+  std::replace(std::begin(s), std::end(s), '_', ' ');
+  return s;
+}
+
+static bool LegacyParseDataLine(const std::string& data_line, NodelistEntry& e) {
+  if (data_line.front() == ';') {
+    return false;
+  }
+
+  vector<string> parts = SplitString(data_line, ",");
+  if (parts.size() < 6) {
+    return false;
+  }
+
+  auto it = parts.cbegin();
+  if (data_line.front() == ',') {
+    // We have no 1st field, default the keyword and skip the iterator.
+    e.keyword_ = NodelistKeyword::node;
+  } else {
+    e.keyword_ = legacy_to_keyword(*it++);
+  }
+  e.number_ = to_number<uint16_t>(*it++);
+  e.name_ = LegacyToSpaces(*it++);
+  e.location_ = LegacyToSpaces(*it++);
+  e.sysop_name_ = LegacyToSpaces(*it++);
+  e.phone_number_ = *it++;
+  if (it != parts.end()) {
+    e.baud_rate_ = to_number<unsigned int>(*it++);
+  }
+
+  while (it != parts.end()) {
+    const auto& f = *it++;
+    if (bool_flag(f, "CM", e.cm_)) continue;
+    if (bool_flag(f, "ICM", e.icm_)) continue;
+    if (bool_flag(f, "MO", e.mo_)) continue;
+    if (bool_flag(f, "LO", e.lo_)) continue;
+    if (bool_flag(f, "MN", e.mn_)) continue;
+
+    bool ignore;
+    if (bool_flag(f, "INA", ignore, e.hostname_)) continue;
+    if (internet_flag(f, "IBN", e.binkp_, e.binkp_hostname_, e.binkp_port_)) continue;
+    if (internet_flag(f, "ITN", e.telnet_, e.telnet_hostname_, e.telnet_port_)) continue;
+    if (internet_flag(f, "IVN", e.vmodem_, e.vmodem_hostname_, e.vmodem_port_)) continue;
+
+    // TODO(rushfan): Handle X? flags.
+  }
+  if (e.binkp_) {
+    if (e.binkp_port_ == 0) e.binkp_port_ = 24554;
+    if (e.binkp_hostname_.empty()) e.binkp_hostname_ = e.hostname_;
+  }
+  if (e.telnet_) {
+    if (e.telnet_port_ == 0) e.telnet_port_ = 24554;
+    if (e.telnet_hostname_.empty()) e.telnet_hostname_ = e.hostname_;
+  }
+  if (e.vmodem_) {
+    if (e.vmodem_port_ == 0) e.vmodem_port_ = 24554;
+    if (e.vmodem_hostname_.empty()) e.vmodem_hostname_ = e.hostname_;
+  }
+
+  return true;
+}
+
+// About the size of the FidoNet world nodelist.
+static constexpr int kRealSizeNodelist = 30000;
+
+static void BM_NodelistParseDataLine_Legacy(benchmark::State& state) {
+  DataGenerator gen;
+  const auto lines = SplitString(CreateNodelist(gen, kRealSizeNodelist), "\r\n");
+  for (auto _ : state) {
+    for (const auto& line : lines) {
+      NodelistEntry e{};
+      benchmark::DoNotOptimize(LegacyParseDataLine(line, e));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * lines.size());
+}
+BENCHMARK(BM_NodelistParseDataLine_Legacy)->Unit(benchmark::kMillisecond);
+
+static void BM_NodelistParseDataLine(benchmark::State& state) {
+  DataGenerator gen;
+  const auto lines = SplitString(CreateNodelist(gen, kRealSizeNodelist), "\r\n");
+  for (auto _ : state) {
+    for (const auto& line : lines) {
+      NodelistEntry e{};
+      benchmark::DoNotOptimize(NodelistEntry::ParseDataLine(line, e));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * lines.size());
+}
+BENCHMARK(BM_NodelistParseDataLine)->Unit(benchmark::kMillisecond);
+
+static void BM_NodelistParseText(benchmark::State& state) {
+  DataGenerator gen;
+  const auto text = CreateNodelist(gen, kRealSizeNodelist);
+  const auto threads = static_cast<int>(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(Nodelist::ParseText(text, threads));
+  }
+  state.SetBytesProcessed(state.iterations() * text.size());
+}
+BENCHMARK(BM_NodelistParseText)->Arg(1)->Arg(2)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_NodelistContains(benchmark::State& state) {
+  BenchmarkHelper helper;
+  DataGenerator gen;
+  const auto path = helper.CreateTempFile("nodelist.001", CreateNodelist(gen, 10000));
+  Nodelist n(path);
+  vector<FidoAddress> addresses;
+  for (const auto& e : n.entries()) {
+    addresses.push_back(e.address_);
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(n.contains(addresses[i++ % addresses.size()]));
+  }
+}
+BENCHMARK(BM_NodelistContains);
+
+// Creates a .PKT file of about size bytes of echomail.
+static string CreateFidoPacket(DataGenerator& gen, int size) {
+  packet_header_2p_t header{};
+  string s(reinterpret_cast<const char*>(&header), sizeof(packet_header_2p_t));
+  while (static_cast<int>(s.size()) < size) {
+    fido_packed_message_t nh{};
+    nh.message_type = 2;
+    s.append(reinterpret_cast<const char*>(&nh), sizeof(fido_packed_message_t));
+    s.append("01 Jan 17  12:00:00");
+    s.push_back('\0');
+    for (const auto& f : {string("All"), gen.UserName(), gen.Title(),
+                          StrCat("AREA:GENERAL\r", gen.MessageText(gen.Next(500, 4000)))}) {
+      s.append(f);
+      s.push_back('\0');
+    }
+  }
+  s.append(2, '\0');
+  return s;
+}
+
+static void BM_FidoPacketRead_File(benchmark::State& state) {
+  BenchmarkHelper helper;
+  DataGenerator gen;
+  const auto path = helper.CreateTempFile("test.pkt", CreateFidoPacket(gen, 5 * 1024 * 1024));
+  for (auto _ : state) {
+    File f(path);
+    f.Open(File::modeBinary | File::modeReadOnly);
+    packet_header_2p_t header{};
+    f.Read(&header, sizeof(packet_header_2p_t));
+    FidoPackedMessage msg;
+    while (read_packed_message(f, msg) == ReadPacketResponse::OK) {
+      benchmark::DoNotOptimize(msg);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * File(path).length());
+}
+BENCHMARK(BM_FidoPacketRead_File)->Unit(benchmark::kMillisecond);
+
+static void BM_FidoPacketRead_Reader(benchmark::State& state) {
+  BenchmarkHelper helper;
+  DataGenerator gen;
+  const auto path = helper.CreateTempFile("test.pkt", CreateFidoPacket(gen, 5 * 1024 * 1024));
+  for (auto _ : state) {
+    FidoPacketReader reader(path);
+    reader.Open();
+    packet_header_2p_t header{};
+    reader.ReadHeader(header);
+    FidoPackedMessage msg;
+    while (reader.Next(msg) == ReadPacketResponse::OK) {
+      benchmark::DoNotOptimize(msg);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * File(path).length());
+}
+BENCHMARK(BM_FidoPacketRead_Reader)->Unit(benchmark::kMillisecond);
+
+// Creates a legacy msgdupe.dat in datadir with num records.
+static void CreateMsgDupe(DataGenerator& gen, const string& datadir, int num) {
+  vector<msgids> ids;
+  for (int i = 0; i < num; i++) {
+    msgids id{};
+    id.header = static_cast<uint32_t>(gen.Next(0, 0x7fffffff));
+    id.msgid = static_cast<uint32_t>(gen.Next(0, 0x7fffffff));
+    ids.push_back(id);
+  }
+  File f(FilePath(datadir, MSGDUPE_DAT));
+  f.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite | File::modeTruncate);
+  f.Write(&ids[0], ids.size() * sizeof(msgids));
+}
+
+static void BM_FtnMessageDupeLoad(benchmark::State& state) {
+  BenchmarkHelper helper;
+  DataGenerator gen;
+  CreateMsgDupe(gen, helper.data(), static_cast<int>(state.range(0)));
+  {
+    // Imports msgdupe.dat into msgdupe.idx.
+    FtnMessageDupe dupe(helper.data(), true);
+  }
+  for (auto _ : state) {
+    FtnMessageDupe dupe(helper.data(), true);
+    if (!dupe.IsInitialized()) {
+      state.SkipWithError("Unable to load msgdupe.idx");
+      break;
+    }
+    benchmark::DoNotOptimize(dupe);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FtnMessageDupeLoad)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+
+static void BM_FtnMessageDupeIsDupe(benchmark::State& state) {
+  BenchmarkHelper helper;
+  DataGenerator gen;
+  CreateMsgDupe(gen, helper.data(), static_cast<int>(state.range(0)));
+  FtnMessageDupe dupe(helper.data(), true);
+  for (auto _ : state) {
+    const auto h = static_cast<uint32_t>(gen.Next(0, 0x7fffffff));
+    const auto m = static_cast<uint32_t>(gen.Next(0, 0x7fffffff));
+    benchmark::DoNotOptimize(dupe.is_dupe(h, m));
+  }
+}
+BENCHMARK(BM_FtnMessageDupeIsDupe)->RangeMultiplier(10)->Range(1000, 100000);
+
+static void BM_FtnMessageDupeAdd(benchmark::State& state) {
+  BenchmarkHelper helper;
+  DataGenerator gen;
+  CreateMsgDupe(gen, helper.data(), static_cast<int>(state.range(0)));
+  // Full, so that every add also evicts.
+  FtnMessageDupe dupe(helper.data(), true, static_cast<uint32_t>(state.range(0)));
+  for (auto _ : state) {
+    const auto h = static_cast<uint32_t>(gen.Next(0, 0x7fffffff));
+    const auto m = static_cast<uint32_t>(gen.Next(0, 0x7fffffff));
+    benchmark::DoNotOptimize(dupe.add(h, m));
+  }
+}
+BENCHMARK(BM_FtnMessageDupeAdd)->RangeMultiplier(10)->Range(1000, 100000);
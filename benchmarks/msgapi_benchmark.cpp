@@ -0,0 +1,266 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "benchmark/benchmark.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "benchmarks/benchmark_helper.h"
+#include "core/file.h"
+#include "core/strings.h"
+#include "sdk/config.h"
+#include "sdk/msgapi/message_api_wwiv.h"
+#include "sdk/msgapi/msgapi.h"
+#include "sdk/msgapi/type2_text.h"
+
+using std::string;
+using std::unique_ptr;
+using std::vector;
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+using namespace wwiv::sdk::msgapi;
+using namespace wwiv::strings;
+
+// Number of texts saved to one message file before it is recreated, this
+// keeps the file well under the 1024 GAT sections type 2 storage allows.
+static constexpr int TEXTS_PER_FILE = 10000;
+// Posts are added to the synthetic subs this many at a time.
+static constexpr int POPULATE_BATCH_SIZE = 500;
+static constexpr int AVERAGE_TEXT_SIZE = 1200;
+
+static void BM_Type2Text_Save(benchmark::State& state) {
+  BenchmarkHelper helper;
+  DataGenerator gen;
+  vector<string> texts;
+  for (int i = 0; i < 100; i++) {
+    texts.push_back(gen.MessageText(static_cast<int>(state.range(0))));
+  }
+  const auto path = helper.CreateTempFile("test.dat", "");
+  Type2Text t(path);
+  int num_saved = 0;
+  for (auto _ : state) {
+    messagerec m{2, 0};
+    if (!t.savefile(texts[num_saved % texts.size()], &m)) {
+      state.SkipWithError("savefile failed");
+      break;
+    }
+    if (++num_saved % TEXTS_PER_FILE == 0) {
+      state.PauseTiming();
+      helper.CreateTempFile("test.dat", "");
+      state.ResumeTiming();
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Type2Text_Save)->Arg(256)->Arg(AVERAGE_TEXT_SIZE)->Arg(16 << 10);
+
+static void BM_Type2Text_SaveMany(benchmark::State& state) {
+  BenchmarkHelper helper;
+  DataGenerator gen;
+  vector<string> texts;
+  for (int i = 0; i < state.range(0); i++) {
+    texts.push_back(gen.MessageText(gen.Next(AVERAGE_TEXT_SIZE / 2, AVERAGE_TEXT_SIZE * 3 / 2)));
+  }
+  const auto path = helper.CreateTempFile("test.dat", "");
+  Type2Text t(path);
+  int num_saved = 0;
+  for (auto _ : state) {
+    vector<messagerec> msgs;
+    if (!t.savefiles(texts, msgs)) {
+      state.SkipWithError("savefiles failed");
+      break;
+    }
+    num_saved += static_cast<int>(texts.size());
+    if (num_saved >= TEXTS_PER_FILE) {
+      state.PauseTiming();
+      helper.CreateTempFile("test.dat", "");
+      num_saved = 0;
+      state.ResumeTiming();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_Type2Text_SaveMany)->Arg(10)->Arg(100)->Arg(1000);
+
+static void BM_Type2Text_Read(benchmark::State& state) {
+  BenchmarkHelper helper;
+  DataGenerator gen;
+  vector<string> texts;
+  for (int i = 0; i < 1000; i++) {
+    texts.push_back(gen.MessageText(static_cast<int>(state.range(0))));
+  }
+  const auto path = helper.CreateTempFile("test.dat", "");
+  Type2Text t(path);
+  vector<messagerec> msgs;
+  if (!t.savefiles(texts, msgs)) {
+    state.SkipWithError("savefiles failed");
+    return;
+  }
+  size_t i = 0;
+  for (auto _ : state) {
+    string out;
+    if (!t.readfile(&msgs[i++ % msgs.size()], &out)) {
+      state.SkipWithError("readfile failed");
+      break;
+    }
+    benchmark::DoNotOptimize(out);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_Type2Text_Read)->Arg(256)->Arg(AVERAGE_TEXT_SIZE)->Arg(16 << 10);
+
+/**
+ * A WWIV message sub with range(0) synthetic posts.
+ *
+ * Note that WWIV subs hold at most 65535 posts, the post count is 16 bits.
+ */
+class MessageAreaBenchmark : public benchmark::Fixture {
+public:
+  void SetUp(const benchmark::State& state) override {
+    helper_ = std::make_unique<BenchmarkHelper>();
+    config_ = std::make_unique<Config>(helper_->root());
+    MessageApiOptions options;
+    options.overflow_strategy = OverflowStrategy::delete_one;
+    api_ = std::make_unique<WWIVMessageApi>(options, *config_, vector<net_networks_rec>{},
+                                            new NullLastReadImpl());
+    sub_.filename = "bench";
+    api_->Create(sub_, -1);
+    area_.reset(api_->Open(sub_, -1));
+    num_posts_ = static_cast<int>(state.range(0));
+    area_->set_max_messages(num_posts_);
+    Populate(num_posts_);
+  }
+
+  void TearDown(const benchmark::State&) override {
+    area_.reset();
+    api_.reset();
+    config_.reset();
+    helper_.reset();
+  }
+
+  unique_ptr<Message> CreateMessage() {
+    auto msg = area_->CreateMessage();
+    auto& h = msg->header();
+    h.set_from_system(static_cast<uint16_t>(gen_.Next(1, 20000)));
+    h.set_from_usernum(static_cast<uint16_t>(gen_.Next(1, 500)));
+    h.set_title(gen_.Title());
+    h.set_from(gen_.UserName());
+    h.set_to("All");
+    h.set_daten(daten_++);
+    msg->text().set_text(
+        gen_.MessageText(gen_.Next(AVERAGE_TEXT_SIZE / 2, AVERAGE_TEXT_SIZE * 3 / 2)));
+    return msg;
+  }
+
+  bool Populate(int num) {
+    while (num > 0) {
+      const auto batch = std::min(num, POPULATE_BATCH_SIZE);
+      vector<unique_ptr<Message>> owned;
+      vector<const Message*> msgs;
+      for (int i = 0; i < batch; i++) {
+        owned.emplace_back(CreateMessage());
+        msgs.push_back(owned.back().get());
+      }
+      if (!area_->AddMessages(msgs, {})) {
+        return false;
+      }
+      num -= batch;
+    }
+    return true;
+  }
+
+  int random_message() { return gen_.Next(1, area_->number_of_messages()); }
+
+  unique_ptr<BenchmarkHelper> helper_;
+  unique_ptr<Config> config_;
+  unique_ptr<MessageApi> api_;
+  unique_ptr<MessageArea> area_;
+  subboard_t sub_{};
+  DataGenerator gen_;
+  int num_posts_{0};
+  daten_t daten_{915192000};
+};
+
+// Adds to a full sub, so each add also deletes the oldest post.
+BENCHMARK_DEFINE_F(MessageAreaBenchmark, AddMessage)(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto msg = CreateMessage();
+    state.ResumeTiming();
+    if (!area_->AddMessage(*msg, {})) {
+      state.SkipWithError("AddMessage failed");
+      break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_DEFINE_F(MessageAreaBenchmark, ReadMessage)(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(area_->ReadMessage(random_message()));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_DEFINE_F(MessageAreaBenchmark, ReadMessageHeader)(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(area_->ReadMessageHeader(random_message()));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+BENCHMARK_DEFINE_F(MessageAreaBenchmark, Exists)(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto h = area_->ReadMessageHeader(random_message());
+    state.ResumeTiming();
+    if (!area_->Exists(h->daten(), h->title(), h->from_system(), h->from_usernum())) {
+      state.SkipWithError("Exists returned false for an existing post");
+      break;
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Deletes random posts, which periodically compacts the sub. The sub is
+// refilled once half of the posts are gone.
+BENCHMARK_DEFINE_F(MessageAreaBenchmark, DeleteMessage)(benchmark::State& state) {
+  for (auto _ : state) {
+    if (!area_->DeleteMessage(random_message())) {
+      state.SkipWithError("DeleteMessage failed");
+      break;
+    }
+    if (area_->number_of_messages() < num_posts_ / 2) {
+      state.PauseTiming();
+      Populate(num_posts_ - area_->number_of_messages());
+      state.ResumeTiming();
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+static void SubSizes(benchmark::internal::Benchmark* b) {
+  b->RangeMultiplier(8)->Range(1 << 10, 1 << 15)->Unit(benchmark::kMicrosecond);
+}
+
+BENCHMARK_REGISTER_F(MessageAreaBenchmark, AddMessage)->Apply(SubSizes);
+BENCHMARK_REGISTER_F(MessageAreaBenchmark, ReadMessage)->Apply(SubSizes);
+BENCHMARK_REGISTER_F(MessageAreaBenchmark, ReadMessageHeader)->Apply(SubSizes);
+BENCHMARK_REGISTER_F(MessageAreaBenchmark, Exists)->Apply(SubSizes);
+BENCHMARK_REGISTER_F(MessageAreaBenchmark, DeleteMessage)->Apply(SubSizes);
@@ -0,0 +1,149 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "benchmark/benchmark.h"
+
+#include <string>
+#include <vector>
+
+#include "benchmarks/benchmark_helper.h"
+#include "core/datetime.h"
+#include "core/file.h"
+#include "core/strings.h"
+#include "sdk/net/packets.h"
+
+using std::string;
+using std::vector;
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+using namespace wwiv::sdk::net;
+using namespace wwiv::strings;
+
+// Packets written to one file before it is truncated.
+static constexpr int PACKETS_PER_FILE = 10000;
+
+static Packet CreatePost(DataGenerator& gen) {
+  // Same layout as a network post: subtype, title, sender, date then text.
+  string text = "GENCHAT";
+  text.push_back(0);
+  text.append(gen.Title());
+  text.push_back(0);
+  text.append(gen.UserName()).append(" #1 @1\r\n");
+  text.append("Thu Jan 01 00:00:00 1998\r\n");
+  text.append(gen.MessageText(gen.Next(600, 1800)));
+
+  net_header_rec nh{};
+  nh.tosys = static_cast<uint16_t>(gen.Next(1, 20000));
+  nh.fromsys = 1;
+  nh.fromuser = 1;
+  nh.main_type = main_type_new_post;
+  nh.daten = daten_t_now();
+  nh.length = static_cast<uint32_t>(text.size());
+  return Packet(nh, {}, text);
+}
+
+static void BM_WriteWWIVNetPacket(benchmark::State& state) {
+  BenchmarkHelper helper;
+  DataGenerator gen;
+  net_networks_rec net{};
+  net.dir = helper.root();
+  vector<Packet> packets;
+  for (int i = 0; i < 100; i++) {
+    packets.push_back(CreatePost(gen));
+  }
+  size_t bytes = 0;
+  int num = 0;
+  for (auto _ : state) {
+    const auto& p = packets[num % packets.size()];
+    if (!write_wwivnet_packet("p1.net", net, p)) {
+      state.SkipWithError("write_wwivnet_packet failed");
+      break;
+    }
+    bytes += sizeof(net_header_rec) + p.nh.length;
+    if (++num % PACKETS_PER_FILE == 0) {
+      state.PauseTiming();
+      helper.CreateTempFile("p1.net", "");
+      state.ResumeTiming();
+    }
+  }
+  state.SetBytesProcessed(bytes);
+  state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_WriteWWIVNetPacket);
+
+// Reads a whole packet file of range(0) posts.
+static void BM_ReadPacket(benchmark::State& state) {
+  BenchmarkHelper helper;
+  DataGenerator gen;
+  net_networks_rec net{};
+  net.dir = helper.root();
+  for (int i = 0; i < state.range(0); i++) {
+    if (!write_wwivnet_packet("p1.net", net, CreatePost(gen))) {
+      state.SkipWithError("write_wwivnet_packet failed");
+      return;
+    }
+  }
+  const auto path = FilePath(helper.root(), "p1.net");
+  const auto file_size = File(path).length();
+  for (auto _ : state) {
+    File f(path);
+    if (!f.Open(File::modeBinary | File::modeReadOnly)) {
+      state.SkipWithError("unable to open packet");
+      break;
+    }
+    for (;;) {
+      Packet p;
+      if (read_packet(f, p, true) != ReadPacketResponse::OK) {
+        break;
+      }
+      benchmark::DoNotOptimize(p);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * file_size);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_ReadPacket)->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMicrosecond);
+
+// Reads the same packet file as BM_ReadPacket using PacketStream.
+static void BM_PacketStream(benchmark::State& state) {
+  BenchmarkHelper helper;
+  DataGenerator gen;
+  net_networks_rec net{};
+  net.dir = helper.root();
+  for (int i = 0; i < state.range(0); i++) {
+    if (!write_wwivnet_packet("p1.net", net, CreatePost(gen))) {
+      state.SkipWithError("write_wwivnet_packet failed");
+      return;
+    }
+  }
+  const auto path = FilePath(helper.root(), "p1.net");
+  const auto file_size = File(path).length();
+  for (auto _ : state) {
+    PacketStream stream(path, true);
+    if (!stream.Open()) {
+      state.SkipWithError("unable to open packet");
+      break;
+    }
+    PacketView v;
+    while (stream.Next(v) == ReadPacketResponse::OK) {
+      benchmark::DoNotOptimize(v);
+    }
+  }
+  state.SetBytesProcessed(state.iterations() * file_size);
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_PacketStream)->RangeMultiplier(10)->Range(10, 10000)->Unit(benchmark::kMicrosecond);
@@ -62,11 +62,34 @@ public:
     }
     return file_.Read(record, num_records*SIZE) == static_cast<int>(num_records*SIZE); 
   }
+  /**
+   * Reads record_number with a single positional read, this does not move
+   * the current position used by Read(RECORD*).
+   */
   bool Read(int record_number, RECORD* record) {
-    if (!Seek(record_number)) {
-      return false;
+    return file_.ReadAt(record_number * SIZE, record, SIZE) == static_cast<ssize_t>(SIZE);
+  }
+
+  /** Reads num_records records starting at first_record into records. */
+  bool ReadRange(int first_record, int num_records, RECORD* records) {
+    if (num_records == 0) {
+      // Reading nothing is always successful.
+      return true;
+    }
+    const auto size = num_records * SIZE;
+    return file_.ReadAt(first_record * SIZE, records, size) == static_cast<ssize_t>(size);
+  }
+
+  /**
+   * Reads num_records records starting at first_record, resizing records
+   * to hold them.
+   */
+  bool ReadRange(int first_record, int num_records, std::vector<RECORD>& records) {
+    records.resize(num_records);
+    if (num_records == 0) {
+      return true;
     }
-    return Read(record);
+    return ReadRange(first_record, num_records, &records[0]);
   }
 
   bool WriteVector(const std::vector<RECORD>& records, std::size_t max_records = 0) {
@@ -80,11 +103,18 @@ public:
   bool Write(const RECORD* record, int num_records = 1) { 
     return file_.Write(record, num_records*SIZE) == static_cast<int>(num_records*SIZE);
   }
+  /** Writes record_number with a single positional write, see Read(int, RECORD*). */
   bool Write(int record_number, const RECORD* record) {
-    if (!Seek(record_number)) {
-      return false;
+    return file_.WriteAt(record_number * SIZE, record, SIZE) == static_cast<ssize_t>(SIZE);
+  }
+
+  /** Writes num_records records starting at first_record from records. */
+  bool WriteRange(int first_record, int num_records, const RECORD* records) {
+    if (num_records == 0) {
+      return true;
     }
-    return Write(record);
+    const auto size = num_records * SIZE;
+    return file_.WriteAt(first_record * SIZE, records, size) == static_cast<ssize_t>(size);
   }
   bool Seek(int record_number) { return file_.Seek(record_number * SIZE, File::Whence::begin) == static_cast<long>(record_number * SIZE); }
   std::size_t number_of_records() { return file_.length() / SIZE; }
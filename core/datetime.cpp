@@ -179,8 +179,12 @@ struct tm DateTime::to_tm() const noexcept {
 }
 
 void DateTime::update_tm() noexcept {
-  auto tm = localtime(&t_);
-  tm_ = *tm;
+  // Use the reentrant versions since DateTime is used from many threads.
+#ifdef _WIN32
+  localtime_s(&tm_, &t_);
+#else
+  localtime_r(&t_, &tm_);
+#endif  // _WIN32
 }
 
 
@@ -26,6 +26,7 @@
 #include <memory>
 #include <string>
 #include <sys/types.h>
+#include <vector>
 
 #include "core/file_lock.h"
 #include "core/wwivport.h"
@@ -107,6 +108,32 @@ public:
   ssize_t Read(void* buf, size_t count);
   ssize_t Write(const void* buf, size_t count);
 
+  /**
+   * Reads count bytes starting at offset in a single call. The current
+   * position is neither used nor moved, so many threads may use ReadAt and
+   * WriteAt on the same File. On Windows the position is saved and restored
+   * around the call, when several threads call ReadAt or WriteAt at once
+   * the position afterwards is undefined there.
+   */
+  ssize_t ReadAt(off_t offset, void* buf, size_t count);
+  /** Writes count bytes starting at offset in a single call, see ReadAt. */
+  ssize_t WriteAt(off_t offset, const void* buf, size_t count);
+
+  /** Destination for part of a ReadAt into many buffers (like struct iovec). */
+  struct Buffer {
+    void* data;
+    size_t size;
+  };
+  /**
+   * Reads the bytes starting at offset into each of buffers in turn, filling
+   * each one before moving onto the next. Returns the total number of bytes
+   * read.
+   */
+  ssize_t ReadAt(off_t offset, const std::vector<Buffer>& buffers);
+
+  /** Flushes everything written to this file to disk (fsync). */
+  bool Sync();
+
   ssize_t Write(const std::string& s) { return this->Write(s.data(), s.length()); }
 
   ssize_t Writeln(const void* buffer, size_t nCount) {
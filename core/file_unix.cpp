@@ -29,6 +29,7 @@
 #include <string>
 #include <sys/stat.h>
 #include <sys/file.h>
+#include <sys/uio.h>
 #include <unistd.h>
 #include <sys/param.h>
 #include <sys/mount.h>
@@ -39,6 +40,7 @@
 #include <sys/statvfs.h>
 #endif  // __linux__
 
+#include "core/log.h"
 #include "core/wwivassert.h"
 
 using std::string;
@@ -63,6 +65,65 @@ const char File::pathSeparatorString[] = "/";
 const char File::separatorChar     = ':';
 
 
+/////////////////////////////////////////////////////////////////////////////
+// Member functions
+
+ssize_t File::ReadAt(off_t offset, void* buffer, size_t size) {
+  ssize_t ret = pread(handle_, buffer, size, offset);
+  if (ret == -1) {
+    LOG(ERROR) << "ReadAt errno: " << errno << " filename: " << full_path_name_
+               << " offset: " << offset << " size: " << size;
+  }
+  return ret;
+}
+
+ssize_t File::WriteAt(off_t offset, const void* buffer, size_t size) {
+  ssize_t ret = pwrite(handle_, buffer, size, offset);
+  if (ret == -1) {
+    LOG(ERROR) << "WriteAt errno: " << errno << " filename: " << full_path_name_
+               << " offset: " << offset << " size: " << size;
+  }
+  return ret;
+}
+
+ssize_t File::ReadAt(off_t offset, const std::vector<Buffer>& buffers) {
+#if defined(__APPLE__)
+  // preadv isn't available on older versions of macOS.
+  ssize_t total = 0;
+  for (const auto& b : buffers) {
+    auto ret = ReadAt(offset + total, b.data, b.size);
+    if (ret < 0) {
+      return ret;
+    }
+    total += ret;
+    if (static_cast<size_t>(ret) < b.size) {
+      break;
+    }
+  }
+  return total;
+#else
+  std::vector<iovec> iov;
+  iov.reserve(buffers.size());
+  for (const auto& b : buffers) {
+    iov.push_back(iovec{b.data, b.size});
+  }
+  ssize_t ret = preadv(handle_, iov.data(), static_cast<int>(iov.size()), offset);
+  if (ret == -1) {
+    LOG(ERROR) << "ReadAt errno: " << errno << " filename: " << full_path_name_
+               << " offset: " << offset << " buffers: " << buffers.size();
+  }
+  return ret;
+#endif  // __APPLE__
+}
+
+bool File::Sync() {
+  if (fsync(handle_) != 0) {
+    LOG(ERROR) << "Sync errno: " << errno << " filename: " << full_path_name_;
+    return false;
+  }
+  return true;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // Static functions
 
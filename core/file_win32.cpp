@@ -31,6 +31,7 @@
 #include <string>
 #include <sys/stat.h>
 
+#include "core/log.h"
 #include "core/wwivassert.h"
 
 using std::string;
@@ -58,6 +59,90 @@ const char File::separatorChar     = ';';
 /////////////////////////////////////////////////////////////////////////////
 // Member functions
 
+// Windows has no pread, but ReadFile and WriteFile take the offset to use
+// in an OVERLAPPED structure.
+static OVERLAPPED overlapped_at(off_t offset) {
+  OVERLAPPED o{};
+  const auto offset64 = static_cast<uint64_t>(offset);
+  o.Offset = static_cast<DWORD>(offset64 & 0xffffffff);
+  o.OffsetHigh = static_cast<DWORD>(offset64 >> 32);
+  return o;
+}
+
+// ReadFile and WriteFile still move the file pointer of a synchronous handle
+// to the end of the transfer when given an offset, so ReadAt and WriteAt put
+// it back where it was.
+class FilePointerSaver {
+public:
+  explicit FilePointerSaver(HANDLE h) : h_(h) {
+    LARGE_INTEGER zero{};
+    ok_ = ::SetFilePointerEx(h_, zero, &pos_, FILE_CURRENT) != FALSE;
+  }
+  ~FilePointerSaver() {
+    if (ok_) {
+      ::SetFilePointerEx(h_, pos_, nullptr, FILE_BEGIN);
+    }
+  }
+
+private:
+  HANDLE h_;
+  LARGE_INTEGER pos_{};
+  bool ok_{false};
+};
+
+ssize_t File::ReadAt(off_t offset, void* buffer, size_t size) {
+  auto h = reinterpret_cast<HANDLE>(_get_osfhandle(handle_));
+  FilePointerSaver saver(h);
+  auto o = overlapped_at(offset);
+  DWORD num_read = 0;
+  if (!::ReadFile(h, buffer, static_cast<DWORD>(size), &num_read, &o)) {
+    const auto error = GetLastError();
+    if (error == ERROR_HANDLE_EOF) {
+      return 0;
+    }
+    LOG(ERROR) << "ReadAt error: " << error << " filename: " << full_path_name_
+               << " offset: " << offset << " size: " << size;
+    return -1;
+  }
+  return static_cast<ssize_t>(num_read);
+}
+
+ssize_t File::WriteAt(off_t offset, const void* buffer, size_t size) {
+  auto h = reinterpret_cast<HANDLE>(_get_osfhandle(handle_));
+  FilePointerSaver saver(h);
+  auto o = overlapped_at(offset);
+  DWORD num_written = 0;
+  if (!::WriteFile(h, buffer, static_cast<DWORD>(size), &num_written, &o)) {
+    LOG(ERROR) << "WriteAt error: " << GetLastError() << " filename: " << full_path_name_
+               << " offset: " << offset << " size: " << size;
+    return -1;
+  }
+  return static_cast<ssize_t>(num_written);
+}
+
+ssize_t File::ReadAt(off_t offset, const std::vector<Buffer>& buffers) {
+  ssize_t total = 0;
+  for (const auto& b : buffers) {
+    auto ret = ReadAt(offset + total, b.data, b.size);
+    if (ret < 0) {
+      return ret;
+    }
+    total += ret;
+    if (static_cast<size_t>(ret) < b.size) {
+      break;
+    }
+  }
+  return total;
+}
+
+bool File::Sync() {
+  if (_commit(handle_) != 0) {
+    LOG(ERROR) << "Sync errno: " << errno << " filename: " << full_path_name_;
+    return false;
+  }
+  return true;
+}
+
 /////////////////////////////////////////////////////////////////////////////
 // Static functions
 
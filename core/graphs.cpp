@@ -8,7 +8,8 @@
 #include <string>
 #include <list>
 #include <limits> 
-#include <set>
+#include <queue>
+#include <functional>
 #include <utility>
 #include <algorithm> 
 #include <iterator>
@@ -24,52 +25,101 @@ using std::vector;
 static constexpr uint16_t NO_NODE = 0;
 static constexpr float max_cost = numeric_limits<float>::infinity();
 
-Graph::Graph(uint16_t node, uint16_t max_size) 
-  : node_(node), max_size_(max_size), adjacency_list_(max_size), cost_() {
-    cost_.clear();
-    cost_.resize(max_size, max_cost);
-    cost_[node] = 0;
-    previous_.clear();
-    previous_.resize(max_size, NO_NODE);
-}
+Graph::Graph(uint16_t node, uint16_t max_size) : node_(node), max_size_(max_size) {}
 
 Graph::~Graph() {}
 
 bool Graph::add_edge(uint16_t source, uint16_t dest, float cost) {
-  if (computed_) {
+  if (computed_ || source >= max_size_ || dest >= max_size_) {
     return false;
   }
 
   //VLOG(3) << "adding edge: " << source << " " << dest << " " << cost << " " << std::boolalpha << computed_ << std::endl;
-  adjacency_list_[source].emplace_back(dest, cost);
+  edges_.push_back({source, dest, cost});
   return true;
 }
 
 bool Graph::has_node(uint16_t source) {
-  return !adjacency_list_[source].empty();
+  if (!computed_) {
+    return std::any_of(edges_.begin(), edges_.end(),
+                       [=](const source_edge& e) { return e.source == source; });
+  }
+  auto i = index_of(source);
+  return i >= 0 && row_start_[i + 1] > row_start_[i];
 }
 
-
 void Graph::Compute() {
   computed_ = true;
-  std::set<std::pair<float, uint16_t>> queue;
-  queue.insert(std::make_pair(cost_[node_], node_));
+
+  // Number the nodes that are in the graph in ascending order.
+  uint16_t highest = node_;
+  for (const auto& e : edges_) {
+    highest = std::max({highest, e.source, e.dest});
+  }
+  index_.assign(highest + 1, -1);
+  index_[node_] = 1;
+  for (const auto& e : edges_) {
+    index_[e.source] = 1;
+    index_[e.dest] = 1;
+  }
+  for (size_t n = 0; n < index_.size(); n++) {
+    if (index_[n] != -1) {
+      index_[n] = static_cast<int32_t>(nodes_.size());
+      nodes_.push_back(static_cast<uint16_t>(n));
+    }
+  }
+  const auto num_nodes = nodes_.size();
+
+  // Build the rows, keeping the edges for each node in the order they
+  // were added so ties are broken the same way they always have been.
+  row_start_.assign(num_nodes + 1, 0);
+  for (const auto& e : edges_) {
+    ++row_start_[index_of(e.source) + 1];
+  }
+  for (size_t i = 0; i < num_nodes; i++) {
+    row_start_[i + 1] += row_start_[i];
+  }
+  edge_dest_.resize(edges_.size());
+  edge_cost_.resize(edges_.size());
+  vector<uint32_t> next(row_start_.begin(), row_start_.end() - 1);
+  for (const auto& e : edges_) {
+    auto pos = next[index_of(e.source)]++;
+    edge_dest_[pos] = static_cast<uint32_t>(index_of(e.dest));
+    edge_cost_[pos] = e.cost;
+  }
+  edges_.clear();
+  edges_.shrink_to_fit();
+
+  cost_.assign(num_nodes, max_cost);
+  previous_.assign(num_nodes, -1);
+
+  // Binary heap of (cost, node index) with lazy deletion, entries for
+  // nodes that have since been reached more cheaply are skipped when
+  // popped. Since nodes_ is sorted this visits nodes in the same order
+  // as the ordered set of (cost, node number) that used to be used here.
+  typedef std::pair<float, int32_t> queue_entry;
+  std::priority_queue<queue_entry, vector<queue_entry>, std::greater<queue_entry>> queue;
+  const auto start = index_of(node_);
+  cost_[start] = 0;
+  queue.emplace(0.0f, start);
 
   while (!queue.empty()) {
-    float dist = queue.begin()->first;
-    uint16_t u = queue.begin()->second;
-    queue.erase(queue.begin());
+    const auto dist = queue.top().first;
+    const auto u = queue.top().second;
+    queue.pop();
+    if (dist > cost_[u]) {
+      // Stale entry.
+      continue;
+    }
 
     // Visit each edge exiting u
-    const std::vector<edge> &edges = adjacency_list_[u];
-    for (const auto& e : edges) {
-      uint16_t v = e.node_;
-      float cost_through_u = dist + e.cost_;
+    for (auto n = row_start_[u]; n < row_start_[u + 1]; n++) {
+      const auto v = edge_dest_[n];
+      float cost_through_u = dist + edge_cost_[n];
       if (cost_through_u < cost_[v]) {
-        queue.erase(std::make_pair(cost_[v], v));
         cost_[v] = cost_through_u;
         previous_[v] = u;
-        queue.insert(std::make_pair(cost_[v], v));
+        queue.emplace(cost_through_u, v);
       }
     }
   }
@@ -80,17 +130,22 @@ float Graph::cost_to(uint16_t destination) {
   if (!computed_) {
     Compute();
   }
-  return cost_[destination];
+  auto i = index_of(destination);
+  return i < 0 ? max_cost : cost_[i];
 }
 
 
 std::string Graph::DumpCosts() const {
   std::ostringstream ss;
   ss << "costs_: ";
-  for (int i = 0; i < std::numeric_limits<uint16_t>::max(); i++) {
+  if (!computed_) {
+    ss << node_ << "[0] ";
+    return ss.str();
+  }
+  for (size_t i = 0; i < nodes_.size(); i++) {
     float cost = cost_[i];
     if (std::isfinite(cost)) {
-      ss << i << "[" << cost_[i] << "] ";
+      ss << nodes_[i] << "[" << cost << "] ";
     }
   }
   return ss.str();
@@ -102,8 +157,15 @@ std::list<uint16_t> Graph::shortest_path_to(uint16_t destination) {
     Compute();
   }
   std::list<uint16_t> path;
-  for (; destination != NO_NODE; destination = previous_[destination]) {
-    path.push_front(destination);
+  if (destination == NO_NODE) {
+    return path;
+  }
+  path.push_front(destination);
+  for (auto i = index_of(destination); i >= 0 && previous_[i] >= 0; i = previous_[i]) {
+    if (nodes_[previous_[i]] == NO_NODE) {
+      break;
+    }
+    path.push_front(nodes_[previous_[i]]);
   }
   return path;
 }
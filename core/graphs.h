@@ -48,6 +48,10 @@ typedef std::vector<std::vector<edge>> adjacency_list_t;
  net.add_edge(3, 2, 0);
 
  list<uint16_t> path = net.shortest_path_to(3);
+
+ Only the nodes that have edges are stored, the edges are kept in a
+ compressed sparse row layout once the paths are computed, so memory
+ and time scale with the size of the network and not with max_size.
  */
 class Graph {
 public:
@@ -68,14 +72,34 @@ public:
   }
 
 private:
+  struct source_edge {
+    uint16_t source;
+    uint16_t dest;
+    float cost;
+  };
+
+  /** Returns the index of node within nodes_, or -1 if it has no edges. */
+  int index_of(uint16_t node) const noexcept {
+    return node < index_.size() ? index_[node] : -1;
+  }
+  void Compute();
+
   uint16_t node_;
   uint16_t max_size_;
-  adjacency_list_t adjacency_list_;
   bool computed_ = false;
+  // Edges in the order they were added, until Compute builds the rows.
+  std::vector<source_edge> edges_;
+  // Sorted node numbers, the index within this is used for the other vectors.
+  std::vector<uint16_t> nodes_;
+  // Index within nodes_ for each node number up to the highest one used.
+  std::vector<int32_t> index_;
+  // Edges from nodes_[i] are edge_dest_[row_start_[i]] .. edge_dest_[row_start_[i+1]].
+  std::vector<uint32_t> row_start_;
+  std::vector<uint32_t> edge_dest_;
+  std::vector<float> edge_cost_;
   std::vector<float> cost_;
-  std::vector<uint16_t> previous_;
-
-  void Compute();
+  // Index of the previous node on the shortest path, or -1.
+  std::vector<int32_t> previous_;
 };
 
 }  // namespace graphs
@@ -110,9 +110,13 @@ Logger::~Logger() {
     }
   }
   const auto msg = FormatLogMessage(level_, verbosity_, ss_.str());
-  const auto& appenders = config_.log_to[level_];
-  for (auto appender : appenders) {
-    appender->append(msg);
+  // Use find since operator[] would modify log_to, which isn't safe when
+  // logging from many threads.
+  auto it = config_.log_to.find(level_);
+  if (it != config_.log_to.end()) {
+    for (const auto& appender : it->second) {
+      appender->append(msg);
+    }
   }
   if (level_ == LoggerLevel::fatal) {
     abort();
@@ -0,0 +1,150 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "core/metrics.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "core/file.h"
+
+namespace wwiv {
+namespace core {
+
+void Histogram::Record(std::chrono::microseconds d) noexcept {
+  const auto us = std::max<int64_t>(0, d.count());
+  auto i = 0;
+  while (i < NUM_BUCKETS - 1 && (int64_t{1} << i) <= us) {
+    i++;
+  }
+  buckets_[i].fetch_add(1, std::memory_order_relaxed);
+  count_.fetch_add(1, std::memory_order_relaxed);
+  sum_us_.fetch_add(us, std::memory_order_relaxed);
+  auto max = max_us_.load(std::memory_order_relaxed);
+  while (us > max && !max_us_.compare_exchange_weak(max, us, std::memory_order_relaxed)) {
+  }
+}
+
+Metrics& Metrics::Global() {
+  static Metrics metrics;
+  return metrics;
+}
+
+template <typename T>
+static T& find_or_create(std::map<std::string, std::unique_ptr<T>>& m, const std::string& name) {
+  auto& p = m[name];
+  if (!p) {
+    p = std::make_unique<T>();
+  }
+  return *p;
+}
+
+Counter& Metrics::counter(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mu_);
+  return find_or_create(counters_, name);
+}
+
+Gauge& Metrics::gauge(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mu_);
+  return find_or_create(gauges_, name);
+}
+
+Histogram& Metrics::histogram(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mu_);
+  return find_or_create(histograms_, name);
+}
+
+std::string JsonString(const std::string& s) {
+  std::string out("\"");
+  for (const auto c : s) {
+    if (c == '"' || c == '\\') {
+      out.push_back('\\');
+    }
+    if (static_cast<unsigned char>(c) >= 0x20) {
+      out.push_back(c);
+    }
+  }
+  out.push_back('"');
+  return out;
+}
+
+template <typename T>
+static void values_to_json(std::ostream& os, const std::map<std::string, std::unique_ptr<T>>& m) {
+  os << "{";
+  auto first = true;
+  for (const auto& kv : m) {
+    os << (first ? "" : ",") << JsonString(kv.first) << ":" << kv.second->value();
+    first = false;
+  }
+  os << "}";
+}
+
+std::string Metrics::ToJson() const {
+  std::lock_guard<std::mutex> lock(mu_);
+  std::ostringstream os;
+  os << "{\"counters\":";
+  values_to_json(os, counters_);
+  os << ",\"gauges\":";
+  values_to_json(os, gauges_);
+  os << ",\"histograms\":{";
+  auto first = true;
+  for (const auto& kv : histograms_) {
+    const auto& h = *kv.second;
+    os << (first ? "" : ",") << JsonString(kv.first) << ":{\"count\":" << h.count()
+       << ",\"sum_us\":" << h.sum_us() << ",\"max_us\":" << h.max_us() << ",\"buckets\":{";
+    auto first_bucket = true;
+    for (auto i = 0; i < Histogram::NUM_BUCKETS; i++) {
+      if (const auto n = h.bucket(i)) {
+        os << (first_bucket ? "" : ",") << "\"" << (int64_t{1} << i) << "\":" << n;
+        first_bucket = false;
+      }
+    }
+    os << "}}";
+    first = false;
+  }
+  os << "}}";
+  return os.str();
+}
+
+bool Metrics::WriteJson(const std::string& path) const {
+  const auto json = ToJson();
+  const auto temp_path = path + ".tmp";
+  {
+    File file(temp_path);
+    if (!file.Open(File::modeWriteOnly | File::modeBinary | File::modeCreateFile |
+                   File::modeTruncate)) {
+      return false;
+    }
+    if (file.Write(json) != static_cast<ssize_t>(json.size())) {
+      file.Close();
+      File::Remove(temp_path);
+      return false;
+    }
+  }
+  if (!File::Rename(temp_path, path)) {
+    // Windows won't rename over an existing file.
+    File::Remove(path);
+    if (!File::Rename(temp_path, path)) {
+      File::Remove(temp_path);
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace core
+} // namespace wwiv
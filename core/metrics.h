@@ -0,0 +1,136 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef __INCLUDED_CORE_METRICS_H__
+#define __INCLUDED_CORE_METRICS_H__
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace wwiv {
+namespace core {
+
+/** A value that only goes up, like the number of packets read. */
+class Counter final {
+public:
+  void Add(int64_t n = 1) noexcept { value_.fetch_add(n, std::memory_order_relaxed); }
+  int64_t value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<int64_t> value_{0};
+};
+
+/** A value that is set, like the bytes per second of the last session. */
+class Gauge final {
+public:
+  void Set(int64_t n) noexcept { value_.store(n, std::memory_order_relaxed); }
+  int64_t value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<int64_t> value_{0};
+};
+
+/**
+ * Latencies in microseconds. Bucket i counts the values below 2^i us
+ * (and at least 2^(i-1) us), the last bucket also has everything larger.
+ */
+class Histogram final {
+public:
+  static constexpr int NUM_BUCKETS = 32;
+
+  void Record(std::chrono::microseconds d) noexcept;
+  int64_t count() const noexcept { return count_.load(std::memory_order_relaxed); }
+  int64_t sum_us() const noexcept { return sum_us_.load(std::memory_order_relaxed); }
+  int64_t max_us() const noexcept { return max_us_.load(std::memory_order_relaxed); }
+  int64_t bucket(int i) const noexcept { return buckets_[i].load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<int64_t> count_{0};
+  std::atomic<int64_t> sum_us_{0};
+  std::atomic<int64_t> max_us_{0};
+  std::array<std::atomic<int64_t>, NUM_BUCKETS> buckets_{};
+};
+
+/**
+ * Named counters, gauges and histograms for the whole process.
+ *
+ * Metrics are created the first time they are asked for, and the
+ * references returned stay valid for the life of the process, so hot
+ * paths should look them up once and keep the reference.
+ *
+ * Example:
+ *   static auto& packets = Metrics::Global().counter("network1.packets_read");
+ *   packets.Add();
+ */
+class Metrics final {
+public:
+  static Metrics& Global();
+
+  Counter& counter(const std::string& name);
+  Gauge& gauge(const std::string& name);
+  Histogram& histogram(const std::string& name);
+
+  /**
+   * All of the metrics as a JSON object like:
+   * {"counters":{"name":1},"gauges":{},"histograms":{"name":{"count":1,
+   *  "sum_us":10,"max_us":10,"buckets":{"16":1}}}}
+   * where the buckets are keyed by their upper bound in microseconds.
+   */
+  std::string ToJson() const;
+  /**
+   * Writes ToJson to path, replacing whatever was there. The snapshot is
+   * written to a temporary file and renamed into place, so readers never
+   * see a partial one.
+   */
+  bool WriteJson(const std::string& path) const;
+
+private:
+  mutable std::mutex mu_;
+  std::map<std::string, std::unique_ptr<Counter>> counters_;
+  std::map<std::string, std::unique_ptr<Gauge>> gauges_;
+  std::map<std::string, std::unique_ptr<Histogram>> histograms_;
+};
+
+/** Returns s as a quoted JSON string, control characters are dropped. */
+std::string JsonString(const std::string& s);
+
+/** Records the time from construction until destruction in a Histogram. */
+class ScopedTimer final {
+public:
+  explicit ScopedTimer(Histogram& h) : h_(h), start_(std::chrono::steady_clock::now()) {}
+  ScopedTimer(const ScopedTimer&) = delete;
+  ScopedTimer& operator=(const ScopedTimer&) = delete;
+  ~ScopedTimer() {
+    h_.Record(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start_));
+  }
+
+private:
+  Histogram& h_;
+  const std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace core
+} // namespace wwiv
+
+#endif // __INCLUDED_CORE_METRICS_H__
@@ -0,0 +1,118 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef __INCLUDED_CORE_MMAP_FILE_H__
+#define __INCLUDED_CORE_MMAP_FILE_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace wwiv {
+namespace core {
+
+/**
+ * MemoryMappedFile: View of a whole file mapped into memory.
+ *
+ * The mapping covers the length of the file at the time Open was called,
+ * writes made to the file by other handles within that range are visible
+ * through the view. Callers that know the file has grown should call
+ * Open again to remap it.
+ *
+ * Files opened with Mode::read_write are mapped shared, so stores made
+ * through mutable_data() are written back to the file.
+ *
+ * Example:
+ *   MemoryMappedFile f("/home/wwiv/data/general.sub");
+ *   if (!f.Open()) { LOG(ERROR) << "Unable to map file"; }
+ *   auto* p = reinterpret_cast<const postrec*>(f.data());
+ */
+class MemoryMappedFile final {
+public:
+  enum class Mode { read_only, read_write };
+
+  explicit MemoryMappedFile(const std::string& full_file_name, Mode mode = Mode::read_only);
+  MemoryMappedFile(const MemoryMappedFile&) = delete;
+  MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+  ~MemoryMappedFile();
+
+  /**
+   * Maps the file, releasing any existing mapping first.
+   * Returns false if the file does not exist or is empty.
+   */
+  bool Open();
+  void Close();
+  bool IsOpen() const noexcept { return data_ != nullptr; }
+
+  const uint8_t* data() const noexcept { return data_; }
+  /** Returns the writable view, or nullptr unless opened with Mode::read_write. */
+  uint8_t* mutable_data() const noexcept { return mode_ == Mode::read_write ? data_ : nullptr; }
+  std::size_t size() const noexcept { return size_; }
+  const std::string& full_pathname() const noexcept { return full_path_name_; }
+
+  explicit operator bool() const noexcept { return IsOpen(); }
+
+private:
+  const std::string full_path_name_;
+  const Mode mode_;
+  uint8_t* data_{nullptr};
+  std::size_t size_{0};
+#ifdef _WIN32
+  void* mapping_handle_{nullptr};
+#endif  // _WIN32
+};
+
+/**
+ * MappedDataFile: A DataFile like view of fixed size records that are
+ * backed by a MemoryMappedFile. Records are never copied, the caller gets
+ * a pointer directly into the mapping which is only valid until the next
+ * call to Open or Close.
+ */
+template <typename RECORD, std::size_t SIZE = sizeof(RECORD)>
+class MappedDataFile {
+public:
+  explicit MappedDataFile(const std::string& full_file_name) : file_(full_file_name) {}
+
+  bool Open() { return file_.Open(); }
+  void Close() { file_.Close(); }
+  bool ok() const noexcept { return file_.IsOpen(); }
+  MemoryMappedFile& file() noexcept { return file_; }
+  const MemoryMappedFile& file() const noexcept { return file_; }
+
+  std::size_t number_of_records() const noexcept { return file_.size() / SIZE; }
+
+  /** Returns the record at record_number or nullptr if it is not mapped. */
+  const RECORD* at(std::size_t record_number) const noexcept {
+    if (record_number >= number_of_records()) {
+      return nullptr;
+    }
+    return reinterpret_cast<const RECORD*>(file_.data() + record_number * SIZE);
+  }
+
+  const RECORD* begin() const noexcept { return reinterpret_cast<const RECORD*>(file_.data()); }
+  const RECORD* end() const noexcept { return begin() + number_of_records(); }
+
+  explicit operator bool() const noexcept { return file_.IsOpen(); }
+
+private:
+  MemoryMappedFile file_;
+};
+
+}  // namespace core
+}  // namespace wwiv
+
+#endif  // __INCLUDED_CORE_MMAP_FILE_H__
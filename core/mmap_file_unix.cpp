@@ -0,0 +1,76 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "core/mmap_file.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "core/log.h"
+
+using std::string;
+
+namespace wwiv {
+namespace core {
+
+MemoryMappedFile::MemoryMappedFile(const string& full_file_name, Mode mode)
+    : full_path_name_(full_file_name), mode_(mode) {}
+
+MemoryMappedFile::~MemoryMappedFile() { Close(); }
+
+bool MemoryMappedFile::Open() {
+  Close();
+  const bool writable = mode_ == Mode::read_write;
+  int fd = open(full_path_name_.c_str(), writable ? O_RDWR : O_RDONLY);
+  if (fd < 0) {
+    VLOG(3) << "MemoryMappedFile: Unable to open: " << full_path_name_ << "; " << strerror(errno);
+    return false;
+  }
+  struct stat st {};
+  if (fstat(fd, &st) != 0 || st.st_size == 0) {
+    close(fd);
+    return false;
+  }
+  auto size = static_cast<size_t>(st.st_size);
+  void* p = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+  // The mapping holds its own reference to the file.
+  close(fd);
+  if (p == MAP_FAILED) {
+    LOG(ERROR) << "MemoryMappedFile: mmap failed for: " << full_path_name_ << "; "
+               << strerror(errno);
+    return false;
+  }
+  data_ = static_cast<uint8_t*>(p);
+  size_ = size;
+  return true;
+}
+
+void MemoryMappedFile::Close() {
+  if (data_ != nullptr) {
+    munmap(data_, size_);
+  }
+  data_ = nullptr;
+  size_ = 0;
+}
+
+}  // namespace core
+}  // namespace wwiv
@@ -0,0 +1,85 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "core/mmap_file.h"
+// Always declare wwiv_windows.h first to avoid collisions on defines.
+#include "core/wwiv_windows.h"
+
+#include <string>
+
+#include "core/log.h"
+
+using std::string;
+
+namespace wwiv {
+namespace core {
+
+MemoryMappedFile::MemoryMappedFile(const string& full_file_name, Mode mode)
+    : full_path_name_(full_file_name), mode_(mode) {}
+
+MemoryMappedFile::~MemoryMappedFile() { Close(); }
+
+bool MemoryMappedFile::Open() {
+  Close();
+  const bool writable = mode_ == Mode::read_write;
+  HANDLE h = ::CreateFileA(full_path_name_.c_str(),
+                           writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ,
+                           FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+                           OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (h == INVALID_HANDLE_VALUE) {
+    VLOG(3) << "MemoryMappedFile: Unable to open: " << full_path_name_;
+    return false;
+  }
+  LARGE_INTEGER size{};
+  if (!::GetFileSizeEx(h, &size) || size.QuadPart == 0) {
+    ::CloseHandle(h);
+    return false;
+  }
+  HANDLE mapping = ::CreateFileMappingA(h, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+                                        0, 0, nullptr);
+  // The mapping holds its own reference to the file.
+  ::CloseHandle(h);
+  if (mapping == nullptr) {
+    LOG(ERROR) << "MemoryMappedFile: CreateFileMapping failed for: " << full_path_name_;
+    return false;
+  }
+  void* p = ::MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0);
+  if (p == nullptr) {
+    LOG(ERROR) << "MemoryMappedFile: MapViewOfFile failed for: " << full_path_name_;
+    ::CloseHandle(mapping);
+    return false;
+  }
+  mapping_handle_ = mapping;
+  data_ = static_cast<uint8_t*>(p);
+  size_ = static_cast<size_t>(size.QuadPart);
+  return true;
+}
+
+void MemoryMappedFile::Close() {
+  if (data_ != nullptr) {
+    ::UnmapViewOfFile(data_);
+  }
+  if (mapping_handle_ != nullptr) {
+    ::CloseHandle(mapping_handle_);
+  }
+  mapping_handle_ = nullptr;
+  data_ = nullptr;
+  size_ = 0;
+}
+
+}  // namespace core
+}  // namespace wwiv
@@ -90,12 +90,17 @@ SemaphoreFile SemaphoreFile::acquire(const std::string& filepath, const std::str
 SemaphoreFile::SemaphoreFile(const std::string& filepath, int fd) 
   : filename_(filepath), fd_(fd) {}
 
+SemaphoreFile::SemaphoreFile(SemaphoreFile&& other) noexcept
+    : filename_(other.filename_), fd_(other.fd_) {
+  other.fd_ = -1;
+}
+
 SemaphoreFile::~SemaphoreFile() {
-  VLOG(1) << "~SemaphoreFile(): " << filename_ << "; fd: " << fd_;
   if (fd_ < 0) {
-    LOG(ERROR) << "Skipping closing since file already closed: " << filename_;
+    // Moved from, the new owner releases it.
     return;
   }
+  VLOG(1) << "~SemaphoreFile(): " << filename_ << "; fd: " << fd_;
   if (close(fd_) == -1) {
     LOG(ERROR) << "Failed to close file: " << filename_ << "; error: " << errno;
   }
@@ -76,7 +76,8 @@ public:
   const std::string& filename() const { return filename_; }
   int fd() const { return fd_; }
 
-  SemaphoreFile(SemaphoreFile&&) = default;
+  // The moved from object no longer owns the semaphore file.
+  SemaphoreFile(SemaphoreFile&& other) noexcept;
   SemaphoreFile(const SemaphoreFile&) = delete;
   SemaphoreFile& operator= (const SemaphoreFile&) = delete;
 
@@ -214,3 +214,50 @@ TEST(DataFileTest, Read_DoesNotExist) {
   }
   EXPECT_FALSE(datafile);
 }
+
+TEST(DataFileTest, ReadRange) {
+  struct T { int a; int b; };
+  FileHelper file;
+  string tmp = file.TempDir();
+
+  {
+    DataFile<T> datafile(FilePath(tmp, "ReadRange"),
+                         File::modeCreateFile | File::modeBinary | File::modeReadWrite);
+    ASSERT_TRUE((bool)datafile);
+    std::vector<T> t = {{1, 2}, {3, 4}, {5, 6}, {7, 8}};
+    datafile.WriteVector(t);
+  }
+
+  DataFile<T> datafile(FilePath(tmp, "ReadRange"), File::modeReadOnly);
+  ASSERT_TRUE((bool)datafile);
+  std::vector<T> t;
+  EXPECT_TRUE(datafile.ReadRange(1, 2, t));
+  ASSERT_EQ(static_cast<size_t>(2), t.size());
+  EXPECT_EQ(3, t[0].a);
+  EXPECT_EQ(6, t[1].b);
+
+  EXPECT_TRUE(datafile.ReadRange(0, 0, t));
+  EXPECT_TRUE(t.empty());
+  // Past the end of the file.
+  EXPECT_FALSE(datafile.ReadRange(3, 2, t));
+}
+
+TEST(DataFileTest, WriteRange) {
+  struct T { int a; int b; };
+  FileHelper file;
+  string tmp = file.TempDir();
+
+  DataFile<T> datafile(FilePath(tmp, "WriteRange"),
+                       File::modeCreateFile | File::modeBinary | File::modeReadWrite);
+  ASSERT_TRUE((bool)datafile);
+  std::vector<T> t = {{1, 2}, {3, 4}, {5, 6}};
+  datafile.WriteVector(t);
+  T u[] = {{9, 9}, {8, 8}};
+  EXPECT_TRUE(datafile.WriteRange(1, 2, u));
+
+  T r{};
+  EXPECT_TRUE(datafile.Read(0, &r));
+  EXPECT_EQ(1, r.a);
+  EXPECT_TRUE(datafile.Read(2, &r));
+  EXPECT_EQ(8, r.a);
+}
@@ -386,3 +386,58 @@ TEST(FileTest, CurrentPosition) {
   EXPECT_EQ(static_cast<int>(kContents.size()), file.Seek(0, File::Whence::end));
   EXPECT_EQ(static_cast<int>(kContents.size()), file.current_position());
 }
+
+TEST(FileTest, ReadAt) {
+  static const string kContents = "0123456789";
+  FileHelper helper;
+  const auto path = helper.CreateTempFile(this->test_info_->name(), kContents);
+  File file(path);
+  ASSERT_TRUE(file.Open(File::modeBinary | File::modeReadOnly));
+
+  EXPECT_EQ(2, file.Seek(2, File::Whence::begin));
+  char buf[4]{};
+  EXPECT_EQ(3, file.ReadAt(5, buf, 3));
+  EXPECT_STREQ("567", buf);
+  // The current position is untouched.
+  EXPECT_EQ(2, file.current_position());
+
+  EXPECT_EQ(2, file.ReadAt(8, buf, 3));
+  EXPECT_EQ(0, file.ReadAt(10, buf, 3));
+}
+
+TEST(FileTest, ReadAt_Buffers) {
+  static const string kContents = "0123456789";
+  FileHelper helper;
+  const auto path = helper.CreateTempFile(this->test_info_->name(), kContents);
+  File file(path);
+  ASSERT_TRUE(file.Open(File::modeBinary | File::modeReadOnly));
+
+  char a[3]{};
+  char b[5]{};
+  EXPECT_EQ(6, file.ReadAt(1, {{a, 2}, {b, 4}}));
+  EXPECT_STREQ("12", a);
+  EXPECT_STREQ("3456", b);
+}
+
+TEST(FileTest, WriteAt) {
+  static const string kContents = "0123456789";
+  FileHelper helper;
+  const auto path = helper.CreateTempFile(this->test_info_->name(), kContents);
+  {
+    File file(path);
+    ASSERT_TRUE(file.Open(File::modeBinary | File::modeReadWrite));
+    EXPECT_EQ(2, file.WriteAt(4, "ab", 2));
+    EXPECT_EQ(0, file.current_position());
+  }
+  EXPECT_EQ("0123ab6789", helper.ReadFile(path));
+}
+
+TEST(FileTest, Sync) {
+  FileHelper helper;
+  const auto path = helper.CreateTempFile(this->test_info_->name(), "");
+  File file(path);
+  ASSERT_TRUE(file.Open(File::modeBinary | File::modeReadWrite));
+  EXPECT_EQ(5, file.Write("Hello", 5));
+  EXPECT_TRUE(file.Sync());
+  EXPECT_EQ("Hello", helper.ReadFile(path));
+}
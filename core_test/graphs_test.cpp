@@ -0,0 +1,110 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include <cmath>
+#include <cstdint>
+#include <list>
+#include <string>
+
+#include "core/graphs.h"
+
+using std::list;
+using std::string;
+using namespace wwiv::graphs;
+
+TEST(GraphsTest, ShortestPath) {
+  Graph g(1, 200);
+  g.add_edge(1, 2, 1.0f);
+  g.add_edge(2, 1, 1.0f);
+  g.add_edge(2, 3, 1.0f);
+  g.add_edge(3, 2, 1.0f);
+  g.add_edge(3, 4, 1.0f);
+  g.add_edge(4, 3, 1.0f);
+
+  EXPECT_EQ((list<uint16_t>{1, 2, 3, 4}), g.shortest_path_to(4));
+  EXPECT_FLOAT_EQ(3.0f, g.cost_to(4));
+  EXPECT_EQ(3, g.num_hops_to(4));
+  EXPECT_EQ((list<uint16_t>{1}), g.shortest_path_to(1));
+  EXPECT_FLOAT_EQ(0.0f, g.cost_to(1));
+}
+
+TEST(GraphsTest, CheaperLongerPath) {
+  Graph g(1, 200);
+  g.add_edge(1, 2, 10.0f);
+  g.add_edge(1, 3, 1.0f);
+  g.add_edge(3, 4, 1.0f);
+  g.add_edge(4, 2, 1.0f);
+
+  EXPECT_EQ((list<uint16_t>{1, 3, 4, 2}), g.shortest_path_to(2));
+  EXPECT_FLOAT_EQ(3.0f, g.cost_to(2));
+}
+
+TEST(GraphsTest, EqualCostPathsUseLowestNode) {
+  Graph g(1, 200);
+  g.add_edge(1, 3, 1.0f);
+  g.add_edge(1, 2, 1.0f);
+  g.add_edge(3, 4, 1.0f);
+  g.add_edge(2, 4, 1.0f);
+
+  EXPECT_EQ((list<uint16_t>{1, 2, 4}), g.shortest_path_to(4));
+}
+
+TEST(GraphsTest, Unreachable) {
+  Graph g(1, 200);
+  g.add_edge(1, 2, 1.0f);
+  g.add_edge(3, 4, 1.0f);
+
+  EXPECT_FALSE(std::isfinite(g.cost_to(4)));
+  EXPECT_EQ((list<uint16_t>{4}), g.shortest_path_to(4));
+  EXPECT_FALSE(std::isfinite(g.cost_to(100)));
+  EXPECT_EQ((list<uint16_t>{100}), g.shortest_path_to(100));
+}
+
+TEST(GraphsTest, HasNode) {
+  Graph g(1, 200);
+  g.add_edge(1, 2, 1.0f);
+  EXPECT_TRUE(g.has_node(1));
+  EXPECT_FALSE(g.has_node(2));
+  g.cost_to(2);
+  EXPECT_TRUE(g.has_node(1));
+  EXPECT_FALSE(g.has_node(2));
+  EXPECT_FALSE(g.has_node(3));
+}
+
+TEST(GraphsTest, AddEdge_AfterCompute) {
+  Graph g(1, 200);
+  EXPECT_TRUE(g.add_edge(1, 2, 1.0f));
+  g.cost_to(2);
+  EXPECT_FALSE(g.add_edge(2, 3, 1.0f));
+}
+
+TEST(GraphsTest, AddEdge_OutOfRange) {
+  Graph g(1, 200);
+  EXPECT_FALSE(g.add_edge(1, 200, 1.0f));
+  EXPECT_FALSE(g.add_edge(200, 1, 1.0f));
+}
+
+TEST(GraphsTest, DumpCosts) {
+  Graph g(1, 200);
+  g.add_edge(1, 5, 2.0f);
+  g.add_edge(1, 3, 1.0f);
+  g.add_edge(7, 8, 1.0f);
+  g.cost_to(5);
+  EXPECT_EQ("costs_: 1[0] 3[1] 5[2] ", g.DumpCosts());
+}
@@ -0,0 +1,102 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <string>
+
+#include "core/file.h"
+#include "core/metrics.h"
+#include "core_test/file_helper.h"
+
+using std::string;
+using std::chrono::microseconds;
+using namespace wwiv::core;
+
+TEST(MetricsTest, Counter) {
+  Metrics m;
+  m.counter("a").Add();
+  m.counter("a").Add(2);
+  EXPECT_EQ(3, m.counter("a").value());
+  EXPECT_EQ(0, m.counter("b").value());
+}
+
+TEST(MetricsTest, SameMetricForSameName) {
+  Metrics m;
+  EXPECT_EQ(&m.counter("a"), &m.counter("a"));
+  EXPECT_EQ(&m.gauge("a"), &m.gauge("a"));
+  EXPECT_EQ(&m.histogram("a"), &m.histogram("a"));
+  EXPECT_NE(&m.counter("a"), &m.counter("b"));
+}
+
+TEST(MetricsTest, Histogram) {
+  Histogram h;
+  h.Record(microseconds(0));
+  h.Record(microseconds(1));
+  h.Record(microseconds(3));
+  h.Record(microseconds(4));
+  EXPECT_EQ(4, h.count());
+  EXPECT_EQ(8, h.sum_us());
+  EXPECT_EQ(4, h.max_us());
+  EXPECT_EQ(1, h.bucket(0));
+  EXPECT_EQ(1, h.bucket(1));
+  EXPECT_EQ(1, h.bucket(2));
+  EXPECT_EQ(1, h.bucket(3));
+}
+
+TEST(MetricsTest, Histogram_Overflow) {
+  Histogram h;
+  h.Record(microseconds(int64_t{1} << 40));
+  EXPECT_EQ(1, h.bucket(Histogram::NUM_BUCKETS - 1));
+}
+
+TEST(MetricsTest, ToJson) {
+  Metrics m;
+  EXPECT_EQ(R"({"counters":{},"gauges":{},"histograms":{}})", m.ToJson());
+
+  m.counter("network1.packets_read").Add(2);
+  m.gauge("g\"").Set(5);
+  m.histogram("h").Record(microseconds(3));
+  EXPECT_EQ(R"({"counters":{"network1.packets_read":2},"gauges":{"g\"":5},)"
+            R"("histograms":{"h":{"count":1,"sum_us":3,"max_us":3,"buckets":{"4":1}}}})",
+            m.ToJson());
+}
+
+TEST(MetricsTest, WriteJson) {
+  FileHelper helper;
+  Metrics m;
+  m.counter("a").Add();
+  const auto path = FilePath(helper.TempDir(), "metrics.json");
+  ASSERT_TRUE(m.WriteJson(path));
+  EXPECT_EQ(m.ToJson(), helper.ReadFile(path));
+}
+
+TEST(MetricsTest, WriteJson_Replaces) {
+  FileHelper helper;
+  const auto path = helper.CreateTempFile("metrics.json", "{\"old\":1, \"longer\":\"than the new\"}");
+  Metrics m;
+  m.counter("a").Add();
+  ASSERT_TRUE(m.WriteJson(path));
+  EXPECT_EQ(m.ToJson(), helper.ReadFile(path));
+  EXPECT_FALSE(File::Exists(path + ".tmp"));
+}
+
+TEST(MetricsTest, JsonString) {
+  EXPECT_EQ("\"a\\\"b\\\\c\"", JsonString("a\"b\\c"));
+  EXPECT_EQ("\"ab\"", JsonString("a\r\nb"));
+}
@@ -0,0 +1,130 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "file_helper.h"
+#include "gtest/gtest.h"
+#include "core/datafile.h"
+#include "core/file.h"
+#include "core/mmap_file.h"
+
+#include <string>
+
+using std::string;
+using namespace wwiv::core;
+
+TEST(MemoryMappedFileTest, Open) {
+  FileHelper file;
+  const auto path = file.CreateTempFile("Open", "Hello World");
+
+  MemoryMappedFile f(path);
+  ASSERT_TRUE(f.Open());
+  EXPECT_TRUE(f.IsOpen());
+  ASSERT_EQ(11u, f.size());
+  EXPECT_EQ("Hello World", string(reinterpret_cast<const char*>(f.data()), f.size()));
+
+  f.Close();
+  EXPECT_FALSE(f.IsOpen());
+  EXPECT_EQ(0u, f.size());
+}
+
+TEST(MemoryMappedFileTest, Open_DoesNotExist) {
+  FileHelper file;
+  MemoryMappedFile f(FilePath(file.TempDir(), "DoesNotExist"));
+  EXPECT_FALSE(f.Open());
+  EXPECT_FALSE(f);
+}
+
+TEST(MemoryMappedFileTest, Open_Empty) {
+  FileHelper file;
+  const auto path = file.CreateTempFile("Empty", "");
+  MemoryMappedFile f(path);
+  EXPECT_FALSE(f.Open());
+}
+
+TEST(MemoryMappedFileTest, ReadWrite) {
+  FileHelper file;
+  const auto path = file.CreateTempFile("ReadWrite", "Hello World");
+  {
+    MemoryMappedFile ro(path);
+    ASSERT_TRUE(ro.Open());
+    EXPECT_EQ(nullptr, ro.mutable_data());
+  }
+  {
+    MemoryMappedFile f(path, MemoryMappedFile::Mode::read_write);
+    ASSERT_TRUE(f.Open());
+    ASSERT_NE(nullptr, f.mutable_data());
+    f.mutable_data()[0] = 'J';
+  }
+
+  File f(path);
+  ASSERT_TRUE(f.Open(File::modeBinary | File::modeReadOnly));
+  string s;
+  s.resize(11);
+  f.Read(&s[0], 11);
+  EXPECT_EQ("Jello World", s);
+}
+
+TEST(MappedDataFileTest, Records) {
+  struct T { int a; int b; };
+  FileHelper file;
+  const auto path = FilePath(file.TempDir(), "Records");
+  {
+    DataFile<T> datafile(path, File::modeCreateFile | File::modeBinary | File::modeReadWrite);
+    ASSERT_TRUE((bool)datafile);
+    std::vector<T> t = {{1, 2}, {3, 4}};
+    datafile.WriteVector(t);
+  }
+
+  MappedDataFile<T> view(path);
+  ASSERT_TRUE(view.Open());
+  ASSERT_EQ(2u, view.number_of_records());
+  EXPECT_EQ(1, view.at(0)->a);
+  EXPECT_EQ(4, view.at(1)->b);
+  EXPECT_EQ(nullptr, view.at(2));
+
+  int sum = 0;
+  for (const auto& r : view) {
+    sum += r.a + r.b;
+  }
+  EXPECT_EQ(10, sum);
+}
+
+TEST(MappedDataFileTest, SeesWritesAndRemapsAfterGrowth) {
+  struct T { int a; int b; };
+  FileHelper file;
+  const auto path = FilePath(file.TempDir(), "Growth");
+  DataFile<T> datafile(path, File::modeCreateFile | File::modeBinary | File::modeReadWrite);
+  ASSERT_TRUE((bool)datafile);
+  T t1{1, 2};
+  datafile.Write(&t1);
+
+  MappedDataFile<T> view(path);
+  ASSERT_TRUE(view.Open());
+  ASSERT_EQ(1u, view.number_of_records());
+
+  // Writes within the mapped range are visible without remapping.
+  T t2{5, 6};
+  datafile.Write(0, &t2);
+  EXPECT_EQ(5, view.at(0)->a);
+
+  // Growth needs a remap.
+  datafile.Write(1, &t1);
+  EXPECT_EQ(1u, view.number_of_records());
+  ASSERT_TRUE(view.Open());
+  ASSERT_EQ(2u, view.number_of_records());
+  EXPECT_EQ(1, view.at(1)->a);
+}
@@ -18,6 +18,7 @@
 /**************************************************************************/
 #include <chrono>
 #include <string>
+#include <utility>
 
 #include "core/file.h"
 #include "core/log.h"
@@ -66,3 +67,21 @@ TEST(SemaphoreFileTest, Smoke) {
 
   EXPECT_TRUE(File::Exists(fn)) << fn;
 }
+
+TEST(SemaphoreFileTest, Move) {
+  FileHelper file;
+  auto tmp = file.TempDir();
+  string fn;
+  {
+    auto ok =
+        SemaphoreFile::try_acquire(FilePath(tmp, "x.sem"), "", std::chrono::milliseconds(100));
+    fn = ok.filename();
+    {
+      SemaphoreFile moved(std::move(ok));
+      EXPECT_EQ(-1, ok.fd());
+    }
+    // Released when the new owner is destroyed.
+    EXPECT_FALSE(File::Exists(fn)) << fn;
+  }
+  EXPECT_FALSE(File::Exists(fn)) << fn;
+}
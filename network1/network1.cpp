@@ -17,24 +17,32 @@
 /**************************************************************************/
 
 // WWIV5 Network1
+#include <algorithm>
 #include <cctype>
+#include <chrono>
 #include <cstdlib>
+#include <deque>
+#include <functional>
+#include <future>
 #include <iostream>
 #include <map>
 #include <memory>
 #include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "core/command_line.h"
 #include "core/file.h"
 #include "core/findfiles.h"
 #include "core/log.h"
+#include "core/metrics.h"
 #include "core/os.h"
 #include "core/semaphore_file.h"
 #include "core/scope_exit.h"
 #include "core/stl.h"
 #include "core/strings.h"
+#include "network1/network1.h"
 #include "networkb/net_util.h"
 #include "sdk/net/packets.h"
 
@@ -58,11 +66,9 @@ using namespace wwiv::sdk::net;
 using namespace wwiv::stl;
 using namespace wwiv::os;
 
-static void ShowHelp(const CommandLine& cmdline) {
-  cout << cmdline.GetHelp() << ".####      Network number (as defined in wwivconfig)" << endl
-       << endl;
-  exit(1);
-}
+namespace wwiv {
+namespace net {
+namespace network1 {
 
 static std::string wwivnet_packet_name(const net_networks_rec& net, uint16_t node) {
   return Packet::wwivnet_packet_name(net, node);
@@ -70,10 +76,10 @@ static std::string wwivnet_packet_name(const net_networks_rec& net, uint16_t nod
 
 /**
  * Determines the filename for each of the nodes in list to forward to
- * and writes packets (calling write_wwivnet_packet) to each of them.
+ * and writes packets (into the PacketBatch) for each of them.
  */
-static bool write_multiple_wwivnet_packets(const net_networks_rec& net,
-                                           const wwiv::sdk::BbsListNet b, const net_header_rec& nh,
+static bool write_multiple_wwivnet_packets(PacketBatch& batch, const net_networks_rec& net,
+                                           const wwiv::sdk::BbsListNet& b, const net_header_rec& nh,
                                            const std::vector<uint16_t>& list,
                                            const std::string& text) {
   std::map<uint16_t, std::set<uint16_t>> forsys_to_all;
@@ -93,78 +99,217 @@ static bool write_multiple_wwivnet_packets(const net_networks_rec& net,
       np.nh.list_len = 0;
       np.list.clear();
     }
-    if (!write_wwivnet_packet(Packet::wwivnet_packet_name(net, forsys), net, np)) {
+    if (!batch.Write(Packet::wwivnet_packet_name(net, forsys), np)) {
       result = false;
     }
   }
   return result;
 }
 
-static bool handle_packet(const BbsListNet& b, const net_networks_rec& net, Packet& p) {
-
-  // Update the routing information on this packet since
-  // we're unpacking it.
-  p.UpdateRouting(net);
-
+/** Writes p to its destinations. */
+static bool route_packet(PacketBatch& batch, const BbsListNet& b, const net_networks_rec& net,
+                         const PacketView& p) {
   if (p.nh.tosys == net.sysnum) {
     // Local Packet.
-    return write_wwivnet_packet(LOCAL_NET, net, p);
+    return batch.Write(LOCAL_NET, p);
   }
-  if (p.list.empty()) {
+  if (p.nh.list_len == 0) {
     // Network packet, single destination
-    return write_wwivnet_packet(Packet::wwivnet_packet_name(net, get_forsys(b, p.nh.tosys)), net,
-                                p);
+    return batch.Write(Packet::wwivnet_packet_name(net, get_forsys(b, p.nh.tosys)), p);
   }
   // Network packet, multiple destinations.
-  return write_multiple_wwivnet_packets(net, b, p.nh, p.list, p.text());
+  return write_multiple_wwivnet_packets(batch, net, b, p.nh, p.list(), p.ToPacket().text_);
+}
+
+static bool handle_packet(PacketBatch& batch, const BbsListNet& b, const net_networks_rec& net,
+                          const PacketView& v) {
+  if (!v.needs_routing_update()) {
+    // Nothing changes, so write it straight from the inbound file.
+    return route_packet(batch, b, net, v);
+  }
+  // Update the routing information on this packet since
+  // we're unpacking it. The routing line is spliced in as the packet
+  // is written, so the text is still written straight from the file.
+  auto p = v;
+  p.UpdateRouting(net);
+  return route_packet(batch, b, net, p);
 }
 
-static bool handle_file(const BbsListNet& b, const net_networks_rec& net, const string& name) {
-  File f(FilePath(net.dir, name));
-  if (!f.Open(File::modeBinary | File::modeReadOnly)) {
+static bool handle_file(PacketBatch& batch, const BbsListNet& b, const net_networks_rec& net,
+                        const string& name) {
+  PacketStream stream(FilePath(net.dir, name), false);
+  if (!stream.Open()) {
     LOG(INFO) << "Unable to open file: " << net.dir << name;
     return false;
   }
 
+  static auto& packets_read = Metrics::Global().counter("network1.packets_read");
+  static auto& bytes_read = Metrics::Global().counter("network1.bytes_read");
+  static auto& read_time = Metrics::Global().histogram("network1.read_packet");
+  static auto& handle_time = Metrics::Global().histogram("network1.handle_packet");
   for (;;) {
-    Packet packet;
-    const auto response = read_packet(f, packet, false);
+    PacketView packet;
+    ReadPacketResponse response;
+    {
+      ScopedTimer t(read_time);
+      response = stream.Next(packet);
+    }
     if (response == ReadPacketResponse::END_OF_FILE) {
       return true;
     }
     if (response == ReadPacketResponse::ERROR) {
       return false;
     }
-    if (!handle_packet(b, net, packet)) {
+    packets_read.Add();
+    bytes_read.Add(sizeof(net_header_rec) + packet.list_size() * sizeof(uint16_t) +
+                   packet.text().size());
+    ScopedTimer t(handle_time);
+    if (!handle_packet(batch, b, net, packet)) {
       LOG(INFO) << "error handing packet: type: " << packet.nh.main_type;
     }
   }
 }
 
+/** The packets routed from one pending file. */
+struct RoutedFile {
+  RoutedFile(const net_networks_rec& net, const string& n) : name(n), batch(net) {}
+  string name;
+  bool handled{false};
+  PacketBatch batch;
+};
+
+static RoutedFile route_file(const BbsListNet& b, const net_networks_rec& net,
+                             const string& name) {
+  LOG(INFO) << "Processing: " << net.dir << name;
+  RoutedFile r(net, name);
+  r.handled = handle_file(r.batch, b, net, name);
+  return r;
+}
+
+/** A pending file whose local packets are waiting to be handled. */
+struct TossingFile {
+  string name;
+  std::future<bool> tossed;
+};
+
+static void delete_pending_file(const NetworkCommandLine& net_cmdline, const string& name) {
+  const auto& net = net_cmdline.network();
+  LOG(INFO) << "Deleting: " << net.dir << name;
+  if (net_cmdline.skip_delete()) {
+    backup_file(FilePath(net.dir, name));
+  }
+  File::Remove(net.dir, name);
+}
+
+/**
+ * Appends the packets routed from r to the outbound packet files, and then
+ * deletes the pending file. Files are always committed in the order they
+ * were found so the order of packets in each outbound file doesn't depend
+ * on the number of threads.
+ *
+ * If local is not null, the local packets are pushed onto it instead, and
+ * the file is added to tossing to be deleted once they've been handled.
+ */
+static void commit_file(PacketWriterPool& pool, const NetworkCommandLine& net_cmdline,
+                        RoutedFile r, PacketQueue* local, std::deque<TossingFile>& tossing) {
+  static auto& packets_written = Metrics::Global().counter("network1.packets_written");
+  static auto& bytes_written = Metrics::Global().counter("network1.bytes_written");
+  static auto& write_time = Metrics::Global().histogram("network1.write");
+  const auto& net = net_cmdline.network();
+  packets_written.Add(r.batch.packets());
+  auto local_packets = local ? r.batch.Take(LOCAL_NET) : string();
+  bytes_written.Add(local_packets.size());
+  for (const auto& f : r.batch.files()) {
+    bytes_written.Add(f.second.size());
+  }
+  // Make sure everything routed from this file is on disk before
+  // the file is deleted.
+  {
+    ScopedTimer t(write_time);
+    if (!pool.Write(r.batch) || !pool.Flush()) {
+      LOG(ERROR) << "Unable to write packets from: " << net.dir << r.name;
+      return;
+    }
+  }
+  if (!local_packets.empty()) {
+    auto tossed = local->Push(r.name, std::move(local_packets));
+    if (r.handled) {
+      tossing.push_back(TossingFile{r.name, std::move(tossed)});
+    }
+    return;
+  }
+  if (r.handled) {
+    delete_pending_file(net_cmdline, r.name);
+  }
+}
+
+/** Deletes the pending files at the front of tossing once they're done. */
+static void delete_tossed_files(const NetworkCommandLine& net_cmdline,
+                                std::deque<TossingFile>& tossing, bool wait) {
+  while (!tossing.empty()) {
+    auto& t = tossing.front();
+    if (!wait && t.tossed.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+      return;
+    }
+    if (t.tossed.get()) {
+      delete_pending_file(net_cmdline, t.name);
+    } else {
+      LOG(ERROR) << "Local packets from " << t.name << " were not handled; keeping it.";
+    }
+    tossing.pop_front();
+  }
+}
+
 int network1_main(const NetworkCommandLine& net_cmdline) {
   try {
     const auto& net = net_cmdline.network();
 
     VLOG(1) << "Reading bbsdata.net..";
     BbsListNet b = BbsListNet::ReadBbsDataNet(net.dir);
+    return network1_main(net_cmdline, b, nullptr);
+  } catch (const std::exception& e) {
+    LOG(ERROR) << "ERROR: [network1]: " << e.what();
+  }
+  return 2;
+}
+
+int network1_main(const NetworkCommandLine& net_cmdline, const BbsListNet& b,
+                  PacketQueue* local) {
+  try {
+    const auto& net = net_cmdline.network();
     if (b.empty()) {
       LOG(ERROR) << "ERROR: Unable to read bbsdata.net.";
       LOG(ERROR) << "       Do you need to run network3?";
       return 1;
     }
 
+    const auto num_threads = std::max(1, net_cmdline.cmdline().iarg("threads"));
     LOG(INFO) << " * Analyzing " << net.name << " pending files...";
+    // Buffers the packets for each outbound packet file.
+    PacketWriterPool pool(net);
     FindFiles ff(net.dir, "p*.net", FindFilesType::files);
+    // Files being routed on worker threads, in the order they were found.
+    std::deque<std::future<RoutedFile>> routing;
+    // Files whose local packets are being handled by whoever reads local.
+    std::deque<TossingFile> tossing;
     for (const auto& f : ff) {
-      LOG(INFO) << "Processing: " << net.dir << f.name;
-      if (handle_file(b, net, f.name)) {
-        LOG(INFO) << "Deleting: " << net.dir << f.name;
-        if (net_cmdline.skip_delete()) {
-          backup_file(FilePath(net.dir,f.name));
+      if (num_threads == 1) {
+        commit_file(pool, net_cmdline, route_file(b, net, f.name), local, tossing);
+      } else {
+        if (size_int(routing) >= num_threads) {
+          commit_file(pool, net_cmdline, routing.front().get(), local, tossing);
+          routing.pop_front();
         }
-        File::Remove(net.dir, f.name);
+        routing.push_back(std::async(std::launch::async, route_file, std::cref(b),
+                                     std::cref(net), f.name));
       }
+      delete_tossed_files(net_cmdline, tossing, false);
     }
+    for (auto& r : routing) {
+      commit_file(pool, net_cmdline, r.get(), local, tossing);
+    }
+    pool.Close();
+    delete_tossed_files(net_cmdline, tossing, true);
 
     // Update contact record.
     Contact contact(net, true);
@@ -185,22 +330,6 @@ int network1_main(const NetworkCommandLine& net_cmdline) {
   return 2;
 }
 
-int main(int argc, char** argv) { 
-  Logger::Init(argc, argv);
-  ScopeExit at_exit(Logger::ExitLogger);
-  CommandLine cmdline(argc, argv, "net");
-  NetworkCommandLine net_cmdline(cmdline, '1');
-  if (!net_cmdline.IsInitialized() || net_cmdline.cmdline().help_requested()) {
-    ShowHelp(net_cmdline.cmdline());
-    return 1;
-  }
-
-  try {
-    auto semaphore = SemaphoreFile::try_acquire(net_cmdline.semaphore_filename(),
-                                                net_cmdline.semaphore_timeout());
-    return network1_main(net_cmdline);
-  } catch (const semaphore_not_acquired& e) {
-    LOG(ERROR) << "ERROR: [network" << net_cmdline.net_cmd()
-               << "]: Unable to Acquire Network Semaphore: " << e.what();
-  }
-}
\ No newline at end of file
+} // namespace network1
+} // namespace net
+} // namespace wwiv
@@ -0,0 +1,49 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef __INCLUDED_NETWORK1_NETWORK1_H__
+#define __INCLUDED_NETWORK1_NETWORK1_H__
+
+#include "networkb/net_util.h"
+#include "sdk/bbslist.h"
+#include "sdk/net/packets.h"
+
+namespace wwiv {
+namespace net {
+namespace network1 {
+
+/**
+ * Routes the pending packet files (p*.net) into the outbound packet files
+ * (s<forsys>.net) using bbsdata.net.
+ */
+int network1_main(const NetworkCommandLine& net_cmdline);
+
+/**
+ * Routes the pending packet files using b.
+ *
+ * If local is not null, the local packets from each pending file are pushed
+ * onto it instead of being written to local.net, and the pending file is
+ * only deleted once they have been handled.
+ */
+int network1_main(const NetworkCommandLine& net_cmdline, const wwiv::sdk::BbsListNet& b,
+                  wwiv::sdk::net::PacketQueue* local);
+
+} // namespace network1
+} // namespace net
+} // namespace wwiv
+
+#endif // __INCLUDED_NETWORK1_NETWORK1_H__
@@ -0,0 +1,73 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "network2/context.h"
+
+#include <string>
+
+#include "core/log.h"
+#include "core/strings.h"
+#include "sdk/user.h"
+
+using std::string;
+using namespace wwiv::sdk;
+using namespace wwiv::strings;
+
+namespace wwiv {
+namespace net {
+namespace network2 {
+
+int Context::FindSubNumber(const string& subtype) {
+  if (!sub_numbers_loaded_) {
+    sub_numbers_loaded_ = true;
+    int current = 0;
+    for (const auto& x : subs.subs()) {
+      for (const auto& n : x.nets) {
+        if (n.net_num == network_number) {
+          // Like the scan this replaced, the first sub with the subtype wins.
+          sub_numbers_.emplace(ToStringUpperCase(n.stype), current);
+        }
+      }
+      ++current;
+    }
+    VLOG(1) << "Indexed " << sub_numbers_.size() << " subtypes.";
+  }
+  auto it = sub_numbers_.find(ToStringUpperCase(subtype));
+  return it == sub_numbers_.end() ? -1 : it->second;
+}
+
+int Context::FindUserNumber(const string& name) {
+  if (!user_numbers_loaded_) {
+    user_numbers_loaded_ = true;
+    auto max = user_manager.num_user_records();
+    for (int i = 0; i <= max; i++) {
+      User u;
+      if (!user_manager.readuser_nocache(&u, i)) {
+        continue;
+      }
+      // Like the scan this replaced, the lowest user number wins.
+      user_numbers_.emplace(ToStringUpperCase(u.GetName()), i);
+    }
+    VLOG(1) << "Indexed " << user_numbers_.size() << " user names.";
+  }
+  auto it = user_numbers_.find(ToStringUpperCase(name));
+  return it == user_numbers_.end() ? 0 : it->second;
+}
+
+} // namespace network2
+} // namespace net
+} // namespace wwiv
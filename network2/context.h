@@ -22,16 +22,27 @@
 #include "sdk/msgapi/message_api_wwiv.h"
 #include "sdk/msgapi/msgapi.h"
 #include "sdk/net.h"
+#include "sdk/net/packets.h"
 #include "sdk/networks.h"
 #include "sdk/subxtr.h"
 #include "sdk/usermanager.h"
 #include "sdk/vardec.h"
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace wwiv {
 namespace net {
 namespace network2 {
 
+/** A post received in this run that hasn't been added to its sub yet. */
+struct PendingPost {
+  // Index of the sub in Context::subs.
+  int sub_number;
+  wwiv::sdk::net::Packet packet;
+  wwiv::sdk::net::ParsedPacketText ppt;
+};
+
 class Context {
 public:
   Context(const wwiv::sdk::Config& c, const net_networks_rec& n, wwiv::sdk::UserManager& u,
@@ -51,6 +62,17 @@ public:
 
   const std::vector<net_networks_rec>& networks() const noexcept { return networks_; }
 
+  /**
+   * Returns the index in subs of the sub carrying subtype on this network,
+   * or -1 if there is none. The index is built once per run.
+   */
+  int FindSubNumber(const std::string& subtype);
+  /**
+   * Returns the number of the user named name, or 0 if there is none. The
+   * user list is only read once per run.
+   */
+  int FindUserNumber(const std::string& name);
+
   const wwiv::sdk::Config& config;
   const net_networks_rec& net;
   wwiv::sdk::UserManager& user_manager;
@@ -63,6 +85,18 @@ public:
   const std::vector<net_networks_rec> networks_;
   bool verbose = false;
   bool subs_initialized = false;
+  // Posts to add to their subs by flush_inbound_posts, in the order received.
+  std::vector<PendingPost> pending_posts;
+  // Sends posts on to the subscribers of our subs, flushed by flush_inbound_posts.
+  wwiv::sdk::net::SubscriberFanout fanout{networks_, '2'};
+
+private:
+  // Upper case subtype to index in subs.
+  std::unordered_map<std::string, int> sub_numbers_;
+  bool sub_numbers_loaded_ = false;
+  // Upper case user name to user number.
+  std::unordered_map<std::string, int> user_numbers_;
+  bool user_numbers_loaded_ = false;
 };
 
 } // namespace network2
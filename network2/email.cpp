@@ -82,21 +82,6 @@ namespace wwiv {
 namespace net {
 namespace network2 {
 
-// Gets the user number or 0 if it is not found.
-static int GetUserNumber(const std::string name, UserManager& um) {
-  auto max = um.num_user_records();
-  for (int i = 0; i <= max; i++) {
-    User u;
-    if (!um.readuser_nocache(&u, i)) {
-      continue;
-    }
-    if (iequals(name.c_str(), u.GetName())) {
-      return i;
-    }
-  }
-  return 0;
-}
-
 bool handle_email_byname(Context& context, Packet& p) {
   VLOG(1) << "Processing email by name.";
 
@@ -105,7 +90,7 @@ bool handle_email_byname(Context& context, Packet& p) {
   // Rest of the message is the text.
   const string text = string(iter, std::end(p.text()));
 
-  auto user_number = GetUserNumber(to_name, context.user_manager);
+  auto user_number = context.FindUserNumber(to_name);
   if (user_number == 0) {
     // Not found.
     LOG(ERROR) << "    ! ERROR Received email to user: '" << to_name << "' who is not found on this system; writing to dead.net";
@@ -34,6 +34,7 @@
 #include "core/datafile.h"
 #include "core/file.h"
 #include "core/log.h"
+#include "core/metrics.h"
 #include "core/semaphore_file.h"
 #include "core/scope_exit.h"
 #include "core/stl.h"
@@ -46,6 +47,7 @@
 #include "networkb/ppp_config.h"
 #include "network2/context.h"
 #include "network2/email.h"
+#include "network2/network2.h"
 #include "network2/post.h"
 #include "network2/subs.h"
 
@@ -84,6 +86,10 @@ using namespace wwiv::sdk::net;
 using namespace wwiv::stl;
 using namespace wwiv::strings;
 
+namespace wwiv {
+namespace net {
+namespace network2 {
+
 static bool email_changed = false;
 static bool posts_changed = false;
 
@@ -103,13 +109,6 @@ static void update_filechange_status_dat(const string& datadir, bool email, bool
   }
 }
 
-static void ShowHelp(const CommandLine& cmdline) {
-  cout << cmdline.GetHelp()
-       << ".####      Network number (as defined in wwivconfig)" << endl
-       << endl;
-  exit(1);
-}
-
 static bool handle_ssm(Context& context, Packet& p) {
   ScopeExit at_exit([] {
     VLOG(1) << "==============================================================";
@@ -210,11 +209,9 @@ static bool handle_packet(
   case main_type_new_post:
   {
     posts_changed = true;
-    if (!handle_inbound_post(context, p)) {
-      LOG(ERROR) << "Error on handle_inbound_post";
-      return false;
-    }
-    return send_post_to_subscribers(context, p, {p.nh.fromsys});
+    // This is sent on to the subscribers once it's been posted, see
+    // flush_inbound_posts.
+    return handle_inbound_post(context, p);
   } break;
   case main_type_ssm:
   {
@@ -266,23 +263,36 @@ static bool handle_packet(
   }
 }
 
-static bool handle_file(Context& context, const string& name) {
-  File f(FilePath(context.net.dir, name));
-  if (!f.Open(File::modeBinary | File::modeReadOnly)) {
-    LOG(ERROR) << "Unable to open file: " << context.net.dir << name;
-    return false;
-  }
-
+static bool handle_stream(Context& context, PacketStream& stream) {
+  static auto& packets_read = Metrics::Global().counter("network2.packets_read");
+  static auto& bytes_read = Metrics::Global().counter("network2.bytes_read");
+  static auto& read_time = Metrics::Global().histogram("network2.read_packet");
+  static auto& handle_time = Metrics::Global().histogram("network2.handle_packet");
   bool done = false;
   while (!done) {
-    Packet packet;
-    ReadPacketResponse response = read_packet(f, packet, true);
+    PacketView view;
+    ReadPacketResponse response;
+    {
+      ScopedTimer t(read_time);
+      response = stream.Next(view);
+    }
     if (response == ReadPacketResponse::END_OF_FILE) {
+      if (!flush_inbound_posts(context)) {
+        LOG(ERROR) << "Error sending posts to subscribers.";
+      }
       return true;
     } else if (response == ReadPacketResponse::ERROR) {
+      // Keep the posts already read, the packets aren't deleted so they'll
+      // show up as duplicates next time.
+      flush_inbound_posts(context);
       return false;
     }
 
+    packets_read.Add();
+    bytes_read.Add(sizeof(net_header_rec) + view.list_size() * sizeof(uint16_t) +
+                   view.text().size());
+    ScopedTimer t(handle_time);
+    auto packet = view.ToPacket();
     if (!handle_packet(context, packet)) {
       LOG(ERROR) << "Error handing packet: type: " << packet.nh.main_type;
     }
@@ -290,10 +300,64 @@ static bool handle_file(Context& context, const string& name) {
   return true;
 }
 
+static bool handle_file(Context& context, const string& name) {
+  PacketStream stream(FilePath(context.net.dir, name), true);
+  if (!stream.Open()) {
+    LOG(ERROR) << "Unable to open file: " << context.net.dir << name;
+    return false;
+  }
+  return handle_stream(context, stream);
+}
+
+static bool append_to_local_net(const net_networks_rec& net, const string& packets) {
+  File file(FilePath(net.dir, LOCAL_NET));
+  if (!file.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile)) {
+    return false;
+  }
+  file.Seek(0L, File::Whence::end);
+  return file.Write(packets) == static_cast<ssize_t>(packets.size());
+}
+
+/**
+ * Tosses the packets pushed onto local until it's closed. Packets that
+ * can't be tossed are appended to local.net, so they are kept like a
+ * local.net that can't be tossed.
+ */
+static void handle_queue(Context& context, PacketQueue& local) {
+  PacketQueue::Item item;
+  while (local.Pop(item)) {
+    LOG(INFO) << "Processing: local packets from " << context.net.dir << item.name;
+    auto tossed = false;
+    try {
+      PacketStream stream(std::string_view(item.packets), true);
+      tossed = stream.Open() && handle_stream(context, stream);
+    } catch (const std::exception& e) {
+      LOG(ERROR) << "ERROR: [network2]: " << e.what();
+    }
+    if (!tossed) {
+      LOG(ERROR) << "ERROR: Unable to toss local packets from " << item.name
+                 << "; appending them to " << LOCAL_NET;
+      tossed = append_to_local_net(context.net, item.packets);
+    }
+    item.done.set_value(tossed);
+  }
+}
+
 int network2_main(const NetworkCommandLine& net_cmdline) {
+  return network2_main(net_cmdline, nullptr);
+}
+
+int network2_main(const NetworkCommandLine& net_cmdline, PacketQueue* local) {
+  // Never leave whoever is pushing onto local waiting on us.
+  ScopeExit drain([local] {
+    PacketQueue::Item item;
+    while (local != nullptr && local->Pop(item)) {
+      item.done.set_value(false);
+    }
+  });
   try {
     const auto& net = net_cmdline.network();
-    if (!File::Exists(net.dir, LOCAL_NET)) {
+    if (local == nullptr && !File::Exists(net.dir, LOCAL_NET)) {
       LOG(INFO) << "No local.net exists. exiting.";
       return 0;
     }
@@ -318,6 +382,15 @@ int network2_main(const NetworkCommandLine& net_cmdline) {
     context.set_email_api(email_api.get());
     context.set_api(2, std::move(type2_api));
 
+    if (local != nullptr) {
+      handle_queue(context, *local);
+      if (!File::Exists(net.dir, LOCAL_NET)) {
+        update_filechange_status_dat(context.config.datadir(), email_changed, posts_changed);
+        return 0;
+      }
+    }
+    // When tossing a queue, local.net is done last so that none of the pending
+    // files written while tossing it are ones network1 is still routing.
     LOG(INFO) << "Processing: " << net.dir << LOCAL_NET;
     if (handle_file(context, LOCAL_NET)) {
       if (net_cmdline.skip_delete()) {
@@ -340,22 +413,6 @@ int network2_main(const NetworkCommandLine& net_cmdline) {
   return 255;
 }
 
-int main(int argc, char** argv) {
-  Logger::Init(argc, argv);
-  ScopeExit at_exit(Logger::ExitLogger);
-  CommandLine cmdline(argc, argv, "net");
-  NetworkCommandLine net_cmdline(cmdline, '2');
-  if (!net_cmdline.IsInitialized() || net_cmdline.cmdline().help_requested()) {
-    ShowHelp(net_cmdline.cmdline());
-    return 1;
-  }
-
-  try {
-    auto semaphore = SemaphoreFile::try_acquire(net_cmdline.semaphore_filename(),
-                                                net_cmdline.semaphore_timeout());
-    return network2_main(net_cmdline);
-  } catch (const semaphore_not_acquired& e) {
-    LOG(ERROR) << "ERROR: [network" << net_cmdline.net_cmd()
-               << "]: Unable to Acquire Network Semaphore: " << e.what();
-  }
-}
\ No newline at end of file
+} // namespace network2
+} // namespace net
+} // namespace wwiv
@@ -0,0 +1,42 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef __INCLUDED_NETWORK2_NETWORK2_H__
+#define __INCLUDED_NETWORK2_NETWORK2_H__
+
+#include "networkb/net_util.h"
+#include "sdk/net/packets.h"
+
+namespace wwiv {
+namespace net {
+namespace network2 {
+
+/** Tosses the packets in local.net into the message bases, email, etc. */
+int network2_main(const NetworkCommandLine& net_cmdline);
+
+/**
+ * Like network2_main, but if local is not null, first tosses the packets
+ * pushed onto it until it is closed. Anything that can't be tossed from
+ * the queue is appended to local.net.
+ */
+int network2_main(const NetworkCommandLine& net_cmdline, wwiv::sdk::net::PacketQueue* local);
+
+} // namespace network2
+} // namespace net
+} // namespace wwiv
+
+#endif // __INCLUDED_NETWORK2_NETWORK2_H__
@@ -28,12 +28,14 @@
 #include <set>
 #include <sstream>
 #include <string>
+#include <tuple>
 #include <vector>
 
 #include "core/command_line.h"
 #include "core/connection.h"
 #include "core/file.h"
 #include "core/log.h"
+#include "core/metrics.h"
 #include "core/os.h"
 #include "core/scope_exit.h"
 #include "core/stl.h"
@@ -81,22 +83,15 @@ namespace wwiv {
 namespace net {
 namespace network2 {
 
-static bool find_sub(const Subs& subs, int network_number, const string& netname, subboard_t& sub) {
-  int current = 0;
-  for (const auto& x : subs.subs()) {
-    for (const auto& n : x.nets) {
-      if (n.net_num == network_number) {
-        if (iequals(netname, n.stype)) {
-          // Since the subtype matches, we need to find the subboard base filename.
-          // and return that.
-          sub = subs.sub(current);
-          return true;
-        }
-      }
-    }
-    ++current;
+static bool find_sub(Context& context, const string& netname, subboard_t& sub) {
+  auto sub_number = context.FindSubNumber(netname);
+  if (sub_number < 0) {
+    return false;
   }
-  return false;
+  // Since the subtype matches, we need to find the subboard base filename.
+  // and return that.
+  sub = context.subs.sub(sub_number);
+  return true;
 }
 
 // Alpha subtypes are seven characters -- the first must be a letter, but the rest can be any
@@ -106,73 +101,151 @@ static bool find_sub(const Subs& subs, int network_number, const string& netname
 // header info at the beginning of the message text is in the format
 // SUBTYPE<nul>TITLE<nul>SENDER_NAME<cr / lf>DATE_STRING<cr / lf>MESSAGE_TEXT.
 bool handle_inbound_post(Context& context, Packet& p) {
-
-  ScopeExit at_exit;
-
   auto ppt = ParsedPacketText::FromPacket(p);
-  if (VLOG_IS_ON(1)) {
-    at_exit.swap(
-        [] { LOG(INFO) << "=============================================================="; });
-    VLOG(1) << "==============================================================";
-    VLOG(1) << "  Processing New Post on subtype: " << ppt.subtype();
-    VLOG(1) << "  Title:   " << ppt.title();
-    VLOG(1) << "  Sender:  " << ppt.sender();
-    VLOG(1) << "  Date:    " << ppt.date();
-  }
+  VLOG(1) << "  Received New Post on subtype: " << ppt.subtype() << "; title: " << ppt.title();
 
-  subboard_t sub;
-  if (!find_sub(context.subs, context.network_number, ppt.subtype(), sub)) {
+  auto sub_number = context.FindSubNumber(ppt.subtype());
+  if (sub_number < 0) {
     LOG(INFO) << "    ! ERROR: Unable to find message of subtype: " << ppt.subtype();
     LOG(INFO) << "      title: " << ppt.title() << "; writing to dead.net.";
     return write_wwivnet_packet(DEAD_NET, context.net, p);
   }
+  context.pending_posts.push_back(PendingPost{sub_number, p, std::move(ppt)});
+  return true;
+}
+
+// Adds the posts in pending (all for the sub sub_number) to the sub.
+// Duplicates and posts written to dead.net are still sent on to the other
+// subscribers, like they always have been. Sets forward[i] to false for
+// each post that could not even be written to dead.net.
+static void add_posts_to_sub(Context& context, int sub_number,
+                             const vector<const PendingPost*>& pending, vector<bool>& forward) {
+  const auto sub = context.subs.sub(sub_number);
+  auto dead = [&](const string& message) {
+    LOG(INFO) << message << "; writing " << pending.size() << " post(s) to dead.net.";
+    for (size_t i = 0; i < pending.size(); i++) {
+      forward[i] = write_wwivnet_packet(DEAD_NET, context.net, pending[i]->packet);
+    }
+  };
 
   if (!context.api(sub.storage_type).Exist(sub)) {
     LOG(INFO) << "WARNING Message area: '" << sub.filename << "' does not exist.";
-    ;
     LOG(INFO) << "WARNING Attempting to create it.";
     // Since the area does not exist, let's create it automatically
     // like WWIV always does.
     auto created = context.api(sub.storage_type).Create(sub, -1);
     if (!created) {
-      LOG(INFO) << "    ! ERROR: Failed to create message area: '" << sub.filename
-                << "'; writing to dead.net.";
-      return write_wwivnet_packet(DEAD_NET, context.net, p);
+      dead(StrCat("    ! ERROR: Failed to create message area: '", sub.filename, "'"));
+      return;
     }
   }
 
   unique_ptr<MessageArea> area(context.api(sub.storage_type).Open(sub, -1));
   if (!area) {
-    LOG(INFO) << "    ! ERROR Unable to open message area: '" << sub.filename
-              << "'; writing to dead.net.";
-    return write_wwivnet_packet(DEAD_NET, context.net, p);
+    dead(StrCat("    ! ERROR Unable to open message area: '", sub.filename, "'"));
+    return;
   }
 
-  if (area->Exists(p.nh.daten, ppt.title(), p.nh.fromsys, p.nh.fromuser)) {
-    LOG(INFO) << "    - Discarding Duplicate Message on sub: " << ppt.subtype()
-              << "; title: " << ppt.title() << ".";
-    // Returning true since we properly handled this by discarding it.
-    return true;
-  }
+  // Duplicates within this run aren't in the area yet, so keep track of
+  // them here using the same fields as MessageArea::Exists.
+  set<std::tuple<daten_t, string, uint16_t, uint16_t>> added;
+  vector<unique_ptr<Message>> messages;
+  vector<size_t> message_post;
+  for (size_t i = 0; i < pending.size(); i++) {
+    const auto& p = pending[i]->packet;
+    const auto& ppt = pending[i]->ppt;
+    // TODO(rushfan): Should we let CreateMessage accept the packet directly
+    // then we could also check the main_type to ensure it's fine.
+    auto msg = area->CreateMessage();
+    msg->header().set_from_system(p.nh.fromsys);
+    msg->header().set_from_usernum(p.nh.fromuser);
+    msg->header().set_title(ppt.title());
+    msg->header().set_from(ppt.sender());
+    msg->header().set_daten(p.nh.daten);
+    msg->text().set_text(ppt.text());
 
-  // TODO(rushfan): Should we let CreateMessage accept the packet directly
-  // then we could also check the main_type to ensure it's fine.
-  auto msg = area->CreateMessage();
-  msg->header().set_from_system(p.nh.fromsys);
-  msg->header().set_from_usernum(p.nh.fromuser);
-  msg->header().set_title(ppt.title());
-  msg->header().set_from(ppt.sender());
-  msg->header().set_daten(p.nh.daten);
-  msg->text().set_text(ppt.text());
+    auto key = std::make_tuple(p.nh.daten, ToStringUpperCase(msg->header().title()),
+                               p.nh.fromsys, p.nh.fromuser);
+    if (area->Exists(p.nh.daten, ppt.title(), p.nh.fromsys, p.nh.fromuser) ||
+        !added.insert(key).second) {
+      LOG(INFO) << "    - Discarding Duplicate Message on sub: " << ppt.subtype()
+                << "; title: " << ppt.title() << ".";
+      // This was properly handled by discarding it.
+      continue;
+    }
+    messages.push_back(std::move(msg));
+    message_post.push_back(i);
+  }
+  if (messages.empty()) {
+    return;
+  }
 
+  vector<const Message*> to_add;
+  for (const auto& m : messages) {
+    to_add.push_back(m.get());
+  }
   MessageAreaOptions options{};
   options.send_post_to_network = false;
-  if (!area->AddMessage(*msg, options)) {
-    LOG(ERROR) << "    ! ERROR Failed to add message: '" << ppt.title() << "'; writing to dead.net";
-    return write_wwivnet_packet(DEAD_NET, context.net, p);
+  if (!area->AddMessages(to_add, options)) {
+    LOG(ERROR) << "    ! ERROR Failed to add " << to_add.size() << " message(s) to sub: '"
+               << sub.filename << "'; writing to dead.net";
+    for (auto i : message_post) {
+      forward[i] = write_wwivnet_packet(DEAD_NET, context.net, pending[i]->packet);
+    }
+    return;
   }
-  LOG(INFO) << "    + Posted  '" << ppt.title() << "' on sub: '" << ppt.subtype() << "'.";
-  return true;
+  for (auto i : message_post) {
+    LOG(INFO) << "    + Posted  '" << pending[i]->ppt.title() << "' on sub: '"
+              << pending[i]->ppt.subtype() << "'.";
+  }
+  Metrics::Global().counter(StrCat("network2.posts_tossed.", sub.filename)).Add(to_add.size());
+}
+
+bool flush_inbound_posts(Context& context) {
+  if (context.pending_posts.empty()) {
+    return true;
+  }
+  LOG(INFO) << "Adding " << context.pending_posts.size() << " post(s) to the message areas.";
+  ScopeExit at_exit([&] { context.pending_posts.clear(); });
+  static auto& write_time = Metrics::Global().histogram("network2.write");
+  ScopedTimer t(write_time);
+
+  // Group the posts by sub so each sub is opened and written once.
+  map<int, vector<size_t>> by_sub;
+  for (size_t i = 0; i < context.pending_posts.size(); i++) {
+    by_sub[context.pending_posts[i].sub_number].push_back(i);
+  }
+
+  vector<bool> forward(context.pending_posts.size(), true);
+  for (const auto& e : by_sub) {
+    vector<const PendingPost*> pending;
+    for (auto i : e.second) {
+      pending.push_back(&context.pending_posts[i]);
+    }
+    vector<bool> sub_forward(pending.size(), true);
+    add_posts_to_sub(context, e.first, pending, sub_forward);
+    for (size_t n = 0; n < e.second.size(); n++) {
+      forward[e.second[n]] = sub_forward[n];
+    }
+  }
+
+  // Send the posts on to the other subscribers in the order they were received.
+  auto result = true;
+  for (size_t i = 0; i < context.pending_posts.size(); i++) {
+    if (!forward[i]) {
+      LOG(ERROR) << "Error on handle_inbound_post";
+      result = false;
+      continue;
+    }
+    auto& p = context.pending_posts[i].packet;
+    if (!send_post_to_subscribers(context, p, {p.nh.fromsys})) {
+      result = false;
+    }
+  }
+  if (!context.fanout.Flush()) {
+    result = false;
+  }
+  return result;
 }
 
 std::string set_to_string(set<uint16_t> lines) {
@@ -203,7 +276,7 @@ bool send_post_to_subscribers(Context& context, Packet& template_packet,
   }
 
   subboard_t sub;
-  if (!find_sub(context.subs, context.network_number, original_subtype, sub)) {
+  if (!find_sub(context, original_subtype, sub)) {
     LOG(INFO) << "    ! ERROR: Unable to find message of subtype: '" << original_subtype
               << "'; writing to dead.net.";
     Packet p(template_packet.nh, {}, template_packet.text());
@@ -211,9 +284,8 @@ bool send_post_to_subscribers(Context& context, Packet& template_packet,
   }
   VLOG(1) << "DEBUG: Found sub: " << sub.name;
 
-  return send_post_to_subscribers(context.networks(), context.network_number, original_subtype, sub,
-                                  template_packet, subscribers_to_skip,
-                                  subscribers_send_to_t::hosted_and_gated_only);
+  return context.fanout.Send(context.network_number, original_subtype, sub, template_packet,
+                             subscribers_to_skip, subscribers_send_to_t::hosted_and_gated_only);
 }
 
 } // namespace network2
@@ -36,10 +36,17 @@ namespace net {
 namespace network2 {
 
 /**
- * Handles receiving a Packet with a post and writing it to the
- * local database.
+ * Handles receiving a Packet with a post. The post is queued in
+ * context.pending_posts and written to the local database by
+ * flush_inbound_posts.
  */
 bool handle_inbound_post(Context& context, wwiv::sdk::net::Packet& packet);
+/**
+ * Adds all of the queued posts to their subs, opening each sub once, and
+ * then sends them on to the other subscribers. Duplicates and posts that
+ * were written to dead.net are sent on too.
+ */
+bool flush_inbound_posts(Context& context);
 /**
  * Send a network post out to the other subscribers when you are the host off
  * a sub or gating a sub.
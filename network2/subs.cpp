@@ -235,6 +235,7 @@ bool handle_sub_add_req(Context& context, Packet& p) {
     LOG(INFO) << "Unable to write subscribers file.";
     return resp(sub_adddrop_error);
   }
+  context.fanout.Reload();
 
   // success!
   LOG(INFO) << "Added system @" << p.nh.fromsys << " to subtype: " << subtype;
@@ -266,6 +267,7 @@ bool handle_sub_drop_req(Context& context, Packet& p) {
     LOG(INFO) << "Unable to write subscribers file.";
     return resp(sub_adddrop_error);
   }
+  context.fanout.Reload();
 
   // success!
   LOG(INFO) << "Dropped system @" << p.nh.fromsys << " to subtype: " << subtype;
@@ -32,6 +32,7 @@
 #include "core/datafile.h"
 #include "core/file.h"
 #include "core/log.h"
+#include "core/metrics.h"
 #include "core/scope_exit.h"
 #include "core/semaphore_file.h"
 #include "core/stl.h"
@@ -356,6 +357,21 @@ static void write_bbsdata_files(const vector<net_system_list_rec>& bbsdata_data,
   }
 }
 
+static void write_bbsdata_rte_file(const BbsListNet& b, const net_networks_rec& net) {
+  {
+    BbsRoutingTable table(net.dir);
+    if (table.Open() && table.header().source_crc == b.source_crc() &&
+        table.IsCurrentFor(net.dir)) {
+      LOG(INFO) << "bbsdata.rte is up to date.";
+      return;
+    }
+  }
+  LOG(INFO) << "Writing bbsdata.rte...";
+  if (!BbsRoutingTable::Write(net.dir, net.sysnum, b.source_crc(), b)) {
+    LOG(ERROR) << "Unable to write bbsdata.rte";
+  }
+}
+
 static void update_net_ver_status_dat(const string& datadir) {
   statusrec_t statusrec{};
   DataFile<statusrec_t> file(FilePath(datadir, STATUS_DAT), File::modeBinary | File::modeReadWrite);
@@ -542,11 +558,16 @@ static int network3_fido(const NetworkCommandLine& net_cmdline) {
 static int network3_wwivnet(const NetworkCommandLine& net_cmdline) {
   VLOG(1) << "Reading bbslist.net..";
   const auto& net = net_cmdline.network();
-  BbsListNet b = BbsListNet::ParseBbsListNet(net.sysnum, net.dir);
+  auto& metrics = Metrics::Global();
+  BbsListNet b = [&] {
+    ScopedTimer t(metrics.histogram("network3.parse_bbslist"));
+    return BbsListNet::ParseBbsListNet(net.sysnum, net.dir);
+  }();
   if (b.empty()) {
     LOG(ERROR) << "ERROR: bbslist.net didn't parse.";
     return 1;
   }
+  metrics.gauge("network3.systems").Set(b.node_config().size());
 
   auto nc = get_network_cordinator(b);
   bool is_nc = (net.sysnum == nc);
@@ -558,8 +579,12 @@ static int network3_wwivnet(const NetworkCommandLine& net_cmdline) {
     bbsdata_data.push_back(n);
   }
 
-  write_bbsdata_files(bbsdata_data, net.dir);
-  write_bbsdata_reg_file(b, net.dir);
+  {
+    ScopedTimer t(metrics.histogram("network3.write"));
+    write_bbsdata_files(bbsdata_data, net.dir);
+    write_bbsdata_reg_file(b, net.dir);
+    write_bbsdata_rte_file(b, net);
+  }
 
   VLOG(1) << "Reading callout.net...";
   Callout callout(net);
@@ -623,6 +648,7 @@ int main(int argc, char** argv) {
   try {
     auto semaphore = SemaphoreFile::try_acquire(net_cmdline.semaphore_filename(),
                                                 net_cmdline.semaphore_timeout());
+    ScopeExit write_metrics([&net_cmdline] { net_cmdline.WriteMetrics(); });
     return network3_main(net_cmdline);
   } catch (const semaphore_not_acquired& e) {
     LOG(ERROR) << "ERROR: [network" << net_cmdline.net_cmd()
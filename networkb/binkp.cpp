@@ -32,6 +32,7 @@
 #include "core/crc32.h"
 #include "core/file.h"
 #include "core/log.h"
+#include "core/metrics.h"
 #include "core/stl.h"
 #include "core/strings.h"
 #include "core/os.h"
@@ -296,6 +297,8 @@ bool BinkP::process_frames(duration<double> d) {
 }
 
 bool BinkP::process_frames(function<bool()> predicate, duration<double> d) {
+  static auto& frames_received = Metrics::Global().counter("binkp.frames_received");
+  static auto& bytes_received = Metrics::Global().counter("binkp.bytes_received");
   if (!conn_->is_open()) {
     return false;
   }
@@ -303,6 +306,8 @@ bool BinkP::process_frames(function<bool()> predicate, duration<double> d) {
     while (!predicate()) {
       VLOG(3) << "       process_frames(pred)";
       uint16_t header = conn_->read_uint16(d);
+      frames_received.Add();
+      bytes_received.Add(sizeof(uint16_t) + (header & 0x7fff));
       if (header & 0x8000) {
         if (!process_command(header & 0x7fff, d)) {
           // false return value means an error occurred.
@@ -324,6 +329,13 @@ bool BinkP::process_frames(function<bool()> predicate, duration<double> d) {
   return true;
 }
 
+static void count_frame_sent(std::size_t size) {
+  static auto& frames_sent = Metrics::Global().counter("binkp.frames_sent");
+  static auto& bytes_sent = Metrics::Global().counter("binkp.bytes_sent");
+  frames_sent.Add();
+  bytes_sent.Add(size);
+}
+
 bool BinkP::send_command_packet(uint8_t command_id, const string& data) {
   if (!conn_->is_open()) {
     return false;
@@ -343,6 +355,7 @@ bool BinkP::send_command_packet(uint8_t command_id, const string& data) {
   memcpy(p, data.data(), data.size());
 
   conn_->send(packet.get(), size, seconds(3));
+  count_frame_sent(size);
   if (command_id != BinkpCommands::M_PWD) {
     LOG(INFO) << "SEND:  " << BinkpCommands::command_id_to_name(command_id)
          << ": " << data;
@@ -369,6 +382,7 @@ bool BinkP::send_data_packet(const char* data, std::size_t packet_length) {
   memcpy(p, data, packet_length);
 
   conn_->send(packet.get(), packet_length + 2, seconds(10));
+  count_frame_sent(packet_length + 2);
   VLOG(3) << "SEND:  data packet: packet_length: " << (int) packet_length;
   return true;
 }
@@ -861,6 +875,9 @@ void BinkP::Run(const wwiv::core::CommandLine& cmdline) {
   VLOG(1) << "STATE: Run(): side:" << static_cast<int>(side_);
   BinkState state = (side_ == BinkSide::ORIGINATING) ? BinkState::CONN_INIT : BinkState::WAIT_CONN;
   auto start_time = system_clock::now();
+  auto& metrics = Metrics::Global();
+  const auto frames_at_start =
+      metrics.counter("binkp.frames_sent").value() + metrics.counter("binkp.frames_received").value();
   try {
     bool done = false;
     while (!done) {
@@ -925,6 +942,18 @@ void BinkP::Run(const wwiv::core::CommandLine& cmdline) {
   }
 
   auto end_time = system_clock::now();
+  {
+    const auto elapsed = duration_cast<milliseconds>(end_time - start_time);
+    metrics.histogram("binkp.session").Record(elapsed);
+    metrics.counter("binkp.sessions").Add();
+    metrics.gauge("binkp.session_frames")
+        .Set(metrics.counter("binkp.frames_sent").value() +
+             metrics.counter("binkp.frames_received").value() - frames_at_start);
+    // Bytes of files transferred, like net.log.
+    metrics.gauge("binkp.session_bytes_per_second")
+        .Set((int64_t{bytes_sent_} + bytes_received_) * 1000 /
+             std::max<int64_t>(1, elapsed.count()));
+  }
   if (remote_.network().type == network_type_t::wwivnet) {
     // Handle WWIVnet inbound files.
     if (file_manager_) {
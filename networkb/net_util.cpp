@@ -23,6 +23,7 @@
 #include "core/datetime.h"
 #include "core/file.h"
 #include "core/log.h"
+#include "core/metrics.h"
 #include "core/stl.h"
 #include "core/strings.h"
 #include "core/version.h"
@@ -106,6 +107,19 @@ std::string NetworkCommandLine::semaphore_filename() const noexcept {
   return StrCat(network_.dir, network_cmd_name(net_cmd_), ".bsy");
 }
 
+std::string NetworkCommandLine::metrics_filename() const noexcept {
+  return StrCat(network_cmd_name(net_cmd_), ".metrics.json");
+}
+
+bool NetworkCommandLine::WriteMetrics() const {
+  const auto path = FilePath(network_.dir, metrics_filename());
+  if (!Metrics::Global().WriteJson(path)) {
+    LOG(ERROR) << "Unable to write metrics to: " << path;
+    return false;
+  }
+  return true;
+}
+
 static void SetNewBooleanDefault(CommandLine& cmdline, const IniFile& ini, const std::string& key) {
   if (cmdline.contains_arg(key) && cmdline.arg(key).is_default()) {
     auto f = ini.value<bool>(key, cmdline.barg(key));
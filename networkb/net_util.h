@@ -52,6 +52,10 @@ public:
   const wwiv::core::CommandLine& cmdline() const noexcept { return cmdline_; }
   char net_cmd() const noexcept { return net_cmd_; }
   std::string semaphore_filename() const noexcept;
+  /** Name of the metrics snapshot for this command, like network1.metrics.json. */
+  std::string metrics_filename() const noexcept;
+  /** Writes the metrics for this run to metrics_filename in the network directory. */
+  bool WriteMetrics() const;
 
   bool LoadNetIni();
   bool skip_delete() const noexcept;
@@ -247,6 +247,7 @@ int main(int argc, char** argv) {
   try {
     auto semaphore = SemaphoreFile::try_acquire(net_cmdline.semaphore_filename(),
                                                 net_cmdline.semaphore_timeout());
+    wwiv::core::ScopeExit write_metrics([&net_cmdline] { net_cmdline.WriteMetrics(); });
     return Main(net_cmdline);
   } catch (const semaphore_not_acquired& e) {
     LOG(ERROR) << "ERROR: [network" << net_cmdline.net_cmd()
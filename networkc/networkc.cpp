@@ -21,6 +21,7 @@
 #include <cstdlib>
 #include <ctime>
 #include <fcntl.h>
+#include <future>
 #include <iostream>
 #include <map>
 #include <memory>
@@ -38,11 +39,14 @@
 #include "core/stl.h"
 #include "core/strings.h"
 #include "core/version.h"
+#include "network1/network1.h"
+#include "network2/network2.h"
 #include "networkb/net_util.h"
 #include "sdk/fido/fido_util.h"
 
 #include "core/datetime.h"
 #include "core/findfiles.h"
+#include "sdk/bbslist.h"
 #include "sdk/callout.h"
 #include "sdk/config.h"
 #include "sdk/connect.h"
@@ -153,10 +157,47 @@ static bool need_network3(const string& dir, int network_version) {
          checkup2(bbsdata_time, dir, CALLOUT_NET);
 }
 
+/**
+ * Runs network1 and network2 in this process instead of as separate
+ * processes. network2 tosses the local packets from each pending file as
+ * soon as network1 has routed it, getting them through a PacketQueue
+ * instead of local.net. The config is shared and bbsdata is only read
+ * when it is first needed.
+ *
+ * Returns true if there were any pending files or local.net to process.
+ */
+static bool run_network1_and_2(const NetworkCommandLine& net_cmdline,
+                               std::unique_ptr<BbsListNet>& bbsdata) {
+  const auto& net = net_cmdline.network();
+  const auto pending = File::ExistsWildcard(FilePath(net.dir, "p*.net"));
+  if (!pending && !File::Exists(FilePath(net.dir, LOCAL_NET))) {
+    return false;
+  }
+  if (pending && !bbsdata) {
+    VLOG(1) << "Reading bbsdata.net..";
+    bbsdata = std::make_unique<BbsListNet>(BbsListNet::ReadBbsDataNet(net.dir));
+  }
+
+  PacketQueue local;
+  auto tosser = std::async(std::launch::async,
+                           [&] { return network2::network2_main(net_cmdline, &local); });
+  if (pending) {
+    VLOG(2) << "Found p*.net";
+    network1::network1_main(net_cmdline, *bbsdata, &local);
+  }
+  local.Close();
+  tosser.get();
+  return true;
+}
+
 int networkc_main(const NetworkCommandLine& net_cmdline) {
   try {
     const auto process_instance = net_cmdline.cmdline().iarg("process_instance");
     const auto& net = net_cmdline.network();
+    const auto pipeline =
+        net_cmdline.cmdline().barg("pipeline") && net.type == network_type_t::wwivnet;
+    // Kept between passes until network3 rebuilds it.
+    std::unique_ptr<BbsListNet> bbsdata;
 
     StatusMgr sm(net_cmdline.config().datadir(), [](int) {});
     auto status = sm.GetStatus();
@@ -171,8 +212,13 @@ int networkc_main(const NetworkCommandLine& net_cmdline) {
         rename_bbs_instance_files(net.dir, process_instance, net_cmdline.quiet());
       }
 
-      // Pending files, call network1 to put them into s* or local.net.
-      if (File::ExistsWildcard(FilePath(net.dir, "p*.net"))) {
+      if (pipeline) {
+        // Pending files and local mail, with network1 and network2 here.
+        if (run_network1_and_2(net_cmdline, bbsdata)) {
+          found = true;
+        }
+      } else if (File::ExistsWildcard(FilePath(net.dir, "p*.net"))) {
+        // Pending files, call network1 to put them into s* or local.net.
         VLOG(2) << "Found p*.net";
         System(create_network_cmdline(net_cmdline, '1', ""));
         found = true;
@@ -201,7 +247,7 @@ int networkc_main(const NetworkCommandLine& net_cmdline) {
       }
 
       // Process local mail with network2.
-      if (File::Exists(FilePath(net.dir, LOCAL_NET))) {
+      if (!pipeline && File::Exists(FilePath(net.dir, LOCAL_NET))) {
         VLOG(2) << "Found: " << LOCAL_NET;
         System(create_network_cmdline(net_cmdline, '2', ""));
         found = true;
@@ -211,6 +257,7 @@ int networkc_main(const NetworkCommandLine& net_cmdline) {
       if (need_network3(net.dir, status->GetNetworkVersion())) {
         VLOG(2) << "Need to run network3";
         System(create_network_cmdline(net_cmdline, '3', ""));
+        bbsdata.reset();
         found = true;
       }
     } while (found && ++num_tries < 3);
@@ -227,6 +274,9 @@ int main(int argc, char** argv) {
   ScopeExit at_exit(Logger::ExitLogger);
   CommandLine cmdline(argc, argv, "net");
   cmdline.add_argument({"process_instance", "Also process pending files for BBS instance #", "0"});
+  cmdline.add_argument(BooleanCommandLineArgument{
+      "pipeline", "Run network1 and network2 in this process, passing packets in memory.", false});
+  cmdline.add_argument({"threads", "Number of pending files network1 routes at once.", "1"});
 
   NetworkCommandLine net_cmdline(cmdline, 'c');
   if (!net_cmdline.IsInitialized() || net_cmdline.cmdline().help_requested()) {
@@ -236,6 +286,7 @@ int main(int argc, char** argv) {
   try {
     auto semaphore = SemaphoreFile::try_acquire(net_cmdline.semaphore_filename(),
                                                 net_cmdline.semaphore_timeout());
+    ScopeExit write_metrics([&net_cmdline] { net_cmdline.WriteMetrics(); });
     return networkc_main(net_cmdline);
   } catch (const semaphore_not_acquired& e) {
     LOG(ERROR) << "ERROR: [network" << net_cmdline.net_cmd()
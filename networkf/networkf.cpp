@@ -35,6 +35,7 @@
 #include "core/file.h"
 #include "core/findfiles.h"
 #include "core/log.h"
+#include "core/metrics.h"
 #include "core/os.h"
 #include "core/scope_exit.h"
 #include "core/semaphore_file.h"
@@ -191,16 +192,15 @@ static bool import_packet_file(const Config& config, FtnMessageDupe& dupe,
                                const std::string& dir, const string& name) {
   VLOG(1) << "import_packet_file: " << dir << name;
 
-  File f(FilePath(dir, name));
-  if (!f.Open(File::modeBinary | File::modeReadOnly)) {
+  FidoPacketReader f(FilePath(dir, name));
+  if (!f.Open()) {
     LOG(INFO) << "Unable to open file: " << dir << name;
     return false;
   }
 
   bool done = false;
   packet_header_2p_t header{};
-  auto num_header_read = f.Read(&header, sizeof(packet_header_2p_t));
-  if (num_header_read < sizeof(packet_header_2p_t)) {
+  if (!f.ReadHeader(header)) {
     LOG(ERROR) << "Read less than packet header";
     return false;
   }
@@ -219,17 +219,17 @@ static bool import_packet_file(const Config& config, FtnMessageDupe& dupe,
     // Move to BADMSGS
     f.Close();
     wwiv::sdk::fido::FtnDirectories dirs(config.root_directory(), net);
-    const auto dest = FilePath(dirs.bad_packets_dir(), f.GetName());
+    const auto dest = FilePath(dirs.bad_packets_dir(), name);
 
     if (!File::Move(f.full_pathname(), dest)) {
-      LOG(ERROR) << "Error moving file to BADMSGS; file: " << f;
+      LOG(ERROR) << "Error moving file to BADMSGS; file: " << f.full_pathname();
     }
     return false;
   }
 
   while (!done) {
     FidoPackedMessage msg;
-    ReadPacketResponse response = read_packed_message(f, msg);
+    ReadPacketResponse response = f.Next(msg);
     if (response == ReadPacketResponse::END_OF_FILE) {
       return true;
     } else if (response == ReadPacketResponse::ERROR) {
@@ -302,6 +302,10 @@ static bool import_packet_file(const Config& config, FtnMessageDupe& dupe,
       LOG(ERROR) << "ERROR Writing WWIV packet for message: " << packet.nh.main_type << "/"
                  << packet.nh.minor_type;
     } else {
+      static auto& packets_written = Metrics::Global().counter("networkf.packets_written");
+      static auto& bytes_written = Metrics::Global().counter("networkf.bytes_written");
+      packets_written.Add();
+      bytes_written.Add(sizeof(net_header_rec) + packet.nh.length);
       if (is_email) {
         LOG(INFO) << "     + Imported Email '" << msg.vh.subject << "' to '" << s1;
       } else {
@@ -388,13 +392,11 @@ static bool import_bundle_file(const Config& config, FtnMessageDupe& dupe,
  *
  * Returns the # of bundles processed.
  */
-static int import_bundles(const Config& config, const FidoCallout& callout,
+static int import_bundles(const Config& config, FtnMessageDupe& dupe, const FidoCallout& callout,
                           const net_networks_rec& net, const std::string& dir,
                           const std::string& mask, bool skip_delete) {
   int num_bundles_processed = 0;
 
-  FtnMessageDupe dupe(config);
-
   VLOG(1) << "import_bundles: mask: " << mask;
   FindFiles files(FilePath(dir, mask), FindFilesType::files);
   for (const auto& f : files) {
@@ -524,7 +526,7 @@ static bool CleanupWWIVName(std::string& sender_name) {
 }
 
 template <typename C, typename I>
-static std::string get_control_line(const C& c, I& iter, std::set<char> stop, std::size_t max) {
+static std::string get_control_line(const C& c, I& iter, const CharClass& stop, std::size_t max) {
   // No need to continue if we're already at the end.
   if (iter == c.end()) {
     return "";
@@ -537,7 +539,7 @@ static std::string get_control_line(const C& c, I& iter, std::set<char> stop, st
 }
 
 template <typename C, typename I>
-static std::string get_fido_addr(const C& c, I& iter, std::set<char> stop, std::size_t max) {
+static std::string get_fido_addr(const C& c, I& iter, const CharClass& stop, std::size_t max) {
   static const string kFidoAddr = "\x04"
                                   "0FidoAddr: ";
   string address;
@@ -632,7 +634,8 @@ static string remove_fido_addr(string to_user) {
   return to_user_new;
 }
 
-static bool create_ftn_packet(const Config& config, const FidoCallout& fido_callout,
+static bool create_ftn_packet(const Config& config, FtnMessageDupe& dupe,
+                              const FidoCallout& fido_callout,
                               const FidoAddress& dest, const FidoAddress& route_to,
                               const net_networks_rec& net, const Packet& wwivnet_packet,
                               string& fido_packet_name) {
@@ -707,12 +710,11 @@ static bool create_ftn_packet(const Config& config, const FidoCallout& fido_call
       vh.to_user_name = "All";
     }
 
-    FtnMessageDupe dupe(config);
     auto msgid = FtnMessageDupe::GetMessageIDFromWWIVText(raw_text);
     bool needs_msgid = false;
     if (msgid.empty()) {
       // Create a new MSGID if the BBS didn't put one in there already.
-      msgid = dupe.CreateMessageID(from_address);
+      msgid = FtnMessageDupe::CreateMessageID(config.datadir(), from_address);
       needs_msgid = true;
     }
 
@@ -798,13 +800,14 @@ static bool create_ftn_packet(const Config& config, const FidoCallout& fido_call
 }
 
 static bool create_ftn_packet_and_bundle(const NetworkCommandLine& net_cmdline,
+                                         FtnMessageDupe& dupe,
                                          const FidoCallout& fido_callout, const FidoAddress& dest,
                                          const FidoAddress& route_to, const net_networks_rec& net,
                                          const Packet& p, string& bundlename) {
   LOG(INFO) << "Creating packet for subscriber: " << dest << "; route_to: " << route_to;
   wwiv::sdk::fido::FtnDirectories dirs(net_cmdline.config().root_directory(), net);
   string fido_packet_name;
-  if (!create_ftn_packet(net_cmdline.config(), fido_callout, dest, route_to, net, p,
+  if (!create_ftn_packet(net_cmdline.config(), dupe, fido_callout, dest, route_to, net, p,
                          fido_packet_name)) {
     LOG(ERROR) << "    ! ERROR Failed to create FTN packet; writing to dead.net";
     write_wwivnet_packet(DEAD_NET, net, p);
@@ -983,7 +986,8 @@ static FidoAddress find_route_to(const FidoAddress& dest, const FidoCallout& cal
 }
 
 static bool export_main_type_new_post(const NetworkCommandLine& net_cmdline,
-                                      const net_networks_rec& net, const FidoCallout& fido_callout,
+                                      FtnMessageDupe& dupe, const net_networks_rec& net,
+                                      const FidoCallout& fido_callout,
                                       std::set<string>& bundles, Packet& p) {
   // Lame implementation that creates 1 file per message.
   auto subtype = get_subtype_from_packet_text(p.text());
@@ -998,7 +1002,7 @@ static bool export_main_type_new_post(const NetworkCommandLine& net_cmdline,
     string bundlename;
     auto packet_config = fido_callout.packet_config_for(sub);
     auto route_to = find_route_to(sub, fido_callout, packet_config);
-    if (!create_ftn_packet_and_bundle(net_cmdline, fido_callout, sub, route_to, net, p,
+    if (!create_ftn_packet_and_bundle(net_cmdline, dupe, fido_callout, sub, route_to, net, p,
                                       bundlename)) {
       continue;
     }
@@ -1013,9 +1017,9 @@ static bool export_main_type_new_post(const NetworkCommandLine& net_cmdline,
   return true;
 }
 
-bool export_main_type_email_name(const NetworkCommandLine& net_cmdline, const net_networks_rec& net,
-                                 const FidoCallout& fido_callout, std::set<string>& bundles,
-                                 Packet& p) {
+bool export_main_type_email_name(const NetworkCommandLine& net_cmdline, FtnMessageDupe& dupe,
+                                 const net_networks_rec& net, const FidoCallout& fido_callout,
+                                 std::set<string>& bundles, Packet& p) {
   // Lame implementation that creates 1 file per message.
   LOG(INFO) << "Creating packet for netmail.";
 
@@ -1032,7 +1036,8 @@ bool export_main_type_email_name(const NetworkCommandLine& net_cmdline, const ne
   // with netmail
   auto packet_config = fido_callout.packet_config_for(dest);
   FidoAddress route_to = find_route_to(dest, fido_callout, packet_config);
-  if (create_ftn_packet_and_bundle(net_cmdline, fido_callout, dest, route_to, net, p, bundlename)) {
+  if (create_ftn_packet_and_bundle(net_cmdline, dupe, fido_callout, dest, route_to, net, p,
+                                   bundlename)) {
     if (!contains(bundles, bundlename)) {
       // We only want to attach the bundle (or add it to the flo file)
       // one time, so skip ones that have already been done.
@@ -1092,14 +1097,20 @@ int Main(const NetworkCommandLine& net_cmdline) {
 
   wwiv::sdk::fido::FtnDirectories dirs(net_cmdline.config().root_directory(), net);
   if (cmd == "import") {
+    // Other FTN networks share the dupe file, this waits for them to finish.
+    FtnMessageDupe dupe(net_cmdline.config(), net_cmdline.semaphore_timeout());
+    if (!dupe.IsInitialized()) {
+      LOG(ERROR) << "Unable to open the FTN message dupe file.";
+      return 1;
+    }
     const std::vector<string> extensions{"su?", "mo?", "tu?", "we?", "th?", "fr?", "sa?", "pkt"};
     for (const auto& ext : extensions) {
       num_packets_processed +=
-          import_bundles(net_cmdline.config(), fido_callout, net, dirs.inbound_dir(),
+          import_bundles(net_cmdline.config(), dupe, fido_callout, net, dirs.inbound_dir(),
                           StrCat("*.", ext), net_cmdline.skip_delete());
 #ifndef _WIN32
       num_packets_processed +=
-          import_bundles(net_cmdline.config(), fido_callout, net, dirs.inbound_dir(),
+          import_bundles(net_cmdline.config(), dupe, fido_callout, net, dirs.inbound_dir(),
                           StrCat("*.", ToStringUpperCase(ext)), net_cmdline.skip_delete());
 #endif
     }
@@ -1117,11 +1128,27 @@ int Main(const NetworkCommandLine& net_cmdline) {
       return 1;
     }
 
+    // Exported messages are added to the dupe file so they aren't imported
+    // again when they come back.
+    FtnMessageDupe dupe(net_cmdline.config(), net_cmdline.semaphore_timeout());
+    if (!dupe.IsInitialized()) {
+      LOG(WARNING) << "Unable to open the FTN message dupe file, exporting anyway.";
+    }
+
+    auto& metrics = Metrics::Global();
+    auto& packets_read = metrics.counter("networkf.packets_read");
+    auto& bytes_read = metrics.counter("networkf.bytes_read");
+    auto& read_time = metrics.histogram("networkf.read_packet");
+    auto& handle_time = metrics.histogram("networkf.handle_packet");
     auto done = false;
     std::set<std::string> bundles;
     while (!done) {
       Packet p;
-      const auto response = read_packet(f, p, true);
+      ReadPacketResponse response;
+      {
+        ScopedTimer t(read_time);
+        response = read_packet(f, p, true);
+      }
       if (response == ReadPacketResponse::END_OF_FILE) {
         // Delete the packet.
         f.Close();
@@ -1135,13 +1162,16 @@ int Main(const NetworkCommandLine& net_cmdline) {
       }
       // If we got here, we had a packet to process.
       ++num_packets_processed;
+      packets_read.Add();
+      bytes_read.Add(sizeof(net_header_rec) + p.nh.length);
+      ScopedTimer t(handle_time);
 
       if (p.nh.main_type == main_type_new_post) {
-        if (!export_main_type_new_post(net_cmdline, net, fido_callout, bundles, p)) {
+        if (!export_main_type_new_post(net_cmdline, dupe, net, fido_callout, bundles, p)) {
           LOG(ERROR) << "Error exporting post.";
         }
       } else if (p.nh.main_type == main_type_email_name) {
-        if (!export_main_type_email_name(net_cmdline, net, fido_callout, bundles, p)) {
+        if (!export_main_type_email_name(net_cmdline, dupe, net, fido_callout, bundles, p)) {
           LOG(ERROR) << "Error exporting email.";
         }
       } else {
@@ -1175,6 +1205,7 @@ int main(int argc, char** argv) {
     }
     auto semaphore = SemaphoreFile::try_acquire(net_cmdline.semaphore_filename(),
                                                 net_cmdline.semaphore_timeout());
+    ScopeExit write_metrics([&net_cmdline] { net_cmdline.WriteMetrics(); });
     return Main(net_cmdline);
   } catch (const semaphore_not_acquired& e) {
     LOG(ERROR) << "ERROR: [network" << net_cmdline.net_cmd()
@@ -20,6 +20,8 @@
 #include <algorithm>
 #include <cmath>
 #include <cctype>
+#include <cstring>
+#include <functional>
 #include <iostream>
 #include <iterator>
 #include <memory>
@@ -27,6 +29,7 @@
 #include <sstream>
 #include <string>
 
+#include "core/crc32.h"
 #include "core/strings.h"
 #include "core/inifile.h"
 #include "core/datafile.h"
@@ -153,8 +156,7 @@ static bool ParseBbsListNetFile(
   std::map<uint16_t, net_system_list_rec>* node_config_map,
   std::map<uint16_t, int32_t>* reg_number_map,
   const string network_dir,
-  wwiv::graphs::Graph& graph,
-  uint16_t net_node_number) {
+  const std::function<void(net_system_list_rec&)>& add_route) {
   TextFile bbs_list_file(FilePath(network_dir, BBSLIST_NET), "rt");
   if (!bbs_list_file.IsOpen()) {
     return false;
@@ -168,35 +170,7 @@ static bool ParseBbsListNetFile(
     int32_t reg_number;
     if (ParseBbsListNetLine(line, &node_config, &reg_number)) {
       // Parsed a line correctly.
-      std::list<uint16_t> path = graph.shortest_path_to(node_config.sysnum);
-      float cost = graph.cost_to(node_config.sysnum);
-      if (!std::isfinite(cost)) {
-        if(VLOG_IS_ON(2)) {
-          std::ostringstream ss; 
-          VLOG(2) << "high cost " << cost << " to " << node_config.sysnum;
-          ss << "Path to " << node_config.sysnum << ": ";
-          std::copy(path.begin(), path.end(), std::ostream_iterator<uint16_t>(ss, " "));
-          VLOG(2) << ss.str();
-          VLOG(2) << graph.DumpCosts();
-        }
-      }
-      if (graph.has_node(node_config.sysnum) && path.front() == net_node_number) {
-        path.pop_front();
-        // We have a path...
-        //std::copy(path.begin(), path.end(), std::ostream_iterator<uint16_t>(std::cout, " "));
-        node_config.numhops = static_cast<int16_t>(path.size());
-        node_config.xx.cost = cost;
-        if (!path.empty()) {
-          node_config.forsys = path.front();
-        } else {
-          node_config.forsys = node_config.sysnum;
-        }
-      } else {
-        VLOG(2) << "no path to " << node_config.sysnum;
-        node_config.numhops = 10000;
-        node_config.xx.cost = 10000;
-        node_config.forsys = std::numeric_limits<uint16_t>::max();
-      }
+      add_route(node_config);
       node_config_map->emplace(node_config.sysnum, node_config);
       reg_number_map->emplace(node_config.sysnum, reg_number);
     }
@@ -204,11 +178,62 @@ static bool ParseBbsListNetFile(
   return true;
 }
 
+static void add_route_from_graph(wwiv::graphs::Graph& graph, uint16_t net_node_number,
+                                 net_system_list_rec& node_config) {
+  std::list<uint16_t> path = graph.shortest_path_to(node_config.sysnum);
+  float cost = graph.cost_to(node_config.sysnum);
+  if (!std::isfinite(cost)) {
+    if(VLOG_IS_ON(2)) {
+      std::ostringstream ss; 
+      VLOG(2) << "high cost " << cost << " to " << node_config.sysnum;
+      ss << "Path to " << node_config.sysnum << ": ";
+      std::copy(path.begin(), path.end(), std::ostream_iterator<uint16_t>(ss, " "));
+      VLOG(2) << ss.str();
+      VLOG(2) << graph.DumpCosts();
+    }
+  }
+  if (graph.has_node(node_config.sysnum) && path.front() == net_node_number) {
+    path.pop_front();
+    // We have a path...
+    //std::copy(path.begin(), path.end(), std::ostream_iterator<uint16_t>(std::cout, " "));
+    node_config.numhops = static_cast<int16_t>(path.size());
+    node_config.xx.cost = cost;
+    if (!path.empty()) {
+      node_config.forsys = path.front();
+    } else {
+      node_config.forsys = node_config.sysnum;
+    }
+  } else {
+    VLOG(2) << "no path to " << node_config.sysnum;
+    node_config.numhops = 10000;
+    node_config.xx.cost = 10000;
+    node_config.forsys = std::numeric_limits<uint16_t>::max();
+  }
+}
+
+static void add_route_from_table(const BbsRoutingTable& table, net_system_list_rec& node_config) {
+  const auto& r = table.route_for(node_config.sysnum);
+  node_config.forsys = r.forsys;
+  node_config.numhops = r.numhops;
+  node_config.xx.cost = r.cost;
+}
+
 // static 
 BbsListNet BbsListNet::ParseBbsListNet(uint16_t net_node_number, const std::string& network_dir) {
   BbsListNet b;
 
   VLOG(3) << "Processing " << network_dir;
+  b.source_crc_ = BbsRoutingTable::SourceChecksum(net_node_number, network_dir);
+  BbsRoutingTable table(network_dir);
+  if (table.Open() && table.header().source_crc == b.source_crc_) {
+    // Nothing changed since the routing table was written, so use
+    // the routes from it.
+    VLOG(1) << "Using routes from " << BBSDATA_RTE;
+    ParseBbsListNetFile(&b.node_config_, &b.reg_number_, network_dir,
+                        [&](net_system_list_rec& n) { add_route_from_table(table, n); });
+    return b;
+  }
+
   // We now need to add in cost and routing information.
   Connect connect(network_dir);
 
@@ -224,7 +249,8 @@ BbsListNet BbsListNet::ParseBbsListNet(uint16_t net_node_number, const std::stri
     }
   }
 
-  ParseBbsListNetFile(&b.node_config_, &b.reg_number_, network_dir, graph, net_node_number);
+  ParseBbsListNetFile(&b.node_config_, &b.reg_number_, network_dir,
+                      [&](net_system_list_rec& n) { add_route_from_graph(graph, net_node_number, n); });
   return b;
 }
 
@@ -241,6 +267,11 @@ BbsListNet BbsListNet::ReadBbsDataNet(const std::string& network_dir) {
     }
     file.Close();
   }
+
+  auto table = std::make_shared<BbsRoutingTable>(network_dir);
+  if (table->Open() && table->IsCurrentFor(network_dir)) {
+    b.routes_ = table;
+  }
   return b;
 }
 
@@ -262,6 +293,122 @@ const net_system_list_rec* BbsListNet::node_config_for(int node) const {
   return nullptr;
 }
 
+uint16_t BbsListNet::forsys_for(uint16_t node) const {
+  if (routes_) {
+    return routes_->route_for(node).forsys;
+  }
+  auto n = node_config_for(node);
+  if (n == nullptr) {
+    return WWIVNET_NO_NODE;
+  }
+  return n->forsys;
+}
+
+BbsRoutingTable::BbsRoutingTable(const std::string& network_dir)
+    : file_(FilePath(network_dir, BBSDATA_RTE)) {}
+
+bool BbsRoutingTable::Open() {
+  if (!file_.Open()) {
+    return false;
+  }
+  static constexpr auto expected_size =
+      sizeof(bbsdata_rte_header_t) + NUM_ROUTES * sizeof(bbsdata_rte_t);
+  if (file_.size() != expected_size) {
+    LOG(ERROR) << "Wrong size for routing table: " << file_.full_pathname();
+    file_.Close();
+    return false;
+  }
+  const auto& h = header();
+  if (memcmp(h.signature, "WRTE", 4) != 0 || h.version != VERSION) {
+    LOG(ERROR) << "Unknown routing table format: " << file_.full_pathname();
+    file_.Close();
+    return false;
+  }
+  return true;
+}
+
+const bbsdata_rte_header_t& BbsRoutingTable::header() const noexcept {
+  return *reinterpret_cast<const bbsdata_rte_header_t*>(file_.data());
+}
+
+const bbsdata_rte_t& BbsRoutingTable::route_for(uint16_t node) const noexcept {
+  auto routes = reinterpret_cast<const bbsdata_rte_t*>(file_.data() + sizeof(bbsdata_rte_header_t));
+  return routes[node];
+}
+
+bool BbsRoutingTable::IsCurrentFor(const std::string& network_dir) const {
+  const auto& h = header();
+  File bbsdata(FilePath(network_dir, BBSDATA_NET));
+  if (static_cast<uint64_t>(bbsdata.length()) != h.bbsdata_size) {
+    return false;
+  }
+  return static_cast<int64_t>(bbsdata.last_write_time()) == h.bbsdata_mtime ||
+         BbsDataChecksum(network_dir) == h.bbsdata_crc;
+}
+
+// static
+uint32_t BbsRoutingTable::SourceChecksum(uint16_t net_node_number, const std::string& network_dir) {
+  std::ostringstream ss;
+  ss << net_node_number << " " << crc32file(FilePath(network_dir, BBSLIST_NET)) << " "
+     << crc32file(FilePath(network_dir, CONNECT_NET));
+  return crc32string(ss.str());
+}
+
+// static
+uint32_t BbsRoutingTable::BbsDataChecksum(const std::string& network_dir) {
+  return crc32file(FilePath(network_dir, BBSDATA_NET));
+}
+
+// static
+bool BbsRoutingTable::Write(const std::string& network_dir, uint16_t net_node_number,
+                            uint32_t source_crc, const BbsListNet& b) {
+  bbsdata_rte_header_t h{};
+  memcpy(h.signature, "WRTE", 4);
+  h.version = VERSION;
+  h.sysnum = net_node_number;
+  h.source_crc = source_crc;
+  h.bbsdata_crc = BbsDataChecksum(network_dir);
+  File bbsdata(FilePath(network_dir, BBSDATA_NET));
+  h.bbsdata_size = static_cast<uint64_t>(bbsdata.length());
+  h.bbsdata_mtime = static_cast<int64_t>(bbsdata.last_write_time());
+
+  vector<bbsdata_rte_t> routes(NUM_ROUTES, bbsdata_rte_t{WWIVNET_NO_NODE, 0, 0.0f});
+  for (const auto& e : b.node_config()) {
+    const auto& n = e.second;
+    routes[n.sysnum] = bbsdata_rte_t{n.forsys, n.numhops, n.xx.cost};
+  }
+
+  // Write to a temporary file first so that nobody maps a partial table.
+  const auto path = FilePath(network_dir, BBSDATA_RTE);
+  const auto temp_path = StrCat(path, ".tmp");
+  {
+    File file(temp_path);
+    if (!file.Open(File::modeBinary | File::modeReadWrite | File::modeCreateFile |
+                   File::modeTruncate, File::shareDenyReadWrite)) {
+      LOG(ERROR) << "Unable to create routing table: " << file.full_pathname();
+      return false;
+    }
+    const auto routes_size = routes.size() * sizeof(bbsdata_rte_t);
+    if (file.Write(&h, sizeof(h)) != static_cast<ssize_t>(sizeof(h)) ||
+        file.Write(&routes[0], routes_size) != static_cast<ssize_t>(routes_size)) {
+      LOG(ERROR) << "Unable to write routing table: " << file.full_pathname();
+      file.Close();
+      File::Remove(temp_path);
+      return false;
+    }
+  }
+  if (!File::Rename(temp_path, path)) {
+    // Windows won't rename over an existing file.
+    File::Remove(path);
+    if (!File::Rename(temp_path, path)) {
+      LOG(ERROR) << "Unable to rename " << temp_path << " to " << path;
+      File::Remove(temp_path);
+      return false;
+    }
+  }
+  return true;
+}
+
 static std::string DumpBbsListNet(const net_system_list_rec& n) {
   std::ostringstream ss;
   ss << "sysnum:        " << n.sysnum << std::endl;
@@ -18,16 +18,95 @@
 #ifndef __INCLUDED_SDK_BBSLIST_H__
 #define __INCLUDED_SDK_BBSLIST_H__
 
+#include <cstdint>
 #include <initializer_list>
 #include <map>
+#include <memory>
 #include <string>
 
+#include "core/mmap_file.h"
 #include "sdk/net.h"
 
 namespace wwiv {
 namespace sdk {
 
-  
+/**
+ * Header of BBSDATA_RTE, the binary routing table written by network3
+ * alongside bbsdata.net.
+ */
+struct bbsdata_rte_header_t {
+  // "WRTE"
+  char signature[4];
+  uint16_t version;
+  // Node number the routes were computed from.
+  uint16_t sysnum;
+  // Checksum of bbslist.net and connect.net used to build this table.
+  uint32_t source_crc;
+  // CRC-32 of the bbsdata.net written with this table.
+  uint32_t bbsdata_crc;
+  // Size and modification time of that bbsdata.net, these are checked
+  // first so the CRC only needs computing when the mtime changed.
+  uint64_t bbsdata_size;
+  int64_t bbsdata_mtime;
+};
+static_assert(sizeof(bbsdata_rte_header_t) == 32, "bbsdata_rte_header_t == 32");
+
+/**
+ * One route in BBSDATA_RTE. The table holds one of these for every node
+ * number, unknown nodes have a forsys of WWIVNET_NO_NODE.
+ */
+struct bbsdata_rte_t {
+  uint16_t forsys;
+  int16_t numhops;
+  float cost;
+};
+static_assert(sizeof(bbsdata_rte_t) == 8, "bbsdata_rte_t == 8");
+
+class BbsListNet;
+
+/**
+ * Read only, memory mapped view of the BBSDATA_RTE routing table, this lets
+ * get_forsys look up any node without parsing bbslist.net and connect.net
+ * or running the shortest path search again.
+ */
+class BbsRoutingTable final {
+public:
+  static constexpr uint16_t VERSION = 3;
+  static constexpr std::size_t NUM_ROUTES = 65536;
+
+  explicit BbsRoutingTable(const std::string& network_dir);
+  /** Maps the table, returns false if it is missing or not a valid table. */
+  bool Open();
+  const bbsdata_rte_header_t& header() const noexcept;
+  /** Returns the route to node. Only valid after Open returned true. */
+  const bbsdata_rte_t& route_for(uint16_t node) const noexcept;
+  /**
+   * Returns true if this table was written with the bbsdata.net in
+   * network_dir. Like NodelistIndex, the size and mtime are compared first
+   * and the CRC is only computed when the mtime differs.
+   */
+  bool IsCurrentFor(const std::string& network_dir) const;
+
+  /**
+   * Checksum of the files the routes are computed from (bbslist.net and
+   * connect.net) along with the node number they are computed from.
+   */
+  static uint32_t SourceChecksum(uint16_t net_node_number, const std::string& network_dir);
+  /** Checksum of bbsdata.net, a table is only used with the bbsdata.net it was written with. */
+  static uint32_t BbsDataChecksum(const std::string& network_dir);
+  /**
+   * Writes the routes from b to BBSDATA_RTE in network_dir, along with the
+   * checksum of the bbsdata.net already written there. The table is written
+   * to a temporary file and renamed into place, since other processes may
+   * have the old one mapped.
+   */
+  static bool Write(const std::string& network_dir, uint16_t net_node_number,
+                    uint32_t source_crc, const BbsListNet& b);
+
+private:
+  wwiv::core::MemoryMappedFile file_;
+};
+
 class BbsListNet {
  public:
    static BbsListNet ParseBbsListNet(uint16_t net_node_number, const std::string& network_dir);
@@ -36,8 +115,20 @@ class BbsListNet {
   BbsListNet(std::initializer_list<net_system_list_rec> l);
   virtual ~BbsListNet();
   const net_system_list_rec* node_config_for(int node) const;
-  BbsListNet& operator=(const BbsListNet& rhs) { node_config_ = rhs.node_config_; return *this; }
+  BbsListNet& operator=(const BbsListNet& rhs) {
+    node_config_ = rhs.node_config_;
+    routes_ = rhs.routes_;
+    source_crc_ = rhs.source_crc_;
+    return *this;
+  }
   std::string ToString() const;
+  /**
+   * Returns the node to forward packets for node through, or WWIVNET_NO_NODE
+   * if there is no route to it. Uses the routing table when one was loaded.
+   */
+  uint16_t forsys_for(uint16_t node) const;
+  /** Checksum of the sources this was parsed from, 0 when read from bbsdata.net. */
+  uint32_t source_crc() const noexcept { return source_crc_; }
 
   bool empty() const { return node_config_.empty(); }
   const std::map<uint16_t, net_system_list_rec>& node_config() const { return node_config_; }
@@ -47,6 +138,8 @@ class BbsListNet {
    BbsListNet();
    std::map<uint16_t, net_system_list_rec> node_config_;
    std::map<uint16_t, int32_t> reg_number_;
+   std::shared_ptr<const BbsRoutingTable> routes_;
+   uint32_t source_crc_{0};
 };
 
 bool ParseBbsListNetLine(const std::string& line, net_system_list_rec* config, int32_t* reg_number);
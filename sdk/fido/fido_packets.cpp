@@ -18,6 +18,7 @@
 #include "sdk/fido/fido_packets.h"
 
 #include <algorithm>
+#include <cstring>
 #include <string>
 
 #include "core/file.h"
@@ -36,15 +37,6 @@ namespace wwiv {
 namespace sdk {
 namespace fido {
 
-static char ReadCharFromFile(File& f) {
-  char buf[1];
-  auto num_read = f.Read(buf, 1);
-  if (num_read == 0) {
-    return 0;
-  }
-  return buf[0];
-}
-
 static std::string ReadRestOfFile(File& f, int max_size) {
   auto current = f.current_position();
   auto size = f.length();
@@ -78,18 +70,41 @@ static std::string ReadFixedLengthField(File& f, int len) {
  * character.
  */
 static std::string ReadVariableLengthField(File& f, int max_len) {
+  // Read a block at a time and seek back over anything read past the
+  // null, rather than doing one read per character.
   string s;
-  for (int i = 0; i < max_len; i++) {
-    char ch = ReadCharFromFile(f);
-    if (ch == 0) {
+  char buf[256];
+  while (static_cast<int>(s.size()) < max_len) {
+    const auto to_read = std::min<size_t>(sizeof(buf), max_len - s.size());
+    const auto num_read = f.Read(buf, to_read);
+    if (num_read <= 0) {
+      return s;
+    }
+    const auto* end = static_cast<const char*>(memchr(buf, 0, num_read));
+    if (end != nullptr) {
+      s.append(buf, end - buf);
+      const auto extra = num_read - (end - buf) - 1;
+      if (extra > 0) {
+        f.Seek(-static_cast<off_t>(extra), File::Whence::current);
+      }
       return s;
-    } else {
-      s.push_back(ch);
     }
+    s.append(buf, num_read);
   }
   return s;
 }
 
+/**
+ * Same as ReadFixedLengthField, but from memory at data.
+ */
+static std::string FixedLengthField(const char* data, std::size_t len) {
+  while (len > 0 && data[len - 1] == '\0') {
+    // Remove trailing null characters.
+    len--;
+  }
+  return string(data, len);
+}
+
 bool write_fido_packet_header(File& f, packet_header_2p_t& header) {
   auto num_written = f.Write(&header, sizeof(packet_header_2p_t));
   if (num_written != sizeof(packet_header_2p_t)) {
@@ -178,6 +193,76 @@ ReadPacketResponse read_stored_message(File& f, FidoStoredMessage& packet) {
   return ReadPacketResponse::OK;
 }
 
+FidoPacketReader::FidoPacketReader(const std::string& path) : file_(path) {}
+
+bool FidoPacketReader::Open() {
+  pos_ = 0;
+  return file_.Open();
+}
+
+void FidoPacketReader::Close() { file_.Close(); }
+
+bool FidoPacketReader::ReadHeader(packet_header_2p_t& header) {
+  if (file_.size() < sizeof(packet_header_2p_t)) {
+    return false;
+  }
+  memcpy(&header, file_.data(), sizeof(packet_header_2p_t));
+  pos_ = sizeof(packet_header_2p_t);
+  return true;
+}
+
+std::string FidoPacketReader::ReadFixedLengthField(std::size_t len) {
+  len = std::min(len, file_.size() - pos_);
+  const auto* data = reinterpret_cast<const char*>(file_.data()) + pos_;
+  pos_ += len;
+  return FixedLengthField(data, len);
+}
+
+std::string FidoPacketReader::ReadVariableLengthField(std::size_t max_len) {
+  const auto len = std::min(max_len, file_.size() - pos_);
+  const auto* data = reinterpret_cast<const char*>(file_.data()) + pos_;
+  const auto* end = static_cast<const char*>(memchr(data, 0, len));
+  if (end == nullptr) {
+    pos_ += len;
+    return string(data, len);
+  }
+  // Skip over the null too.
+  pos_ += (end - data) + 1;
+  return string(data, end);
+}
+
+ReadPacketResponse FidoPacketReader::Next(FidoPackedMessage& packet) {
+  if (!file_.IsOpen() || pos_ >= file_.size()) {
+    // at the end of the packet.
+    return ReadPacketResponse::END_OF_FILE;
+  }
+  const auto num_read = std::min(sizeof(fido_packed_message_t), file_.size() - pos_);
+  memcpy(&packet.nh, file_.data() + pos_, num_read);
+  pos_ += num_read;
+  if (num_read == 2) {
+    // FIDO packets have 2 bytes of NULL at the end;
+    if (packet.nh.message_type == 0) {
+      return ReadPacketResponse::END_OF_FILE;
+    }
+  }
+
+  if (num_read != sizeof(fido_packed_message_t)) {
+    LOG(INFO) << "error reading header, got short read of size: " << num_read
+              << "; expected: " << sizeof(fido_packed_message_t);
+    return ReadPacketResponse::ERROR;
+  }
+
+  if (packet.nh.message_type != 2) {
+    LOG(INFO) << "invalid message_type: " << packet.nh.message_type << "; expected: 2";
+  }
+  packet.vh.date_time = ReadFixedLengthField(20);
+  packet.vh.to_user_name = ReadVariableLengthField(36);
+  packet.vh.from_user_name = ReadVariableLengthField(36);
+  packet.vh.subject = ReadVariableLengthField(72);
+  packet.vh.text = ReadVariableLengthField(256 * 1024);
+  return ReadPacketResponse::OK;
+}
+
 } // namespace fido
 } // namespace sdk
 } // namespace wwiv
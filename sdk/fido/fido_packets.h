@@ -23,6 +23,7 @@
 #include <string>
 
 #include "core/file.h"
+#include "core/mmap_file.h"
 #include "sdk/config.h"
 #include "sdk/networks.h"
 #include "sdk/net.h"
@@ -273,6 +274,40 @@ wwiv::sdk::net::ReadPacketResponse read_packed_message(wwiv::core::File& file,
 wwiv::sdk::net::ReadPacketResponse read_stored_message(wwiv::core::File& file,
                                                        FidoStoredMessage& packet);
 
+/**
+ * Reads the messages in a .PKT file from a memory mapping of the file, so
+ * the header and NUL terminated fields of each message are parsed directly
+ * from memory instead of one File::Read per byte.
+ *
+ * Example:
+ *   FidoPacketReader reader(FilePath(dir, name));
+ *   packet_header_2p_t header{};
+ *   if (!reader.Open() || !reader.ReadHeader(header)) { ... }
+ *   FidoPackedMessage msg;
+ *   while (reader.Next(msg) == ReadPacketResponse::OK) { ... }
+ */
+class FidoPacketReader final {
+public:
+  explicit FidoPacketReader(const std::string& path);
+
+  /** Maps the file. Returns false if it does not exist or is empty. */
+  bool Open();
+  void Close();
+  const std::string& full_pathname() const noexcept { return file_.full_pathname(); }
+
+  /** Reads the packet header, this must be called before Next. */
+  bool ReadHeader(packet_header_2p_t& header);
+  /** Reads the next message into packet, see read_packed_message. */
+  wwiv::sdk::net::ReadPacketResponse Next(FidoPackedMessage& packet);
+
+private:
+  std::string ReadFixedLengthField(std::size_t len);
+  std::string ReadVariableLengthField(std::size_t max_len);
+
+  wwiv::core::MemoryMappedFile file_;
+  std::size_t pos_{0};
+};
+
 
 }  // namespace fido
 }  // namespace sdk
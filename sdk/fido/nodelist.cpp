@@ -17,16 +17,24 @@
 /**************************************************************************/
 #include "sdk/fido/nodelist.h"
 
-#include <set>
+#include <algorithm>
+#include <future>
+#include <iterator>
+#include <limits>
+#include <map>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
 
 #include "core/file.h"
 #include "core/log.h"
+#include "core/mmap_file.h"
 #include "core/stl.h"
 #include "core/strings.h"
-#include "core/textfile.h"
 #include "core/findfiles.h"
 #include "core/datetime.h"
+#include "sdk/fido/nodelist_index.h"
 
 using std::string;
 using std::vector;
@@ -39,112 +47,204 @@ namespace wwiv {
 namespace sdk {
 namespace fido {
 
-static NodelistKeyword to_keyword(const std::string& k) {
+static bool starts_with(std::string_view s, std::string_view prefix) {
+  return s.substr(0, prefix.size()) == prefix;
+}
+
+// Same as StringTrim.
+static std::string_view trim(std::string_view s) {
+  const auto first = s.find_first_not_of(" \t\r\n");
+  if (first == std::string_view::npos) {
+    return {};
+  }
+  return s.substr(first, s.find_last_not_of(" \t\r\n") - first + 1);
+}
+
+static NodelistKeyword to_keyword(std::string_view k) {
   if (k.empty()) {
     return NodelistKeyword::node;
   }
 
-  if (k == "Down") return NodelistKeyword::down;
-  if (k == "Host") return NodelistKeyword::host;
-  if (k == "Hub") return NodelistKeyword::hub;
-  if (k == "Pvt") return NodelistKeyword::pvt;
-  if (k == "Region") return NodelistKeyword::region;
-  if (k == "Zone") return NodelistKeyword::zone;
-
+  switch (k.front()) {
+  case 'D': if (k == "Down") return NodelistKeyword::down; break;
+  case 'H':
+    if (k == "Host") return NodelistKeyword::host;
+    if (k == "Hub") return NodelistKeyword::hub;
+    break;
+  case 'P': if (k == "Pvt") return NodelistKeyword::pvt; break;
+  case 'R': if (k == "Region") return NodelistKeyword::region; break;
+  case 'Z': if (k == "Zone") return NodelistKeyword::zone; break;
+  }
   return NodelistKeyword::node;
 }
 
-static inline bool bool_flag(const std::string& value, const std::string& flag_name, bool& f) {
-  if (value == flag_name) {
-    f = true;
-    return true;
+/**
+ * Splits a string_view on delim without allocating. Like SplitString, empty
+ * fields are skipped.
+ */
+class FieldTokenizer {
+public:
+  FieldTokenizer(std::string_view s, char delim) : s_(s), delim_(delim) {}
+
+  bool next(std::string_view& field) {
+    while (pos_ < s_.size()) {
+      auto end = s_.find(delim_, pos_);
+      if (end == std::string_view::npos) {
+        end = s_.size();
+      }
+      const auto start = pos_;
+      pos_ = end + 1;
+      if (end > start) {
+        field = s_.substr(start, end - start);
+        return true;
+      }
+    }
+    return false;
   }
-  return false;
-}
 
-static bool internet_flag(const std::string& value, const std::string& flag_name, bool& f, string& host, uint16_t& port) {
-  if (!contains(value, ':')) return false;
-  vector<string> parts = SplitString(value, ":");
-  if (parts.size() > 3) return false;
+private:
+  const std::string_view s_;
+  const char delim_;
+  std::size_t pos_{0};
+};
+
+/** Like to_number, clamping to T's max value and returning 0 for non numbers. */
+template <typename T>
+static T parse_number(std::string_view s) {
+  std::size_t i = 0;
+  while (i < s.size() && (s[i] == ' ' || s[i] == '\t')) {
+    ++i;
+  }
+  uint64_t n = 0;
+  for (; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i) {
+    n = n * 10 + static_cast<uint64_t>(s[i] - '0');
+    if (n > std::numeric_limits<T>::max()) {
+      return std::numeric_limits<T>::max();
+    }
+  }
+  return static_cast<T>(n);
+}
 
-  if (parts.front() == flag_name) {
-    f = true;
-    if (parts.size() > 1) {
-      port = to_number<uint16_t>(parts.back());
+enum class nodelist_flag_t { unknown, cm, icm, mo, lo, mn, ina, ibn, itn, ivn };
+
+// All flags we know about are 2 or 3 characters, so switch on the
+// length and then the characters.
+static nodelist_flag_t to_flag(std::string_view f) {
+  if (f.size() == 2) {
+    switch (f[0]) {
+    case 'C': if (f[1] == 'M') return nodelist_flag_t::cm; break;
+    case 'L': if (f[1] == 'O') return nodelist_flag_t::lo; break;
+    case 'M':
+      if (f[1] == 'O') return nodelist_flag_t::mo;
+      if (f[1] == 'N') return nodelist_flag_t::mn;
+      break;
     }
-    if (parts.size() == 3) {
-      // flag:host:port
-      host = parts.at(1);
+  } else if (f.size() == 3 && f[0] == 'I') {
+    switch (f[1]) {
+    case 'C': if (f[2] == 'M') return nodelist_flag_t::icm; break;
+    case 'N': if (f[2] == 'A') return nodelist_flag_t::ina; break;
+    case 'B': if (f[2] == 'N') return nodelist_flag_t::ibn; break;
+    case 'T': if (f[2] == 'N') return nodelist_flag_t::itn; break;
+    case 'V': if (f[2] == 'N') return nodelist_flag_t::ivn; break;
     }
-    return true;
   }
-  return false;
+  return nodelist_flag_t::unknown;
 }
 
-static bool bool_flag(const std::string& value, const std::string& flag_name, bool& f, string& fs) {
-  if (!contains(value, ':')) return false;
-  vector<string> parts = SplitString(value, ":");
-  if (parts.size() > 2) return false;
+static void internet_flag(std::string_view* parts, int num_parts, bool& f, string& host, uint16_t& port) {
+  if (num_parts > 3) return;
+  f = true;
+  if (num_parts > 1) {
+    port = parse_number<uint16_t>(parts[num_parts - 1]);
+  }
+  if (num_parts == 3) {
+    // flag:host:port
+    host.assign(parts[1].data(), parts[1].size());
+  }
+}
 
-  if (parts.front() == flag_name) {
-    f = true;
-    if (parts.size() > 1) {
-      fs = parts.back();
-//      StringTrim(&fs);
+static void handle_flag(std::string_view f, NodelistEntry& e) {
+  if (f.find(':') == std::string_view::npos) {
+    switch (to_flag(f)) {
+    case nodelist_flag_t::cm: e.cm_ = true; break;
+    case nodelist_flag_t::icm: e.icm_ = true; break;
+    case nodelist_flag_t::mo: e.mo_ = true; break;
+    case nodelist_flag_t::lo: e.lo_ = true; break;
+    case nodelist_flag_t::mn: e.mn_ = true; break;
+    default: break;
     }
-    return true;
+    return;
+  }
+
+  // flag:value or flag:host:port, we only care about up to 3 parts.
+  std::string_view parts[4];
+  int num_parts = 0;
+  FieldTokenizer tok(f, ':');
+  std::string_view part;
+  while (num_parts < 4 && tok.next(part)) {
+    parts[num_parts++] = part;
+  }
+  switch (to_flag(parts[0])) {
+  case nodelist_flag_t::ina:
+    if (num_parts == 2) {
+      e.hostname_.assign(parts[1].data(), parts[1].size());
+    }
+    break;
+  case nodelist_flag_t::ibn:
+    internet_flag(parts, num_parts, e.binkp_, e.binkp_hostname_, e.binkp_port_);
+    break;
+  case nodelist_flag_t::itn:
+    internet_flag(parts, num_parts, e.telnet_, e.telnet_hostname_, e.telnet_port_);
+    break;
+  case nodelist_flag_t::ivn:
+    internet_flag(parts, num_parts, e.vmodem_, e.vmodem_hostname_, e.vmodem_port_);
+    break;
+  default:
+    // TODO(rushfan): Handle X? flags.
+    break;
   }
-  return false;
 }
 
-static string ToSpaces(const std::string& orig) {
-  string s(orig);
+static void ToSpaces(std::string_view orig, string& s) {
+  s.assign(orig.data(), orig.size());
   std::replace(std::begin(s), std::end(s), '_', ' ');
-  return s;
 }
 
 //static 
-bool NodelistEntry::ParseDataLine(const std::string& data_line, NodelistEntry& e) {
-  if (data_line.front() == ';') {
+bool NodelistEntry::ParseDataLine(std::string_view data_line, NodelistEntry& e) {
+  if (data_line.empty() || data_line.front() == ';') {
     return false;
   }
 
-  vector<string> parts = SplitString(data_line, ",");
-  if (parts.size() < 6) {
+  // The 8 fields before the flags, the baud rate is optional.
+  std::string_view fields[7];
+  int first_field = 0;
+  if (data_line.front() == ',') {
+    // We have no 1st field, default the keyword.
+    first_field = 1;
+  }
+  int num_fields = first_field;
+  FieldTokenizer tok(data_line, ',');
+  std::string_view field;
+  while (num_fields < 7 && tok.next(field)) {
+    fields[num_fields++] = field;
+  }
+  if (num_fields - first_field < 6) {
     return false;
   }
 
-  auto it = parts.cbegin();
-  if (data_line.front() == ',') {
-    // We have no 1st field, default the keyword and skip the iterator.
-    e.keyword_ = NodelistKeyword::node;
-  } else {
-    e.keyword_ = to_keyword(*it++);
-  }
-  e.number_ = to_number<uint16_t>(*it++);
-  e.name_ = ToSpaces(*it++);
-  e.location_ = ToSpaces(*it++);
-  e.sysop_name_ = ToSpaces(*it++);
-  e.phone_number_ = *it++;
-  if (it != parts.end()) {
-    e.baud_rate_ = to_number<unsigned int>(*it++);
-  }
-
-  while (it != parts.end()) {
-    const auto& f = *it++;
-    if (bool_flag(f, "CM", e.cm_)) continue;
-    if (bool_flag(f, "ICM", e.icm_)) continue;
-    if (bool_flag(f, "MO", e.mo_)) continue;
-    if (bool_flag(f, "LO", e.lo_)) continue;
-    if (bool_flag(f, "MN", e.mn_)) continue;
-
-    bool ignore;
-    if (bool_flag(f, "INA", ignore, e.hostname_)) continue;
-    if (internet_flag(f, "IBN", e.binkp_, e.binkp_hostname_, e.binkp_port_)) continue;
-    if (internet_flag(f, "ITN", e.telnet_, e.telnet_hostname_, e.telnet_port_)) continue;
-    if (internet_flag(f, "IVN", e.vmodem_, e.vmodem_hostname_, e.vmodem_port_)) continue;
+  e.keyword_ = to_keyword(fields[0]);
+  e.number_ = parse_number<uint16_t>(fields[1]);
+  ToSpaces(fields[2], e.name_);
+  ToSpaces(fields[3], e.location_);
+  ToSpaces(fields[4], e.sysop_name_);
+  e.phone_number_.assign(fields[5].data(), fields[5].size());
+  if (num_fields > 6) {
+    e.baud_rate_ = parse_number<unsigned int>(fields[6]);
+  }
 
-    // TODO(rushfan): Handle X? flags.
+  while (tok.next(field)) {
+    handle_flag(field, e);
   }
   if (e.binkp_) {
     if (e.binkp_port_ == 0) e.binkp_port_ = 24554;
@@ -163,14 +263,16 @@ bool NodelistEntry::ParseDataLine(const std::string& data_line, NodelistEntry& e
 }
 
 Nodelist::Nodelist(const std::string& path) 
-  : entries_(), initialized_(Load(path)) {}
+  : initialized_(Load(path)) {}
 
 Nodelist::Nodelist(const std::vector<std::string>& lines) 
-  : entries_(), initialized_(Load(lines)) {}
+  : initialized_(Load(lines)) {}
 
 Nodelist::~Nodelist() {}
 
-bool Nodelist::HandleLine(const string& line, uint16_t& zone, uint16_t& region, uint16_t& net, uint16_t& hub) {
+// static
+bool Nodelist::HandleLine(std::string_view line, uint16_t& zone, uint16_t& region, uint16_t& net,
+                          uint16_t& hub, std::vector<NodelistEntry>& entries) {
   if (line.empty()) return true;
   if (line.front() == ';') {
     // TODO(rushfan): Do we care to do anything with this?
@@ -201,7 +303,7 @@ bool Nodelist::HandleLine(const string& line, uint16_t& zone, uint16_t& region,
     e.address_ = address;
     if (zone != 0 && net != 0) {
       // skip malformed entries.
-      entries_.emplace(address, e);
+      entries.emplace_back(std::move(e));
     }
   } break;
   case NodelistKeyword::region:
@@ -222,16 +324,66 @@ bool Nodelist::HandleLine(const string& line, uint16_t& zone, uint16_t& region,
   return true;
 }
 
+static std::tuple<uint16_t, uint16_t, uint16_t> key_of(const FidoAddress& a) {
+  return std::make_tuple(static_cast<uint16_t>(a.zone()), static_cast<uint16_t>(a.net()),
+                         static_cast<uint16_t>(a.node()));
+}
+
+void Nodelist::SortEntries() {
+  // Stable so that the first of any duplicate addresses is the one kept.
+  std::stable_sort(entries_.begin(), entries_.end(),
+                   [](const NodelistEntry& l, const NodelistEntry& r) {
+                     return key_of(l.address_) < key_of(r.address_);
+                   });
+  auto last = std::unique(entries_.begin(), entries_.end(),
+                          [](const NodelistEntry& l, const NodelistEntry& r) {
+                            return key_of(l.address_) == key_of(r.address_);
+                          });
+  entries_.erase(last, entries_.end());
+  num_entries_ = entries_.size();
+  for (const auto& e : entries_) {
+    uint16_t zone, net, node;
+    std::tie(zone, net, node) = key_of(e.address_);
+    AddToRanges(zone, net, node);
+  }
+}
+
+// Must be called in sorted order.
+void Nodelist::AddToRanges(uint16_t zone, uint16_t net, uint16_t node) const {
+  const auto pos = num_ranged_++;
+  if (zones_.empty() || zones_.back() != zone) {
+    zones_.push_back(zone);
+    zone_list_.push_back(zone_t{pos, pos, {}, {}});
+  }
+  auto& z = zone_list_.back();
+  z.last = pos + 1;
+  if (z.nets.empty() || z.nets.back() != net) {
+    z.nets.push_back(net);
+    z.net_list.push_back(net_t{net, pos, {}});
+  }
+  z.net_list.back().nodes.push_back(node);
+}
+
 bool Nodelist::Load(const std::string& path) {
-  TextFile f(path, "rt");
-  if (!f) {
+  auto index = std::make_unique<NodelistIndex>(path);
+  if (index->Open()) {
+    index_ = std::move(index);
+    num_entries_ = index_->size();
+    return true;
+  }
+
+  if (!File::Exists(path)) {
     return false;
   }
-  string line;
-  uint16_t zone = 0, region = 0, net = 0, hub = 0;
-  while (f.ReadLine(&line)) {
-    StringTrim(&line);
-    HandleLine(line, zone, region, net, hub);
+  MemoryMappedFile f(path);
+  if (f.Open()) {
+    entries_ = ParseText(
+        std::string_view(reinterpret_cast<const char*>(f.data()), f.size()), 0);
+    f.Close();
+  }
+  SortEntries();
+  if (!NodelistIndex::Compile(entries_, path)) {
+    LOG(INFO) << "Unable to write the nodelist index for: " << path;
   }
   return true;
 }
@@ -240,74 +392,218 @@ bool Nodelist::Load(const std::vector<std::string>& lines) {
   if (lines.empty()) return false;
   uint16_t zone = 0, region = 0, net = 0, hub = 0;
   for (const auto& raw_line : lines) {
-    auto line = StringTrim(raw_line);
-    HandleLine(line, zone, region, net, hub);
+    HandleLine(trim(raw_line), zone, region, net, hub, entries_);
   }
+  SortEntries();
   return true;
 }
 
-const std::vector<NodelistEntry> Nodelist::entries(uint16_t zone, uint16_t net) const {
+static bool is_chunk_start(std::string_view line) {
+  return starts_with(line, "Zone,") || starts_with(line, "Region,");
+}
+
+// Parses one chunk of the nodelist text, which starts in zone.
+// static
+std::vector<NodelistEntry> Nodelist::ParseChunk(std::string_view text, uint16_t zone) {
   std::vector<NodelistEntry> entries;
-  for (const auto& e : entries_) {
-    if (e.first.zone() == zone && e.first.net() == net) {
-      entries.push_back(e.second);
+  // A little over the average size of a nodelist line.
+  entries.reserve(text.size() / 64);
+  uint16_t region = 0, net = 0, hub = 0;
+  std::size_t pos = 0;
+  while (pos < text.size()) {
+    auto end = text.find('\n', pos);
+    if (end == std::string_view::npos) {
+      end = text.size();
     }
+    HandleLine(trim(text.substr(pos, end - pos)), zone, region, net, hub, entries);
+    pos = end + 1;
   }
   return entries;
 }
 
-const std::vector<NodelistEntry> Nodelist::entries(uint16_t zone) const {
-  std::vector<NodelistEntry> entries;
-  for (const auto& e : entries_) {
-    if (e.first.zone() == zone) {
-      entries.push_back(e.second);
+// static
+std::vector<NodelistEntry> Nodelist::ParseText(std::string_view text, int num_threads) {
+  if (num_threads <= 0) {
+    num_threads = std::max<int>(1, std::thread::hardware_concurrency());
+  }
+
+  // Split the text into about num_threads chunks, each starting at a Zone or
+  // Region line, so that only the zone needs to be carried into a chunk.
+  std::vector<std::pair<std::size_t, uint16_t>> starts{{0, 0}};
+  const auto chunk_size = text.size() / num_threads + 1;
+  for (std::size_t target = chunk_size; target < text.size(); target += chunk_size) {
+    auto pos = text.find('\n', std::max(target, starts.back().first) - 1);
+    while (pos != std::string_view::npos && !is_chunk_start(text.substr(pos + 1, 7))) {
+      pos = text.find('\n', pos + 1);
+    }
+    if (pos == std::string_view::npos) {
+      break;
     }
+    ++pos;
+    const auto zone_line = text.rfind("\nZone,", pos - 1);
+    uint16_t zone = 0;
+    if (zone_line != std::string_view::npos) {
+      zone = parse_number<uint16_t>(text.substr(zone_line + 6, 6));
+    } else if (starts_with(text, "Zone,")) {
+      zone = parse_number<uint16_t>(text.substr(5, 6));
+    }
+    starts.emplace_back(pos, zone);
+  }
+  starts.emplace_back(text.size(), 0);
+
+  std::vector<std::future<std::vector<NodelistEntry>>> chunks;
+  for (std::size_t i = 1; i + 1 < starts.size(); i++) {
+    const auto chunk = text.substr(starts[i].first, starts[i + 1].first - starts[i].first);
+    chunks.emplace_back(std::async(std::launch::async, ParseChunk, chunk, starts[i].second));
+  }
+  // Parse the first chunk on this thread.
+  auto entries = ParseChunk(text.substr(0, starts[1].first), 0);
+  for (auto& c : chunks) {
+    auto more = c.get();
+    entries.insert(entries.end(), std::make_move_iterator(more.begin()),
+                   std::make_move_iterator(more.end()));
   }
   return entries;
 }
 
-const std::vector<uint16_t> Nodelist::zones() const {
-  std::set<uint16_t> s;
-  for (const auto& e : entries_) {
-    s.emplace(e.first.zone());
+const NodelistEntry* Nodelist::entry_array() const {
+  if (index_ && entries_.size() != num_entries_) {
+    entries_.reserve(num_entries_);
+    for (const auto& r : *index_) {
+      entries_.push_back(index_->ToEntry(r));
+    }
+  }
+  return entries_.data();
+}
+
+void Nodelist::BuildRanges() const {
+  if (!index_ || num_ranged_ == num_entries_) {
+    return;
   }
-  std::vector<uint16_t> zones;
-  for (const auto& n : s) {
-    zones.emplace_back(n);
+  // The index is already sorted.
+  for (const auto& r : *index_) {
+    AddToRanges(r.zone, r.net, r.node);
   }
-  return zones;
 }
 
-const std::vector<uint16_t> Nodelist::nets(uint16_t zone) const {
-  std::set<uint16_t> s;
-  for (const auto& e : entries_) {
-    if (e.first.zone() == zone) {
-      s.emplace(e.first.net());
-    }
+const Nodelist::zone_t* Nodelist::find_zone(uint16_t zone) const {
+  BuildRanges();
+  auto it = std::lower_bound(zones_.begin(), zones_.end(), zone);
+  if (it == zones_.end() || *it != zone) {
+    return nullptr;
   }
-  std::vector<uint16_t> nets;
-  for (const auto& n : s) {
-    nets.emplace_back(n);
+  return &zone_list_[std::distance(zones_.begin(), it)];
+}
+
+const Nodelist::net_t* Nodelist::find_net(uint16_t zone, uint16_t net) const {
+  const auto* z = find_zone(zone);
+  if (z == nullptr) {
+    return nullptr;
   }
-  return nets;
+  auto it = std::lower_bound(z->nets.begin(), z->nets.end(), net);
+  if (it == z->nets.end() || *it != net) {
+    return nullptr;
+  }
+  return &z->net_list[std::distance(z->nets.begin(), it)];
 }
 
-const std::vector<uint16_t> Nodelist::nodes(uint16_t zone, uint16_t net) const {
-  std::vector<uint16_t> nodes;
-  for (const auto& e : entries_) {
-    if (e.first.zone() == zone && e.first.net() == net) {
-      nodes.emplace_back(e.first.node());
+bool Nodelist::find_position(const FidoAddress& a, std::size_t& pos) const {
+  if (a.point() != 0 || !a.domain().empty()) {
+    return false;
+  }
+  if (index_) {
+    const auto* r = index_->find(static_cast<uint16_t>(a.zone()), static_cast<uint16_t>(a.net()),
+                                 static_cast<uint16_t>(a.node()));
+    if (r == nullptr) {
+      return false;
     }
+    pos = std::distance(index_->begin(), r);
+    return true;
+  }
+  const auto* n = find_net(static_cast<uint16_t>(a.zone()), static_cast<uint16_t>(a.net()));
+  if (n == nullptr) {
+    return false;
+  }
+  const auto node = static_cast<uint16_t>(a.node());
+  auto it = std::lower_bound(n->nodes.begin(), n->nodes.end(), node);
+  if (it == n->nodes.end() || *it != node) {
+    return false;
+  }
+  pos = n->first + std::distance(n->nodes.begin(), it);
+  return true;
+}
+
+const NodelistEntry& Nodelist::entry(const FidoAddress& a) const {
+  std::size_t pos;
+  if (!find_position(a, pos)) {
+    throw std::out_of_range(StrCat("No nodelist entry for: ", a.as_string()));
+  }
+  return entry_array()[pos];
+}
+
+bool Nodelist::contains(const FidoAddress& a) const {
+  std::size_t pos;
+  return find_position(a, pos);
+}
+
+NodelistRange<NodelistEntry> Nodelist::entries() const {
+  const auto* e = entry_array();
+  return NodelistRange<NodelistEntry>(e, e + num_entries_);
+}
+
+NodelistRange<NodelistEntry> Nodelist::entries(uint16_t zone, uint16_t net) const {
+  if (index_) {
+    const auto r = index_->range(zone, net);
+    const auto* e = entry_array();
+    return NodelistRange<NodelistEntry>(e + std::distance(index_->begin(), r.first),
+                                        e + std::distance(index_->begin(), r.second));
+  }
+  const auto* n = find_net(zone, net);
+  if (n == nullptr) {
+    return {};
   }
-  return nodes;
+  const auto* e = entry_array() + n->first;
+  return NodelistRange<NodelistEntry>(e, e + n->nodes.size());
+}
+
+NodelistRange<NodelistEntry> Nodelist::entries(uint16_t zone) const {
+  if (index_) {
+    const auto r = index_->range(zone);
+    const auto* e = entry_array();
+    return NodelistRange<NodelistEntry>(e + std::distance(index_->begin(), r.first),
+                                        e + std::distance(index_->begin(), r.second));
+  }
+  const auto* z = find_zone(zone);
+  if (z == nullptr) {
+    return {};
+  }
+  const auto* e = entry_array();
+  return NodelistRange<NodelistEntry>(e + z->first, e + z->last);
+}
+
+const std::vector<uint16_t>& Nodelist::zones() const {
+  BuildRanges();
+  return zones_;
+}
+
+const std::vector<uint16_t>& Nodelist::nets(uint16_t zone) const {
+  static const std::vector<uint16_t> empty;
+  const auto* z = find_zone(zone);
+  return z == nullptr ? empty : z->nets;
+}
+
+const std::vector<uint16_t>& Nodelist::nodes(uint16_t zone, uint16_t net) const {
+  static const std::vector<uint16_t> empty;
+  const auto* n = find_net(zone, net);
+  return n == nullptr ? empty : n->nodes;
 }
 
 const NodelistEntry* Nodelist::entry(uint16_t zone, uint16_t net, uint16_t node) {
-  FidoAddress a(zone, net, node, 0, "");
-  if (!wwiv::stl::contains(entries_, a)) {
+  std::size_t pos;
+  if (!find_position(FidoAddress(zone, net, node, 0, ""), pos)) {
     return nullptr;
   }
-  return &entries_.at(a);
+  return entry_array() + pos;
 }
 
 static int year_of(time_t t) {
@@ -346,6 +642,10 @@ std::string Nodelist::FindLatestNodelist(const std::string& dir, const std::stri
   std::map<int, int> extension_year;
   FindFiles fnd(filespec, FindFilesType::files);
   for (const auto& ff : fnd) {
+    if (ends_with(ff.name, ".idx") || ends_with(ff.name, ".idx.tmp")) {
+      // Skip our compiled nodelist indexes.
+      continue;
+    }
     File f(FilePath(dir, ff.name));
     extension_year.emplace(extension_number(f.GetName()), year_of(f.creation_time()));
   }
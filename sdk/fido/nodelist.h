@@ -18,10 +18,12 @@
 #ifndef __INCLUDED_SDK_FIDO_NODELIST_H__
 #define __INCLUDED_SDK_FIDO_NODELIST_H__
 
+#include <cstddef>
 #include <cstdint>
-#include <map>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "core/stl.h"
@@ -38,6 +40,8 @@ namespace wwiv {
 namespace sdk {
 namespace fido {
 
+class NodelistIndex;
+
 // The 1st entry of the 8 mandatory ones is the keyword.
 enum class NodelistKeyword {
   zone, region, host, hub, pvt, down, node
@@ -51,7 +55,7 @@ public:
   NodelistEntry() {}
   virtual ~NodelistEntry() {}
 
-  static bool ParseDataLine(const std::string& data_line, NodelistEntry& e);
+  static bool ParseDataLine(std::string_view data_line, NodelistEntry& e);
 
   // TODO(rushfan): private
 public:
@@ -102,8 +106,39 @@ public:
   // IP, IFC, IFT, IVM, IN04
 };
 
+/**
+ * A non owning view of a contiguous run of T inside of a Nodelist. It is
+ * only valid for as long as the Nodelist it came from.
+ */
+template <typename T>
+class NodelistRange {
+public:
+  NodelistRange() noexcept {}
+  NodelistRange(const T* first, const T* last) noexcept : first_(first), last_(last) {}
+
+  const T* begin() const noexcept { return first_; }
+  const T* end() const noexcept { return last_; }
+  std::size_t size() const noexcept { return static_cast<std::size_t>(last_ - first_); }
+  bool empty() const noexcept { return first_ == last_; }
+  const T& front() const { return *first_; }
+  const T& operator[](std::size_t n) const { return first_[n]; }
+
+private:
+  const T* first_{nullptr};
+  const T* last_{nullptr};
+};
+
 /**
  Representes a FidoNet NodeList as defined in FRL-1003.
+
+ Entries are stored in one array sorted by zone:net/node, with a
+ zone -> net -> node hierarchy over it, so lookups are O(log n) and the
+ range accessors return views into the array without copying.
+
+ When loaded from a file, the compiled NodelistIndex for it is used if it is
+ up to date, otherwise the text is parsed and the index is written for the
+ next run. When using the index, lookups search the index directly and the
+ NodelistEntry array and hierarchy are only created when first needed.
  */
 class Nodelist {
 public:
@@ -115,24 +150,64 @@ public:
   bool initialized() const { return initialized_; }
   explicit operator bool() const { return initialized_; }
 
-  const NodelistEntry& entry(const FidoAddress& a) const { return entries_.at(a); }
-  bool contains(const FidoAddress& a) const { return wwiv::stl::contains(entries_, a); }
-  const std::map<FidoAddress, NodelistEntry> entries() const { return entries_; }
-  const std::vector<NodelistEntry> entries(uint16_t zone, uint16_t net) const;
-  const std::vector<NodelistEntry> entries(uint16_t zone) const;
-  const std::vector<uint16_t> zones() const;
-  const std::vector<uint16_t> nets(uint16_t zone) const;
-  const std::vector<uint16_t> nodes(uint16_t zone, uint16_t net) const;
+  /** Returns the entry for a, throws std::out_of_range if it does not exist. */
+  const NodelistEntry& entry(const FidoAddress& a) const;
+  bool contains(const FidoAddress& a) const;
+  /** All entries, sorted by address. */
+  NodelistRange<NodelistEntry> entries() const;
+  NodelistRange<NodelistEntry> entries(uint16_t zone, uint16_t net) const;
+  NodelistRange<NodelistEntry> entries(uint16_t zone) const;
+  const std::vector<uint16_t>& zones() const;
+  const std::vector<uint16_t>& nets(uint16_t zone) const;
+  const std::vector<uint16_t>& nodes(uint16_t zone, uint16_t net) const;
   const NodelistEntry* entry(uint16_t zone, uint16_t net, uint16_t node);
 
   static std::string FindLatestNodelist(const std::string& dir, const std::string& base);
+  /**
+   * Parses the nodelist text on num_threads threads, or one per CPU when
+   * num_threads is 0. The entries are returned in the order of the text.
+   */
+  static std::vector<NodelistEntry> ParseText(std::string_view text, int num_threads);
 
 private:
+  // The nodes of one net, these are entries_[first, first + nodes.size()).
+  struct net_t {
+    uint16_t net;
+    std::size_t first;
+    std::vector<uint16_t> nodes;
+  };
+  // The nets of one zone, these are entries_[first, last).
+  struct zone_t {
+    std::size_t first;
+    std::size_t last;
+    // Parallel to net_list.
+    std::vector<uint16_t> nets;
+    std::vector<net_t> net_list;
+  };
+
   bool Load(const std::string& path);
   bool Load(const std::vector<std::string>& lines);
-
-  bool HandleLine(const std::string& line, uint16_t& zone, uint16_t& region, uint16_t& net, uint16_t& hub );
-  std::map<FidoAddress, NodelistEntry> entries_;
+  void SortEntries();
+  void AddToRanges(uint16_t zone, uint16_t net, uint16_t node) const;
+  const NodelistEntry* entry_array() const;
+  void BuildRanges() const;
+  const zone_t* find_zone(uint16_t zone) const;
+  const net_t* find_net(uint16_t zone, uint16_t net) const;
+  bool find_position(const FidoAddress& a, std::size_t& pos) const;
+
+  static std::vector<NodelistEntry> ParseChunk(std::string_view text, uint16_t zone);
+  static bool HandleLine(std::string_view line, uint16_t& zone, uint16_t& region, uint16_t& net,
+                         uint16_t& hub, std::vector<NodelistEntry>& entries);
+
+
+  // Sorted by zone, net and node. Created on demand when using index_.
+  mutable std::vector<NodelistEntry> entries_;
+  // Parallel to zone_list_. Created on demand when using index_.
+  mutable std::vector<uint16_t> zones_;
+  mutable std::vector<zone_t> zone_list_;
+  mutable std::size_t num_ranged_ = 0;
+  std::size_t num_entries_ = 0;
+  std::unique_ptr<NodelistIndex> index_;
   bool initialized_ = false;
 };
 
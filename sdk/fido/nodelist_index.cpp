@@ -0,0 +1,306 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "sdk/fido/nodelist_index.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "core/crc32.h"
+#include "core/file.h"
+#include "core/log.h"
+#include "core/strings.h"
+
+using std::string;
+using std::vector;
+using namespace wwiv::core;
+using namespace wwiv::strings;
+
+namespace wwiv {
+namespace sdk {
+namespace fido {
+
+static constexpr char kSignature[4] = {'W', 'N', 'L', 'X'};
+static constexpr uint16_t kVersion = 1;
+
+static std::tuple<uint16_t, uint16_t, uint16_t> key_of(const nodelist_index_rec_t& r) {
+  return std::make_tuple(r.zone, r.net, r.node);
+}
+
+static uint16_t to_flags(const NodelistEntry& e) {
+  uint16_t f = 0;
+  if (e.cm_) f |= nodelist_index_flag_cm;
+  if (e.icm_) f |= nodelist_index_flag_icm;
+  if (e.mo_) f |= nodelist_index_flag_mo;
+  if (e.lo_) f |= nodelist_index_flag_lo;
+  if (e.mn_) f |= nodelist_index_flag_mn;
+  if (e.bark_file_) f |= nodelist_index_flag_bark_file;
+  if (e.bark_update_) f |= nodelist_index_flag_bark_update;
+  if (e.wazoo_file_) f |= nodelist_index_flag_wazoo_file;
+  if (e.wazoo_update_) f |= nodelist_index_flag_wazoo_update;
+  if (e.binkp_) f |= nodelist_index_flag_binkp;
+  if (e.telnet_) f |= nodelist_index_flag_telnet;
+  if (e.vmodem_) f |= nodelist_index_flag_vmodem;
+  return f;
+}
+
+/**
+ * Builds the string pool, each distinct string is only stored once.
+ * Offset 0 is always the empty string.
+ */
+class StringPool {
+public:
+  StringPool() { pool_.push_back('\0'); offsets_.emplace("", 0); }
+
+  uint32_t intern(const string& s) {
+    auto it = offsets_.find(s);
+    if (it != offsets_.end()) {
+      return it->second;
+    }
+    const auto offset = static_cast<uint32_t>(pool_.size());
+    pool_.insert(pool_.end(), s.begin(), s.end());
+    pool_.push_back('\0');
+    offsets_.emplace(s, offset);
+    return offset;
+  }
+
+  const vector<char>& pool() const noexcept { return pool_; }
+
+private:
+  vector<char> pool_;
+  std::unordered_map<string, uint32_t> offsets_;
+};
+
+NodelistIndex::NodelistIndex(const std::string& nodelist_path)
+    : nodelist_path_(nodelist_path), file_(index_filename(nodelist_path)) {}
+
+NodelistIndex::~NodelistIndex() {}
+
+// static
+std::string NodelistIndex::index_filename(const std::string& nodelist_path) {
+  return StrCat(nodelist_path, ".idx");
+}
+
+bool NodelistIndex::Open() {
+  records_ = nullptr;
+  num_records_ = 0;
+  pool_ = nullptr;
+  pool_size_ = 0;
+  if (!file_.Open()) {
+    return false;
+  }
+  if (file_.size() < sizeof(nodelist_index_header_t)) {
+    LOG(INFO) << "Nodelist index is too short: " << file_.full_pathname();
+    return false;
+  }
+  nodelist_index_header_t h{};
+  memcpy(&h, file_.data(), sizeof(nodelist_index_header_t));
+  if (memcmp(h.signature, kSignature, sizeof(kSignature)) != 0 || h.version != kVersion ||
+      h.record_size != sizeof(nodelist_index_rec_t)) {
+    LOG(INFO) << "Unknown nodelist index format: " << file_.full_pathname();
+    return false;
+  }
+  const auto records_size = static_cast<std::size_t>(h.num_records) * sizeof(nodelist_index_rec_t);
+  if (h.pool_size == 0 ||
+      file_.size() != sizeof(nodelist_index_header_t) + records_size + h.pool_size) {
+    LOG(INFO) << "Nodelist index is truncated: " << file_.full_pathname();
+    return false;
+  }
+  const auto* data = file_.data() + sizeof(nodelist_index_header_t);
+  if (data[records_size + h.pool_size - 1] != '\0') {
+    LOG(INFO) << "Nodelist index string pool is malformed: " << file_.full_pathname();
+    return false;
+  }
+
+  File source(nodelist_path_);
+  if (static_cast<uint64_t>(source.length()) != h.source_size ||
+      (static_cast<int64_t>(source.last_write_time()) != h.source_mtime &&
+       crc32file(nodelist_path_) != h.source_crc32)) {
+    VLOG(1) << "Nodelist index is out of date: " << file_.full_pathname();
+    return false;
+  }
+
+  records_ = reinterpret_cast<const nodelist_index_rec_t*>(data);
+  num_records_ = h.num_records;
+  pool_ = reinterpret_cast<const char*>(data + records_size);
+  pool_size_ = h.pool_size;
+  return true;
+}
+
+const nodelist_index_rec_t* NodelistIndex::find(uint16_t zone, uint16_t net, uint16_t node) const {
+  const auto key = std::make_tuple(zone, net, node);
+  auto it = std::lower_bound(begin(), end(), key, [](const nodelist_index_rec_t& r, const auto& k) {
+    return key_of(r) < k;
+  });
+  if (it == end() || key_of(*it) != key) {
+    return nullptr;
+  }
+  return it;
+}
+
+std::pair<const nodelist_index_rec_t*, const nodelist_index_rec_t*>
+NodelistIndex::range(uint16_t zone) const {
+  auto first = std::lower_bound(begin(), end(), zone, [](const nodelist_index_rec_t& r, uint16_t z) {
+    return r.zone < z;
+  });
+  auto last = std::upper_bound(first, end(), zone, [](uint16_t z, const nodelist_index_rec_t& r) {
+    return z < r.zone;
+  });
+  return std::make_pair(first, last);
+}
+
+std::pair<const nodelist_index_rec_t*, const nodelist_index_rec_t*>
+NodelistIndex::range(uint16_t zone, uint16_t net) const {
+  const auto key = std::make_pair(zone, net);
+  auto first = std::lower_bound(begin(), end(), key, [](const nodelist_index_rec_t& r, const auto& k) {
+    return std::make_pair(r.zone, r.net) < k;
+  });
+  auto last = std::upper_bound(first, end(), key, [](const auto& k, const nodelist_index_rec_t& r) {
+    return k < std::make_pair(r.zone, r.net);
+  });
+  return std::make_pair(first, last);
+}
+
+const char* NodelistIndex::string_at(uint32_t offset) const noexcept {
+  if (offset >= pool_size_) {
+    return "";
+  }
+  return pool_ + offset;
+}
+
+NodelistEntry NodelistIndex::ToEntry(const nodelist_index_rec_t& r) const {
+  NodelistEntry e{};
+  e.address_ = FidoAddress(static_cast<int16_t>(r.zone), static_cast<int16_t>(r.net),
+                           static_cast<int16_t>(r.node), 0, "");
+  e.keyword_ = static_cast<NodelistKeyword>(r.keyword);
+  e.number_ = r.node;
+  e.name_ = string_at(r.name);
+  e.location_ = string_at(r.location);
+  e.sysop_name_ = string_at(r.sysop_name);
+  e.phone_number_ = string_at(r.phone_number);
+  e.baud_rate_ = r.baud_rate;
+  e.cm_ = (r.flags & nodelist_index_flag_cm) != 0;
+  e.icm_ = (r.flags & nodelist_index_flag_icm) != 0;
+  e.mo_ = (r.flags & nodelist_index_flag_mo) != 0;
+  e.lo_ = (r.flags & nodelist_index_flag_lo) != 0;
+  e.mn_ = (r.flags & nodelist_index_flag_mn) != 0;
+  e.bark_file_ = (r.flags & nodelist_index_flag_bark_file) != 0;
+  e.bark_update_ = (r.flags & nodelist_index_flag_bark_update) != 0;
+  e.wazoo_file_ = (r.flags & nodelist_index_flag_wazoo_file) != 0;
+  e.wazoo_update_ = (r.flags & nodelist_index_flag_wazoo_update) != 0;
+  e.hostname_ = string_at(r.hostname);
+  e.binkp_ = (r.flags & nodelist_index_flag_binkp) != 0;
+  e.binkp_port_ = r.binkp_port;
+  e.binkp_hostname_ = string_at(r.binkp_hostname);
+  e.telnet_ = (r.flags & nodelist_index_flag_telnet) != 0;
+  e.telnet_port_ = r.telnet_port;
+  e.telnet_hostname_ = string_at(r.telnet_hostname);
+  e.vmodem_ = (r.flags & nodelist_index_flag_vmodem) != 0;
+  e.vmodem_port_ = r.vmodem_port;
+  e.vmodem_hostname_ = string_at(r.vmodem_hostname);
+  return e;
+}
+
+// static
+bool NodelistIndex::Compile(const std::vector<NodelistEntry>& entries,
+                            const std::string& nodelist_path) {
+  File source(nodelist_path);
+  if (!source.Exists()) {
+    return false;
+  }
+
+  StringPool pool;
+  vector<nodelist_index_rec_t> records;
+  records.reserve(entries.size());
+  for (const auto& e : entries) {
+    const auto& a = e.address_;
+    nodelist_index_rec_t r{};
+    r.zone = static_cast<uint16_t>(a.zone());
+    r.net = static_cast<uint16_t>(a.net());
+    r.node = static_cast<uint16_t>(a.node());
+    r.keyword = static_cast<uint8_t>(e.keyword_);
+    r.flags = to_flags(e);
+    r.binkp_port = e.binkp_port_;
+    r.telnet_port = e.telnet_port_;
+    r.vmodem_port = e.vmodem_port_;
+    r.baud_rate = e.baud_rate_;
+    r.name = pool.intern(e.name_);
+    r.location = pool.intern(e.location_);
+    r.sysop_name = pool.intern(e.sysop_name_);
+    r.phone_number = pool.intern(e.phone_number_);
+    r.hostname = pool.intern(e.hostname_);
+    r.binkp_hostname = pool.intern(e.binkp_hostname_);
+    r.telnet_hostname = pool.intern(e.telnet_hostname_);
+    r.vmodem_hostname = pool.intern(e.vmodem_hostname_);
+    records.push_back(r);
+  }
+  // The index is searched by the unsigned zone, net and node.
+  std::sort(records.begin(), records.end(),
+            [](const nodelist_index_rec_t& l, const nodelist_index_rec_t& r) {
+              return key_of(l) < key_of(r);
+            });
+
+  nodelist_index_header_t h{};
+  memcpy(h.signature, kSignature, sizeof(kSignature));
+  h.version = kVersion;
+  h.record_size = sizeof(nodelist_index_rec_t);
+  h.num_records = static_cast<uint32_t>(records.size());
+  h.pool_size = static_cast<uint32_t>(pool.pool().size());
+  h.source_size = static_cast<uint64_t>(source.length());
+  h.source_mtime = static_cast<int64_t>(source.last_write_time());
+  h.source_crc32 = crc32file(nodelist_path);
+
+  // Write to a temporary file first so that nobody maps a partial index.
+  const auto index_path = index_filename(nodelist_path);
+  const auto temp_path = StrCat(index_path, ".tmp");
+  {
+    File f(temp_path);
+    if (!f.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite | File::modeTruncate,
+                File::shareDenyReadWrite)) {
+      LOG(ERROR) << "Unable to create nodelist index: " << temp_path;
+      return false;
+    }
+    const auto records_size = records.size() * sizeof(nodelist_index_rec_t);
+    if (f.Write(&h, sizeof(h)) != static_cast<ssize_t>(sizeof(h)) ||
+        (records_size > 0 &&
+         f.Write(&records[0], records_size) != static_cast<ssize_t>(records_size)) ||
+        f.Write(&pool.pool()[0], h.pool_size) != static_cast<ssize_t>(h.pool_size)) {
+      LOG(ERROR) << "Unable to write nodelist index: " << temp_path;
+      f.Close();
+      File::Remove(temp_path);
+      return false;
+    }
+  }
+  if (!File::Rename(temp_path, index_path)) {
+    // Windows won't rename over an existing file.
+    File::Remove(index_path);
+    if (!File::Rename(temp_path, index_path)) {
+      LOG(ERROR) << "Unable to rename " << temp_path << " to " << index_path;
+      File::Remove(temp_path);
+      return false;
+    }
+  }
+  return true;
+}
+
+}  // namespace fido
+}  // namespace sdk
+}  // namespace wwiv
@@ -0,0 +1,169 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef __INCLUDED_SDK_FIDO_NODELIST_INDEX_H__
+#define __INCLUDED_SDK_FIDO_NODELIST_INDEX_H__
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "core/mmap_file.h"
+#include "sdk/fido/fido_address.h"
+#include "sdk/fido/nodelist.h"
+
+/**
+ * A compiled, binary form of a FidoNet nodelist.
+ *
+ * The index is written next to the nodelist as NODELIST.nnn.idx and is laid
+ * out as a nodelist_index_header_t, followed by num_records fixed size
+ * nodelist_index_rec_t records sorted by zone:net/node, followed by a pool
+ * of NUL terminated strings.  Each distinct string is stored once in the
+ * pool and records refer to it by offset.
+ *
+ * The header holds the size, modification time and CRC-32 of the nodelist
+ * text it was compiled from, an index that does not match its nodelist is
+ * never used.  The CRC-32 is only checked when the modification time differs
+ * so that the common case does not need to read the nodelist text.
+ */
+
+namespace wwiv {
+namespace sdk {
+namespace fido {
+
+#pragma pack(push, 1)
+
+struct nodelist_index_header_t {
+  // "WNLX"
+  char signature[4];
+  uint16_t version;
+  // sizeof(nodelist_index_rec_t)
+  uint16_t record_size;
+  uint32_t num_records;
+  uint32_t pool_size;
+  uint64_t source_size;
+  int64_t source_mtime;
+  uint32_t source_crc32;
+  uint32_t reserved;
+};
+
+struct nodelist_index_rec_t {
+  uint16_t zone;
+  uint16_t net;
+  uint16_t node;
+  // NodelistKeyword
+  uint8_t keyword;
+  uint8_t reserved;
+  // nodelist_index_flag_* bits.
+  uint16_t flags;
+  uint16_t binkp_port;
+  uint16_t telnet_port;
+  uint16_t vmodem_port;
+  uint32_t baud_rate;
+  // Offsets into the string pool.
+  uint32_t name;
+  uint32_t location;
+  uint32_t sysop_name;
+  uint32_t phone_number;
+  uint32_t hostname;
+  uint32_t binkp_hostname;
+  uint32_t telnet_hostname;
+  uint32_t vmodem_hostname;
+};
+
+#pragma pack(pop)
+
+static_assert(sizeof(nodelist_index_header_t) == 40, "nodelist_index_header_t != 40 bytes");
+static_assert(sizeof(nodelist_index_rec_t) == 52, "nodelist_index_rec_t != 52 bytes");
+
+constexpr uint16_t nodelist_index_flag_cm = 0x0001;
+constexpr uint16_t nodelist_index_flag_icm = 0x0002;
+constexpr uint16_t nodelist_index_flag_mo = 0x0004;
+constexpr uint16_t nodelist_index_flag_lo = 0x0008;
+constexpr uint16_t nodelist_index_flag_mn = 0x0010;
+constexpr uint16_t nodelist_index_flag_bark_file = 0x0020;
+constexpr uint16_t nodelist_index_flag_bark_update = 0x0040;
+constexpr uint16_t nodelist_index_flag_wazoo_file = 0x0080;
+constexpr uint16_t nodelist_index_flag_wazoo_update = 0x0100;
+constexpr uint16_t nodelist_index_flag_binkp = 0x0200;
+constexpr uint16_t nodelist_index_flag_telnet = 0x0400;
+constexpr uint16_t nodelist_index_flag_vmodem = 0x0800;
+
+/**
+ * Read only, memory mapped view of a compiled nodelist index.
+ *
+ * Example:
+ *   NodelistIndex index("/wwiv/fido/NODELIST.123");
+ *   if (index.Open()) {
+ *     const auto* r = index.find(1, 261, 1);
+ *   }
+ */
+class NodelistIndex final {
+public:
+  /** Creates an index view for the nodelist text at nodelist_path. */
+  explicit NodelistIndex(const std::string& nodelist_path);
+  NodelistIndex(const NodelistIndex&) = delete;
+  NodelistIndex& operator=(const NodelistIndex&) = delete;
+  ~NodelistIndex();
+
+  /**
+   * Maps the index, returns false if it does not exist, is malformed, or
+   * was compiled from a different version of the nodelist.
+   */
+  bool Open();
+  bool IsOpen() const noexcept { return records_ != nullptr; }
+
+  /** Number of records in the index. */
+  std::size_t size() const noexcept { return num_records_; }
+  const nodelist_index_rec_t* begin() const noexcept { return records_; }
+  const nodelist_index_rec_t* end() const noexcept { return records_ + num_records_; }
+
+  /** Returns the record for zone:net/node or nullptr. */
+  const nodelist_index_rec_t* find(uint16_t zone, uint16_t net, uint16_t node) const;
+  /** Returns the [first, last) run of records in zone. */
+  std::pair<const nodelist_index_rec_t*, const nodelist_index_rec_t*> range(uint16_t zone) const;
+  /** Returns the [first, last) run of records in zone:net. */
+  std::pair<const nodelist_index_rec_t*, const nodelist_index_rec_t*> range(uint16_t zone,
+                                                                             uint16_t net) const;
+  /** Returns the string at offset in the string pool. */
+  const char* string_at(uint32_t offset) const noexcept;
+  /** Creates a NodelistEntry from a record in this index. */
+  NodelistEntry ToEntry(const nodelist_index_rec_t& r) const;
+
+  /** The filename of the index for the nodelist text at nodelist_path. */
+  static std::string index_filename(const std::string& nodelist_path);
+  /**
+   * Writes the index for entries, which must have been parsed from the
+   * nodelist text at nodelist_path.
+   */
+  static bool Compile(const std::vector<NodelistEntry>& entries, const std::string& nodelist_path);
+
+private:
+  const std::string nodelist_path_;
+  wwiv::core::MemoryMappedFile file_;
+  const nodelist_index_rec_t* records_{nullptr};
+  std::size_t num_records_{0};
+  const char* pool_{nullptr};
+  uint32_t pool_size_{0};
+};
+
+}  // namespace fido
+}  // namespace sdk
+}  // namespace wwiv
+
+#endif  // __INCLUDED_SDK_FIDO_NODELIST_INDEX_H__
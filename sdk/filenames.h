@@ -34,6 +34,7 @@
 #define BBSDATA_IND "bbsdata.ind"
 #define BBSDATA_REG "bbsdata.reg"
 #define BBSDATA_ROU "bbsdata.rou"
+#define BBSDATA_RTE "bbsdata.rte"
 #define BBSLIST_NET "bbslist.net"
 
 #define BBSLIST_MSG "bbslist.msg"
@@ -128,6 +129,8 @@
 
 // FTN style message IDs
 #define MSGDUPE_DAT "msgdupe.dat"
+#define MSGDUPE_IDX "msgdupe.idx"
+#define MSGDUPE_SEM "msgdupe.sem"
 #define MSGID_DAT "msgid.dat"
 
 // Used by QBBS style editors.
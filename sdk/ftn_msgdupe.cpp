@@ -18,15 +18,22 @@
 #include "sdk/ftn_msgdupe.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdint>
+#include <cstring>
 #include <ctime>
+#include <memory>
+#include <sstream>
 #include <string>
 #include <vector>
 
 #include "core/crc32.h"
 #include "core/datafile.h"
 #include "core/file.h"
-#include "core/stl.h"
+#include "core/log.h"
+#include "core/mmap_file.h"
+#include "core/semaphore_file.h"
+#include "core/strings.h"
 #include "sdk/config.h"
 #include "sdk/fido/fido_packets.h"
 #include "sdk/fido/fido_util.h"
@@ -35,76 +42,320 @@
 
 using std::string;
 using namespace wwiv::core;
-using namespace wwiv::stl;
 using namespace wwiv::sdk::fido;
 using namespace wwiv::strings;
 
 namespace wwiv {
 namespace sdk {
 
-FtnMessageDupe::FtnMessageDupe(const Config& config) : FtnMessageDupe(config.datadir(), true) {}
+namespace {
 
-FtnMessageDupe::FtnMessageDupe(const std::string& datadir, bool use_filesystem)
-    : datadir_(datadir), use_filesystem_(use_filesystem) {
+constexpr char kMsgDupeSignature[4] = {'W', 'M', 'D', 'X'};
+constexpr uint16_t kMsgDupeVersion = 1;
+// Keeps the table sizes within a uint32_t.
+constexpr uint32_t kMaxCapacity = 1u << 28;
+
+// Keeps each hash table at most half full.
+uint32_t table_size_for(uint32_t capacity) {
+  uint32_t n = 16;
+  while (n < capacity * 2) {
+    n <<= 1;
+  }
+  return n;
+}
+
+std::size_t file_size_for(uint32_t capacity, uint32_t table_size) {
+  return sizeof(msgdupe_header_t) + static_cast<std::size_t>(capacity) * sizeof(msgids) +
+         2 * static_cast<std::size_t>(table_size) * sizeof(uint32_t);
+}
+
+uint32_t bucket_for(uint32_t key, uint32_t mask) {
+  return static_cast<uint32_t>((key * UINT64_C(0x9E3779B97F4A7C15)) >> 32) & mask;
+}
+
+/**
+ * Linear probing hash table of ring slots keyed by one field of the entry
+ * in that slot.  Removal shifts later entries back instead of leaving
+ * tombstones, since every add past capacity also removes an entry.
+ */
+struct DupeTable {
+  msgids* ring;
+  uint32_t* buckets;
+  uint32_t mask;
+  uint32_t msgids::*field;
+
+  uint32_t key_at(uint32_t bucket) const { return ring[buckets[bucket] - 1].*field; }
+
+  bool contains(uint32_t key) const {
+    for (auto i = bucket_for(key, mask); buckets[i] != 0; i = (i + 1) & mask) {
+      if (key_at(i) == key) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /** Finds the slot holding an entry equal to e. */
+  bool find(const msgids& e, uint32_t& slot) const {
+    for (auto i = bucket_for(e.*field, mask); buckets[i] != 0; i = (i + 1) & mask) {
+      const auto& r = ring[buckets[i] - 1];
+      if (r.header == e.header && r.msgid == e.msgid) {
+        slot = buckets[i] - 1;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void insert(uint32_t slot) {
+    auto i = bucket_for(ring[slot].*field, mask);
+    while (buckets[i] != 0) {
+      i = (i + 1) & mask;
+    }
+    buckets[i] = slot + 1;
+  }
+
+  void erase(uint32_t slot) {
+    auto i = bucket_for(ring[slot].*field, mask);
+    while (buckets[i] != slot + 1) {
+      if (buckets[i] == 0) {
+        return;
+      }
+      i = (i + 1) & mask;
+    }
+    for (auto j = (i + 1) & mask; buckets[j] != 0; j = (j + 1) & mask) {
+      const auto home = bucket_for(key_at(j), mask);
+      // Entries whose home bucket is cyclically within (i, j] stay put.
+      if (i <= j ? (i < home && home <= j) : (i < home || home <= j)) {
+        continue;
+      }
+      buckets[i] = buckets[j];
+      i = j;
+    }
+    buckets[i] = 0;
+  }
+};
+
+DupeTable header_table(const msgdupe_header_t* h, msgids* ring, uint32_t* buckets) {
+  return DupeTable{ring, buckets, h->table_size - 1, &msgids::header};
+}
+
+DupeTable msgid_table(const msgdupe_header_t* h, msgids* ring, uint32_t* buckets) {
+  return DupeTable{ring, buckets, h->table_size - 1, &msgids::msgid};
+}
+
+}  // namespace
+
+FtnMessageDupe::FtnMessageDupe(const Config& config, std::chrono::duration<double> lock_timeout)
+    : FtnMessageDupe(config.datadir(), true, kDefaultCapacity, lock_timeout) {}
+
+FtnMessageDupe::FtnMessageDupe(const std::string& datadir, bool use_filesystem, uint32_t capacity,
+                               std::chrono::duration<double> lock_timeout)
+    : datadir_(datadir), use_filesystem_(use_filesystem), lock_timeout_(lock_timeout) {
   if (!datadir_.empty()) {
-    initialized_ = Load();
+    initialized_ = Load(capacity);
   } else {
     initialized_ = false;
   }
 }
 
-bool FtnMessageDupe::Load() {
-  if (!use_filesystem_) {
+bool FtnMessageDupe::Map(const std::string& path) {
+  file_ = std::make_unique<MemoryMappedFile>(path, MemoryMappedFile::Mode::read_write);
+  if (file_->Open() && Attach(file_->mutable_data(), file_->size())) {
     return true;
   }
-  DataFile<msgids> file(FilePath(datadir_, MSGDUPE_DAT),
-                        File::modeReadWrite | File::modeBinary | File::modeCreateFile);
-  if (!file) {
-    LOG(ERROR) << "Unable to initialize FtnDupe: Unable to create file.";
+  Detach();
+  return false;
+}
+
+bool FtnMessageDupe::Load(uint32_t capacity) {
+  capacity = std::max<uint32_t>(1, std::min(capacity, kMaxCapacity));
+  if (!use_filesystem_) {
+    return Create(capacity, {});
+  }
+
+  // Adds and removes change the ring and hash tables in place, so only one
+  // process may have the file mapped at a time.
+  try {
+    lock_ = std::make_unique<SemaphoreFile>(
+        SemaphoreFile::try_acquire(FilePath(datadir_, MSGDUPE_SEM), lock_timeout_));
+  } catch (const semaphore_not_acquired& e) {
+    LOG(ERROR) << "Unable to initialize FtnDupe: Unable to lock: " << e.what();
+    return false;
+  }
+  if (!LoadLocked(capacity)) {
+    lock_.reset();
     return false;
   }
+  return true;
+}
 
-  const int num_records = file.number_of_records();
-  if (num_records == 0) {
-    // nothing to read.
-    return true;
+bool FtnMessageDupe::LoadLocked(uint32_t capacity) {
+  const auto path = FilePath(datadir_, MSGDUPE_IDX);
+  std::vector<msgids> existing;
+  if (File::Exists(path)) {
+    if (Map(path)) {
+      if (header_->capacity == capacity) {
+        return true;
+      }
+      // The capacity changed, rebuild it keeping the newest entries.
+      existing = entries();
+      Detach();
+    } else {
+      LOG(WARNING) << "Recreating invalid FTN dupe file: " << path;
+    }
+  }
+
+  // Import the flat file used by older versions.
+  const auto legacy_path = FilePath(datadir_, MSGDUPE_DAT);
+  auto imported = false;
+  if (existing.empty() && File::Exists(legacy_path)) {
+    DataFile<msgids> legacy(legacy_path, File::modeReadOnly | File::modeBinary);
+    if (!legacy || (legacy.number_of_records() > 0 && !legacy.ReadVector(existing))) {
+      // Keep it to try again next time rather than losing the history.
+      LOG(ERROR) << "Unable to initialize FtnDupe: Unable to import: " << legacy_path;
+      return false;
+    }
+    imported = true;
   }
-  if (!file.ReadVector(dupes_)) {
-    LOG(ERROR) << "Unable to initialize FtnDupe: Read Failed";
+  if (!Create(capacity, existing)) {
+    LOG(ERROR) << "Unable to initialize FtnDupe: Unable to create file.";
     return false;
   }
-  for (const auto& d : dupes_) {
-    header_dupes_.insert(d.header);
-    msgid_dupes_.insert(d.msgid);
+  if (imported) {
+    File::Remove(legacy_path);
   }
   return true;
 }
 
-bool FtnMessageDupe::Save() {
+bool FtnMessageDupe::Create(uint32_t capacity, const std::vector<msgids>& entries) {
+  const auto table_size = table_size_for(capacity);
+  const auto size = file_size_for(capacity, table_size);
+  const auto path = FilePath(datadir_, MSGDUPE_IDX);
+  // Build into a temporary file first so that nobody maps a partial one.
+  const auto temp_path = StrCat(path, ".tmp");
+
+  uint8_t* data = nullptr;
+  if (use_filesystem_) {
+    {
+      File f(temp_path);
+      if (!f.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite |
+                  File::modeTruncate)) {
+        return false;
+      }
+      // Extending the file fills it with zeros, which are empty buckets.
+      f.set_length(static_cast<off_t>(size));
+    }
+    file_ = std::make_unique<MemoryMappedFile>(temp_path, MemoryMappedFile::Mode::read_write);
+    if (!file_->Open() || file_->size() != size) {
+      Detach();
+      File::Remove(temp_path);
+      return false;
+    }
+    data = file_->mutable_data();
+  } else {
+    memory_.assign(size, 0);
+    data = &memory_[0];
+  }
+
+  auto* h = reinterpret_cast<msgdupe_header_t*>(data);
+  memcpy(h->signature, kMsgDupeSignature, sizeof(h->signature));
+  h->version = kMsgDupeVersion;
+  h->capacity = capacity;
+  h->table_size = table_size;
+  if (!Attach(data, size)) {
+    return false;
+  }
+  // Only the newest entries fit.
+  const auto first = entries.size() > capacity ? entries.size() - capacity : 0;
+  for (auto i = first; i < entries.size(); i++) {
+    add(entries[i].header, entries[i].msgid);
+  }
   if (!use_filesystem_) {
     return true;
   }
-  DataFile<msgids> file(FilePath(datadir_, MSGDUPE_DAT),
-                        File::modeReadWrite | File::modeBinary | File::modeCreateFile |
-                            File::modeTruncate);
-  if (!file) {
+
+  Detach();
+  if (!File::Rename(temp_path, path)) {
+    // Windows won't rename over an existing file.
+    File::Remove(path);
+    if (!File::Rename(temp_path, path)) {
+      LOG(ERROR) << "Unable to rename " << temp_path << " to " << path;
+      File::Remove(temp_path);
+      return false;
+    }
+  }
+  file_ = std::make_unique<MemoryMappedFile>(path, MemoryMappedFile::Mode::read_write);
+  if (!file_->Open() || !Attach(file_->mutable_data(), file_->size())) {
+    Detach();
+    return false;
+  }
+  return true;
+}
+
+bool FtnMessageDupe::Attach(uint8_t* data, std::size_t size) {
+  if (data == nullptr || size < sizeof(msgdupe_header_t)) {
+    return false;
+  }
+  auto* h = reinterpret_cast<msgdupe_header_t*>(data);
+  if (memcmp(h->signature, kMsgDupeSignature, sizeof(h->signature)) != 0 ||
+      h->version != kMsgDupeVersion || h->capacity == 0 || h->capacity > kMaxCapacity ||
+      h->table_size != table_size_for(h->capacity) ||
+      size != file_size_for(h->capacity, h->table_size) || h->head >= h->capacity ||
+      h->count > h->capacity) {
     return false;
   }
-  return file.WriteVector(dupes_);
+  header_ = h;
+  ring_ = reinterpret_cast<msgids*>(data + sizeof(msgdupe_header_t));
+  header_table_ = reinterpret_cast<uint32_t*>(ring_ + h->capacity);
+  msgid_table_ = header_table_ + h->table_size;
+  return true;
+}
+
+void FtnMessageDupe::Detach() {
+  header_ = nullptr;
+  ring_ = nullptr;
+  header_table_ = nullptr;
+  msgid_table_ = nullptr;
+  file_.reset();
+  memory_.clear();
+}
+
+std::vector<msgids> FtnMessageDupe::entries() const {
+  std::vector<msgids> result;
+  const auto capacity = header_->capacity;
+  const auto start = (header_->head + capacity - header_->count) % capacity;
+  for (uint32_t i = 0; i < header_->count; i++) {
+    const auto& e = ring_[(start + i) % capacity];
+    // Skip entries that were removed.
+    if (e.header != 0 || e.msgid != 0) {
+      result.push_back(e);
+    }
+  }
+  return result;
+}
+
+static string address_string(const FidoAddress& a) {
+  if (a.point() != 0) {
+    return to_zone_net_node_point(a);
+  }
+  return to_zone_net_node(a);
 }
 
 const std::string FtnMessageDupe::CreateMessageID(const wwiv::sdk::fido::FidoAddress& a) {
   if (!initialized_) {
-    string address_string;
-    if (a.point() != 0) {
-      address_string = to_zone_net_node_point(a);
-    } else {
-      address_string = to_zone_net_node(a);
-    }
-    return StrCat(address_string, " DEADBEEF");
+    return StrCat(address_string(a), " DEADBEEF");
   }
+  return CreateMessageID(datadir_, a);
+}
 
-  DataFile<uint64_t> file(FilePath(datadir_, MSGID_DAT),
+// static
+std::string FtnMessageDupe::CreateMessageID(const std::string& datadir,
+                                            const wwiv::sdk::fido::FidoAddress& a) {
+  if (datadir.empty()) {
+    return StrCat(address_string(a), " DEADBEEF");
+  }
+  DataFile<uint64_t> file(FilePath(datadir, MSGID_DAT),
                           File::modeReadWrite | File::modeBinary | File::modeCreateFile,
                           File::shareDenyReadWrite);
   if (!file) {
@@ -123,14 +374,7 @@ const std::string FtnMessageDupe::CreateMessageID(const wwiv::sdk::fido::FidoAdd
   file.file().Seek(0, File::Whence::begin);
   file.Write(0, &msg_num);
 
-  string address_string;
-
-  if (a.point() != 0) {
-    address_string = to_zone_net_node_point(a);
-  } else {
-    address_string = to_zone_net_node(a);
-  }
-  return StringPrintf("%s %08X", address_string.c_str(), msg_num);
+  return StringPrintf("%s %08X", address_string(a).c_str(), msg_num);
 }
 
 // static
@@ -196,41 +440,72 @@ bool FtnMessageDupe::add(const FidoPackedMessage& msg) {
 }
 
 bool FtnMessageDupe::add(uint32_t header_crc32, uint32_t msgid_crc32) {
+  if (header_ == nullptr) {
+    return false;
+  }
+  const auto slot = header_->head;
+  if (header_->count == header_->capacity) {
+    Evict(slot);
+  }
+  ring_[slot].header = header_crc32;
+  ring_[slot].msgid = msgid_crc32;
   if (header_crc32 != 0) {
-    header_dupes_.insert(header_crc32);
+    header_table(header_, ring_, header_table_).insert(slot);
   }
   if (msgid_crc32 != 0) {
-    msgid_dupes_.insert(msgid_crc32);
+    msgid_table(header_, ring_, msgid_table_).insert(slot);
   }
+  header_->head = (slot + 1) % header_->capacity;
+  if (header_->count < header_->capacity) {
+    ++header_->count;
+  }
+  return true;
+}
 
-  msgids ids{};
-  ids.header = header_crc32;
-  ids.msgid = msgid_crc32;
-
-  dupes_.emplace_back(ids);
-  return Save();
+void FtnMessageDupe::Evict(uint32_t slot) {
+  const auto& e = ring_[slot];
+  if (e.header != 0) {
+    header_table(header_, ring_, header_table_).erase(slot);
+  }
+  if (e.msgid != 0) {
+    msgid_table(header_, ring_, msgid_table_).erase(slot);
+  }
 }
 
 bool FtnMessageDupe::remove(uint32_t header_crc32, uint32_t msgid_crc32) {
-  for (auto it = dupes_.begin(); it != std::end(dupes_);) {
-    const auto& d = *it;
-    if (d.header == header_crc32 && d.msgid == msgid_crc32) {
-      dupes_.erase(it);
-      header_dupes_.erase(header_crc32);
-      msgid_dupes_.erase(msgid_crc32);
-      return Save();
-    } else {
-      it++;
+  if (header_ == nullptr) {
+    return false;
+  }
+  msgids e{};
+  e.header = header_crc32;
+  e.msgid = msgid_crc32;
+  uint32_t slot = 0;
+  if (header_crc32 != 0) {
+    if (!header_table(header_, ring_, header_table_).find(e, slot)) {
+      return false;
+    }
+  } else if (msgid_crc32 != 0) {
+    if (!msgid_table(header_, ring_, msgid_table_).find(e, slot)) {
+      return false;
     }
+  } else {
+    // Entries without either CRC are never a dupe.
+    return false;
   }
-  return false;
+  Evict(slot);
+  // The slot keeps its place in the ring until it is reused.
+  ring_[slot] = msgids{};
+  return true;
 }
 
 bool FtnMessageDupe::is_dupe(uint32_t header_crc32, uint32_t msgid_crc32) const {
-  if (contains(header_dupes_, header_crc32)) {
+  if (header_ == nullptr) {
+    return false;
+  }
+  if (header_crc32 != 0 && header_table(header_, ring_, header_table_).contains(header_crc32)) {
     return true;
   }
-  if (contains(msgid_dupes_, msgid_crc32)) {
+  if (msgid_crc32 != 0 && msgid_table(header_, ring_, msgid_table_).contains(msgid_crc32)) {
     return true;
   }
   return false;
@@ -18,9 +18,13 @@
 #ifndef __INCLUDED_SDK_FTN_MSGDUPE_H__
 #define __INCLUDED_SDK_MSGID_H__
 
+#include <chrono>
+#include <cstdint>
+#include <memory>
 #include <string>
-#include <set>
 #include <vector>
+#include "core/mmap_file.h"
+#include "core/semaphore_file.h"
 #include "sdk/config.h"
 #include "sdk/vardec.h"
 #include "sdk/fido/fido_address.h"
@@ -36,15 +40,78 @@ namespace sdk {
 
  static_assert(sizeof(msgids) == sizeof(uint64_t), "sizeof(msgids) must be the same as an int64.");
 
+/**
+ * Layout of msgdupe.idx.
+ *
+ * The header is followed by capacity msgids records used as a ring buffer,
+ * then by two open addressing hash tables of table_size buckets each, the
+ * first keyed by the header CRC-32 and the second by the MSGID CRC-32.  Each
+ * bucket holds the ring slot + 1 of an entry, or 0 when empty.
+ *
+ * The file is created at its full size and never grows, once the ring is
+ * full each add replaces the oldest entry.
+ */
+#pragma pack(push, 1)
+struct msgdupe_header_t {
+  // "WMDX"
+  char signature[4];
+  uint16_t version;
+  uint16_t reserved;
+  // Number of msgids records in the ring.
+  uint32_t capacity;
+  // Number of buckets in each hash table, always a power of two.
+  uint32_t table_size;
+  // Ring slot used by the next add.
+  uint32_t head;
+  // Number of ring slots in use, never more than capacity.
+  uint32_t count;
+  uint32_t reserved2[2];
+};
+#pragma pack(pop)
+
+static_assert(sizeof(msgdupe_header_t) == 32, "msgdupe_header_t != 32 bytes");
+
+/**
+ * Remembers the header and MSGID CRC-32s of the most recent capacity FTN
+ * messages seen.
+ *
+ * When use_filesystem is true the entries live in DATA/msgdupe.idx which is
+ * memory mapped, so opening it does not read the file and adding an entry
+ * only touches the ring slot and hash buckets it uses.  An existing
+ * msgdupe.dat from older versions is imported the first time the index is
+ * created. The msgdupe.sem lock is held for as long as the object is alive,
+ * so only one process reads or changes the file at a time.
+ */
 class FtnMessageDupe {
 public:
-  explicit FtnMessageDupe(const Config& config);
-  FtnMessageDupe(const std::string& datadir, bool use_filesystem);
+  /** Default number of entries kept before the oldest ones are evicted. */
+  static constexpr uint32_t kDefaultCapacity = 500000;
+  /** Default time to wait for another process to release msgdupe.sem. */
+  static constexpr std::chrono::seconds kDefaultLockTimeout{15};
+
+  explicit FtnMessageDupe(const Config& config,
+                          std::chrono::duration<double> lock_timeout = kDefaultLockTimeout);
+  FtnMessageDupe(const std::string& datadir, bool use_filesystem,
+                 uint32_t capacity = kDefaultCapacity,
+                 std::chrono::duration<double> lock_timeout = kDefaultLockTimeout);
+  FtnMessageDupe(const FtnMessageDupe&) = delete;
+  FtnMessageDupe& operator=(const FtnMessageDupe&) = delete;
   virtual ~FtnMessageDupe() = default;
 
   bool IsInitialized() const { return initialized_; }
+  /** Maximum number of entries kept. */
+  uint32_t capacity() const noexcept { return header_ ? header_->capacity : 0; }
+  /** Number of entries currently kept. */
+  uint32_t size() const noexcept { return header_ ? header_->count : 0; }
   const std::string CreateMessageID(const wwiv::sdk::fido::FidoAddress& a);
+  /**
+   * Creates a new MSGID for a using DATA/msgid.dat in datadir, without
+   * opening the dupe file.
+   */
+  static std::string CreateMessageID(const std::string& datadir,
+                                     const wwiv::sdk::fido::FidoAddress& a);
   bool add(const wwiv::sdk::fido::FidoPackedMessage& msg);
+  /** Adds an entry, evicting the oldest one once capacity entries are kept. */
   bool add(uint32_t header_crc32, uint32_t msgid_crc32);
   bool remove(uint32_t header_crc32, uint32_t msgid_crc32);
   /** returns true if either the header or msgid crc is duplicated */
@@ -63,15 +130,31 @@ public:
   static std::string GetMessageIDFromWWIVText(const std::string& text);
 
 private:
-  bool Load();
-  bool Save();
+  bool Load(uint32_t capacity);
+  bool LoadLocked(uint32_t capacity);
+  bool Map(const std::string& path);
+  bool Create(uint32_t capacity, const std::vector<msgids>& entries);
+  bool Attach(uint8_t* data, std::size_t size);
+  void Detach();
+  void Evict(uint32_t slot);
+  /** Returns the entries oldest first. */
+  std::vector<msgids> entries() const;
 
-  bool initialized_;
+  bool initialized_{false};
   std::string datadir_;
-  std::vector<msgids> dupes_;
-  std::set<uint32_t> msgid_dupes_;
-  std::set<uint32_t> header_dupes_;
   bool use_filesystem_{true};
+  std::chrono::duration<double> lock_timeout_;
+  // Held while msgdupe.idx is mapped, declared before file_ so that it is
+  // released after the file is unmapped.
+  std::unique_ptr<wwiv::core::SemaphoreFile> lock_;
+  // Backing store when use_filesystem_ is false or while creating the file.
+  std::vector<uint8_t> memory_;
+  std::unique_ptr<wwiv::core::MemoryMappedFile> file_;
+  // Views into memory_ or file_.
+  msgdupe_header_t* header_{nullptr};
+  msgids* ring_{nullptr};
+  uint32_t* header_table_{nullptr};
+  uint32_t* msgid_table_{nullptr};
 };
 
 
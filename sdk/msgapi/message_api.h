@@ -38,6 +38,9 @@ enum class OverflowStrategy {
 
 struct MessageApiOptions {
   wwiv::sdk::msgapi::OverflowStrategy overflow_strategy = wwiv::sdk::msgapi::OverflowStrategy::delete_one;
+  // Once more than this percentage of the messages in an area are deleted
+  // (but not yet removed), DeleteMessage compacts the area. 0 never does.
+  int compact_deleted_percent = 25;
 };
 
 class bad_message_area : public ::std::runtime_error {
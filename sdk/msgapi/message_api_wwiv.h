@@ -22,6 +22,7 @@
 #include "sdk/msgapi/email_wwiv.h"
 #include "sdk/msgapi/message_api.h"
 #include "sdk/msgapi/message_area_wwiv.h"
+#include "sdk/msgapi/sub_cache_wwiv.h"
 #include "sdk/net.h"
 
 #include <memory>
@@ -69,10 +70,13 @@ public:
   uint32_t last_read(int area) const;
   void set_last_read(int area, uint32_t last_read);
   const Config& config() const noexcept { return config_; }
+  /** Shared cache of sub headers and qscan indexes for this API. */
+  WWIVSubCache& sub_cache() noexcept { return sub_cache_; }
 
 private:
   std::unique_ptr<WWIVLastReadImpl> last_read_;
   const Config config_;
+  WWIVSubCache sub_cache_;
 };
 
 } // namespace msgapi
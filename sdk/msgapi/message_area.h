@@ -78,7 +78,19 @@ public:
   virtual std::unique_ptr<MessageHeader> ReadMessageHeader(int message_number) = 0;
   virtual std::unique_ptr<MessageText> ReadMessageText(int message_number) = 0;
   virtual bool AddMessage(const Message& message, const MessageAreaOptions& options) = 0;
+  /**
+   * Adds all of messages at once, this is much faster than calling
+   * AddMessage for each one when importing many messages.
+   */
+  virtual bool AddMessages(const std::vector<const Message*>& messages,
+                           const MessageAreaOptions& options) = 0;
+  /**
+   * Deletes message_number, renumbering the messages after it. The space
+   * used by the message is reclaimed by the next Compact.
+   */
   virtual bool DeleteMessage(int message_number) = 0;
+  /** Removes the post records and text of all deleted messages. */
+  virtual bool Compact() = 0;
   /** Updates message_number to point to the */
   virtual bool ResyncMessage(int& message_number) = 0;
   virtual bool ResyncMessage(int& message_number, Message& message) = 0;
@@ -17,7 +17,10 @@
 /**************************************************************************/
 #include "sdk/msgapi/message_area_wwiv.h"
 
+#include <algorithm>
+#include <limits>
 #include <memory>
+#include <numeric>
 #include <string>
 #include <utility>
 #include <vector>
@@ -62,23 +65,20 @@ static bool WriteHeader(DataFile<postrec>& file, const WWIVMessageAreaHeader& he
   return file.Write(0, reinterpret_cast<const postrec*>(&p));
 }
 
-static WWIVMessageAreaHeader ReadHeader(DataFile<postrec>& file) {
-  subfile_header_t raw_header;
-  if (!file.Read(0, reinterpret_cast<postrec*>(&raw_header))) {
-    // Invalid header.
-    WWIVMessageAreaHeader header(0, 0);
-    header.set_initialized(false);
-    return header;
-  }
-  if (raw_header.active_message_count > file.number_of_records()) {
+static WWIVMessageAreaHeader ParseHeader(subfile_header_t raw_header, std::size_t num_records,
+                                         const std::string& name) {
+  if (raw_header.active_message_count > num_records) {
     VLOG(1) << "Header claims too many messages, raw_header.active_message_count("
-            << raw_header.active_message_count << ") > file.number_of_records("
-            << file.number_of_records() << ")";
-    raw_header.active_message_count = static_cast<uint16_t>(file.number_of_records());
+            << raw_header.active_message_count << ") > file.number_of_records(" << num_records
+            << ")";
+    raw_header.active_message_count = static_cast<uint16_t>(num_records);
+  }
+  if (raw_header.tombstone_message_count > raw_header.active_message_count) {
+    raw_header.tombstone_message_count = raw_header.active_message_count;
   }
 
   if (strncmp(raw_header.signature, "WWIV\x1A", 5) != 0) {
-    VLOG(3) << "Missing 5.x header on sub: " << file.file().GetName();
+    VLOG(3) << "Missing 5.x header on sub: " << name;
     auto saved_count = raw_header.active_message_count;
     memset(&raw_header, 0, sizeof(subfile_header_t));
     // We don't have a modern header. Create one now. Next write
@@ -99,6 +99,32 @@ static WWIVMessageAreaHeader ReadHeader(DataFile<postrec>& file) {
   return WWIVMessageAreaHeader(raw_header);
 }
 
+static WWIVMessageAreaHeader InvalidHeader() {
+  WWIVMessageAreaHeader header(0, 0);
+  header.set_initialized(false);
+  return header;
+}
+
+static WWIVMessageAreaHeader ReadHeader(DataFile<postrec>& file) {
+  subfile_header_t raw_header;
+  if (!file.Read(0, reinterpret_cast<postrec*>(&raw_header))) {
+    // Invalid header.
+    return InvalidHeader();
+  }
+  return ParseHeader(raw_header, file.number_of_records(), file.file().GetName());
+}
+
+static WWIVMessageAreaHeader ReadHeader(const MappedDataFile<postrec>& file) {
+  const auto* p = file.at(0);
+  if (p == nullptr) {
+    // Invalid header.
+    return InvalidHeader();
+  }
+  subfile_header_t raw_header;
+  memcpy(&raw_header, p, sizeof(subfile_header_t));
+  return ParseHeader(raw_header, file.number_of_records(), file.file().full_pathname());
+}
+
 WWIVMessageAreaLastRead::WWIVMessageAreaLastRead(WWIVMessageApi* api, int message_area_number)
     : MessageAreaLastRead(api), wapi_(api), message_area_number_(message_area_number) {}
 
@@ -135,11 +161,11 @@ WWIVMessageArea::WWIVMessageArea(WWIVMessageApi* api, const subboard_t sub,
                                  int subnum)
     : MessageArea(api), Type2Text(text_filename), wwiv_api_(api), sub_(sub),
       sub_filename_(sub_filename), header_{}, subnum_(subnum) {
-  DataFile<postrec> subfile(sub_filename_, File::modeBinary | File::modeReadOnly);
+  const auto* subfile = sub_view();
   if (!subfile) {
     // TODO: throw exception
   } else {
-    WWIVMessageAreaHeader h = ReadHeader(subfile);
+    WWIVMessageAreaHeader h = ReadHeader(*subfile);
     header_ = h.raw_header();
   }
   open_ = true;
@@ -149,6 +175,7 @@ WWIVMessageArea::WWIVMessageArea(WWIVMessageApi* api, const subboard_t sub,
 WWIVMessageArea::~WWIVMessageArea() { Close(); }
 
 bool WWIVMessageArea::Close() {
+  sub_view_.reset();
   open_ = false;
   return true;
 }
@@ -158,8 +185,8 @@ bool WWIVMessageArea::Lock() { return false; }
 bool WWIVMessageArea::Unlock() { return false; }
 
 void WWIVMessageArea::ReadMessageAreaHeader(MessageAreaHeader& header) {
-  DataFile<postrec> sub(sub_filename_);
-  WWIVMessageAreaHeader h = ReadHeader(sub);
+  const auto* sub = sub_view();
+  WWIVMessageAreaHeader h = sub ? ReadHeader(*sub) : InvalidHeader();
   header_ = h.raw_header();
   header = h;
 }
@@ -174,14 +201,14 @@ int WWIVMessageArea::FindUserMessages(const std::string&) {
 }
 
 int WWIVMessageArea::number_of_messages() {
-  DataFile<postrec> sub(sub_filename_);
+  const auto* sub = sub_view();
   if (!sub) {
     // TODO: throw exception
     return 0;
   }
 
-  const int file_num_records = sub.number_of_records();
-  WWIVMessageAreaHeader wwiv_header = ReadHeader(sub);
+  const int file_num_records = static_cast<int>(sub->number_of_records());
+  WWIVMessageAreaHeader wwiv_header = ReadHeader(*sub);
   if (!wwiv_header.initialized()) {
     // TODO: throw exception
     // This is an invalid header.
@@ -190,80 +217,152 @@ int WWIVMessageArea::number_of_messages() {
   int msgs = wwiv_header.active_message_count();
   if (msgs > file_num_records) {
     LOG(ERROR) << "Mismatch between header: " << msgs << " and filesize: " << file_num_records;
-    return std::min(msgs, file_num_records);
+    msgs = std::min(msgs, file_num_records);
+  }
+  if (wwiv_header.tombstone_message_count() == 0) {
+    return msgs;
   }
-  return msgs;
+  return size_int(live_posts(*sub, msgs));
 }
 
-bool WWIVMessageArea::ParseMessageText(const postrec& header, int message_number,
-                                       string& from_username, string& date, string& to,
-                                       string& in_reply_to, string& text) {
-
-  // Some of the message header information ends up in the text.
-  // line1: From username (i.e. rushfan #1 @5161)
-  // line2: Date (again, same as daten but is formatted by the sender)
-  // optional lines:
-  // RE: Title (title this is a reply to, mostly redundant since the title will contain it too)
-  // BY: Author (author of the post this is a reply to, could be considered the "to" person for this
-  // message. ^DControl Lines (we have many) ^D# (0 = network, >0 = tag lines)
+int WWIVMessageArea::record_number(const MappedDataFile<postrec>& sub, int message_number) {
+  const auto wwiv_header = ReadHeader(sub);
+  const int num_records = wwiv_header.active_message_count();
+  if (message_number < 1 || message_number > num_records) {
+    return 0;
+  }
+  if (wwiv_header.tombstone_message_count() == 0) {
+    return message_number;
+  }
+  const auto& live = live_posts(sub, num_records);
+  return message_number <= size_int(live) ? live[message_number - 1] : 0;
+}
 
-  string raw_text;
-  if (!readfile(&header.msg, &raw_text)) {
-    return false;
+const vector<uint16_t>& WWIVMessageArea::live_posts(const MappedDataFile<postrec>& sub,
+                                                    int num_records) {
+  if (live_posts_valid_ && live_posts_mod_count_ == sub_view_mod_count_ &&
+      live_posts_num_records_ == num_records) {
+    return live_posts_;
+  }
+  live_posts_.clear();
+  for (int i = 1; i <= num_records; i++) {
+    const auto* p = sub.at(i);
+    if (p == nullptr) {
+      break;
+    }
+    if (!(p->status & status_post_tombstone)) {
+      live_posts_.push_back(static_cast<uint16_t>(i));
+    }
   }
+  live_posts_valid_ = true;
+  live_posts_mod_count_ = sub_view_mod_count_;
+  live_posts_num_records_ = num_records;
+  return live_posts_;
+}
 
-  // Use the 3 arg form of split string so we don't strip blank lines.
-  vector<string> lines = SplitString(raw_text, "\n", false);
+// Some of the message header information ends up in the text.
+// line1: From username (i.e. rushfan #1 @5161)
+// line2: Date (again, same as daten but is formatted by the sender)
+// optional lines:
+// RE: Title (title this is a reply to, mostly redundant since the title will contain it too)
+// BY: Author (author of the post this is a reply to, could be considered the "to" person for this
+// message. ^DControl Lines (we have many) ^D# (0 = network, >0 = tag lines)
+//
+// Parses those lines from the start of lines, appending any control lines
+// to control_lines. Returns the first line of the message body, or end if
+// lines ran out before the body started.
+static vector<string>::const_iterator ParseHeaderLines(const vector<string>& lines,
+                                                       string& from_username, string& date,
+                                                       string& to, string& in_reply_to,
+                                                       string& control_lines) {
   auto it = std::begin(lines);
   if (it == std::end(lines)) {
-    VLOG(1) << "Malformed message(1) #" << message_number << "; title: '" << header.title << "' "
-            << header.owneruser << "@" << header.ownersys;
-    return true;
+    return it;
   }
-
   from_username = StringTrim(*it++);
-  if (it == lines.end()) {
-    VLOG(1) << "Malformed message(2) #" << message_number << "; title: '" << header.title << "' "
-            << header.owneruser << "@" << header.ownersys;
-    return true;
-  }
-
-  date = StringTrim(*it++);
   if (it == std::end(lines)) {
-    VLOG(1) << "Malformed message(3) #" << message_number << "; title: '" << header.title << "' "
-            << header.owneruser << "@" << header.ownersys;
-    return true;
+    return it;
   }
-
+  date = StringTrim(*it++);
   for (; it != std::end(lines); it++) {
     auto line = StringTrim(*it);
     if (!line.empty() && line.front() == CD) {
-      text += line;
-      text += "\r\n";
+      control_lines += line;
+      control_lines += "\r\n";
     } else if (starts_with(line, "RE:")) {
       in_reply_to = StringTrim(line.substr(3));
     } else if (starts_with(line, "BY:")) {
       to = StringTrim(line.substr(3));
     } else {
-      // No more special lines, the rest is just text.
-      for (; it != std::end(lines); it++) {
-        auto text_line = *it;
-        // Terminate the string with a control-Z.
-        auto cz_pos = text_line.find(CZ);
-        if (cz_pos != string::npos) {
-          text_line = text_line.substr(0, cz_pos);
-        }
-        // Trim all remaining nulls.
-        auto null_pos = text_line.find((char)0);
-        if (null_pos != string::npos) {
-          text_line.resize(null_pos);
-        }
-        StringTrim(&text_line);
-        if (!text_line.empty()) {
-          text += text_line;
-          text += "\r\n";
-        }
-      }
+      break;
+    }
+  }
+  return it;
+}
+
+bool WWIVMessageArea::ParseMessageText(const postrec& header, int message_number,
+                                       string& from_username, string& date, string& to,
+                                       string& in_reply_to, string& text) {
+  string raw_text;
+  if (!readfile(&header.msg, &raw_text)) {
+    return false;
+  }
+
+  // Use the 3 arg form of split string so we don't strip blank lines.
+  vector<string> lines = SplitString(raw_text, "\n", false);
+  auto it = ParseHeaderLines(lines, from_username, date, to, in_reply_to, text);
+  if (lines.size() < 3) {
+    VLOG(1) << "Malformed message(" << lines.size() + 1 << ") #" << message_number
+            << "; title: '" << header.title << "' " << header.owneruser << "@"
+            << header.ownersys;
+    return true;
+  }
+
+  // No more special lines, the rest is just text.
+  for (; it != std::end(lines); it++) {
+    auto text_line = *it;
+    // Terminate the string with a control-Z.
+    auto cz_pos = text_line.find(CZ);
+    if (cz_pos != string::npos) {
+      text_line = text_line.substr(0, cz_pos);
+    }
+    // Trim all remaining nulls.
+    auto null_pos = text_line.find((char)0);
+    if (null_pos != string::npos) {
+      text_line.resize(null_pos);
+    }
+    StringTrim(&text_line);
+    if (!text_line.empty()) {
+      text += text_line;
+      text += "\r\n";
+    }
+  }
+  return true;
+}
+
+bool WWIVMessageArea::ParseMessageHeader(const postrec& header, string& from_username,
+                                         string& date, string& to, string& in_reply_to) {
+  // The header lines almost always fit in the first block, so only read
+  // more of the text when they don't.
+  for (const size_t max_blocks : {size_t{1}, size_t{2}, size_t{GAT_NUMBER_ELEMENTS}}) {
+    string raw_text;
+    if (!readfile(&header.msg, &raw_text, max_blocks)) {
+      return false;
+    }
+    // A short read means we have the whole text.
+    const bool whole_text = raw_text.size() < max_blocks * MSG_BLOCK_SIZE;
+    vector<string> lines = SplitString(raw_text, "\n", false);
+    if (!whole_text && !lines.empty()) {
+      // The last line may continue in the next block.
+      lines.pop_back();
+    }
+    from_username.clear();
+    date.clear();
+    to.clear();
+    in_reply_to.clear();
+    string control_lines;
+    auto it = ParseHeaderLines(lines, from_username, date, to, in_reply_to, control_lines);
+    if (whole_text || it != std::end(lines)) {
       break;
     }
   }
@@ -278,13 +377,20 @@ unique_ptr<Message> WWIVMessageArea::ReadMessage(int message_number) {
     message_number = num_messages;
   }
 
-  DataFile<postrec> sub(sub_filename_);
+  const auto* sub = sub_view();
   if (!sub) {
     // TODO: throw exception
     return {};
   }
-  postrec header;
-  sub.Read(message_number, &header);
+  const auto record = record_number(*sub, message_number);
+  if (record == 0) {
+    return {};
+  }
+  const auto* p = sub->at(record);
+  if (p == nullptr) {
+    return {};
+  }
+  postrec header = *p;
   if (header.msg.storage_type != 2) {
     // We only support type-2 on the WWIV API.
     return {};
@@ -301,11 +407,37 @@ unique_ptr<Message> WWIVMessageArea::ReadMessage(int message_number) {
 }
 
 unique_ptr<MessageHeader> WWIVMessageArea::ReadMessageHeader(int message_number) {
-  auto msg = ReadMessage(message_number);
-  if (!msg) {
+  int num_messages = number_of_messages();
+  if (message_number < 1) {
+    return {};
+  } else if (message_number > num_messages) {
+    message_number = num_messages;
+  }
+
+  const auto* sub = sub_view();
+  if (!sub) {
+    // TODO: throw exception
+    return {};
+  }
+  const auto record = record_number(*sub, message_number);
+  if (record == 0) {
+    return {};
+  }
+  const auto* p = sub->at(record);
+  if (p == nullptr) {
     return {};
   }
-  return msg->release_header();
+  postrec header = *p;
+  if (header.msg.storage_type != 2) {
+    // We only support type-2 on the WWIV API.
+    return {};
+  }
+
+  string from_username, date, to, in_reply_to;
+  if (!ParseMessageHeader(header, from_username, date, to, in_reply_to)) {
+    return {};
+  }
+  return make_unique<WWIVMessageHeader>(header, from_username, to, in_reply_to, api_);
 }
 
 unique_ptr<MessageText> WWIVMessageArea::ReadMessageText(int message_number) {
@@ -316,7 +448,10 @@ unique_ptr<MessageText> WWIVMessageArea::ReadMessageText(int message_number) {
   return msg->release_text();
 }
 
-static uint32_t next_qscan_value_and_increment_post(const string& bbsdir) {
+/**
+ * Reserves num_posts qscan values, returning the first one or 0 on error.
+ */
+static uint32_t next_qscan_value_and_increment_post(const string& bbsdir, int num_posts = 1) {
   statusrec_t statusrec{};
   uint32_t next_qscan = 0;
   Config config(bbsdir);
@@ -332,8 +467,9 @@ static uint32_t next_qscan_value_and_increment_post(const string& bbsdir) {
   if (!file.Read(0, &statusrec)) {
     return 0;
   }
-  next_qscan = statusrec.qscanptr++;
-  ++statusrec.msgposttoday;
+  next_qscan = statusrec.qscanptr;
+  statusrec.qscanptr += num_posts;
+  statusrec.msgposttoday = static_cast<uint16_t>(statusrec.msgposttoday + num_posts);
   if (!file.Write(0, &statusrec)) {
     return 0;
   }
@@ -342,80 +478,95 @@ static uint32_t next_qscan_value_and_increment_post(const string& bbsdir) {
 
 /**
  * Deletes all excess messages in an area, depending on the
- * overflow strategy set on the API.
+ * overflow strategy set on the API. With delete_one, one message is
+ * deleted for each of the num_added messages just added.
  *
  * Note: This should be called by AddMessage *after* posting a new
  * message successfull, since there's no sense in deleting a post if
  * adding a new one hasn't succeeded.
  *
+ * Only the post headers are looked at to find the messages to delete, and
+ * the sub is compacted once at the end.
+ *
  * Returns the number of messages deleted.
  */
-int WWIVMessageArea::DeleteExcess() {
-  if (api_->options().overflow_strategy == OverflowStrategy::delete_none) {
+int WWIVMessageArea::DeleteExcess(int num_added) {
+  const auto strategy = api_->options().overflow_strategy;
+  if (strategy == OverflowStrategy::delete_none) {
     LOG(INFO) << "overflow_strategy is delete_none. Not deleting overflow messages";
     return 0;
   }
 
-  int result = 0;
-  bool done = false;
-  while (!done) {
-    if (api_->options().overflow_strategy == OverflowStrategy::delete_one) {
-      LOG(INFO) << "overflow_strategy is delete_one.";
-      done = true;
-    }
-    auto num = number_of_messages();
-    if (num <= max_messages_) {
-      VLOG(1) << "No overflow messages. " << num << " <= " << max_messages_;
-      return result;
-    }
-    int i = 1;
-    int dm = 0;
-    while (i <= number_of_messages()) {
-      auto pp = ReadMessageHeader(i);
-      if (!pp) {
-        break;
-      } else if (!pp->locked()) {
-        dm = i;
-        break;
-      }
-      ++i;
+  const auto live = number_of_messages();
+  const auto* sub = sub_view();
+  if (!sub) {
+    return 0;
+  }
+  const int num = ReadHeader(*sub).active_message_count();
+  if (live <= max_messages_) {
+    VLOG(1) << "No overflow messages. " << live << " <= " << max_messages_;
+    return 0;
+  }
+  int num_to_delete = live - max_messages_;
+  if (strategy == OverflowStrategy::delete_one) {
+    LOG(INFO) << "overflow_strategy is delete_one.";
+    num_to_delete = std::min(num_to_delete, num_added);
+  }
+
+  vector<int> to_delete;
+  for (int i = 1; i <= num && size_int(to_delete) < num_to_delete; i++) {
+    const auto* p = sub->at(i);
+    if (p == nullptr) {
+      break;
     }
-    if (dm == 0) {
-      LOG(INFO) << "DeleteExcess: No message to delete.";
-      return result;
+    if (p->status & (status_post_tombstone | status_no_delete)) {
+      continue;
     }
-    if (!DeleteMessage(dm)) {
-      LOG(INFO) << "DeleteExcess: Failed to delete message #" << dm;
-      return result;
-    } else {
-      LOG(INFO) << "DeleteExcess: Deleted message #" << dm;
+    to_delete.push_back(i);
+  }
+  if (to_delete.empty()) {
+    LOG(INFO) << "DeleteExcess: No message to delete.";
+    return 0;
+  }
+
+  {
+    DataFile<postrec> subfile(sub_filename_, File::modeBinary | File::modeReadWrite);
+    if (!subfile) {
+      return 0;
     }
-    ++result;
+    for (auto i : to_delete) {
+      postrec p;
+      if (!subfile.Read(i, &p)) {
+        LOG(INFO) << "DeleteExcess: Failed to delete message #" << i;
+        return 0;
+      }
+      p.status |= status_post_tombstone;
+      subfile.Write(i, &p);
+    }
+    auto wwiv_header = ReadHeader(subfile);
+    wwiv_header.set_tombstone_message_count(
+        static_cast<uint16_t>(wwiv_header.tombstone_message_count() + to_delete.size()));
+    WriteHeader(subfile, wwiv_header);
   }
-  return result;
+  if (!Compact()) {
+    LOG(INFO) << "DeleteExcess: Failed to compact after deleting messages.";
+    return 0;
+  }
+  LOG(INFO) << "DeleteExcess: Deleted " << to_delete.size() << " message(s) starting at #"
+            << to_delete.front();
+  return size_int(to_delete);
 }
 
-bool WWIVMessageArea::AddMessage(const Message& message, const MessageAreaOptions& options) {
+bool WWIVMessageArea::CreatePost(const Message& message, const MessageAreaOptions& options,
+                                 postrec& p, string& text) {
   messagerec m{STORAGE_TYPE, 0xffffff};
 
   const auto& header = dynamic_cast<const WWIVMessageHeader&>(message.header());
-  postrec p = header.data();
+  p = header.data();
   p.anony = 0;
   p.msg = m;
   p.ownersys = header.from_system();
   p.owneruser = header.from_usernum();
-  if (p.qscan == 0) {
-    // new message.
-    VLOG(3) << "AddMessage needs a qscan";
-    p.qscan = next_qscan_value_and_increment_post(api_->root_directory());
-    if (p.qscan == 0) {
-      LOG(ERROR) << "Failed to get qscan value!";
-      return false;
-    }
-  } else {
-    VLOG(2) << "AddMessage called with existing qscan ptr: title: " << message.header().title()
-            << "; qscan: " << header.last_read();
-  }
   p.daten = header.daten();
   p.status = header.status();
   // if (a()->user()->IsRestrictionValidate()) {
@@ -426,9 +577,6 @@ bool WWIVMessageArea::AddMessage(const Message& message, const MessageAreaOption
   if (!sub_.nets.empty()) {
     if (sub_.anony & anony_val_net && !header.pending_network()) {
       p.status |= status_pending_net;
-      UserManager um(wwiv_api_->config());
-      SSM ssm(wwiv_api_->config(), um);
-      ssm.send_local(1, StrCat("Unvalidated net posts on: ", sub_.name));
     } else if (options.send_post_to_network) {
       LOG(INFO) << "** Sending the newly added message out on all of the networks.";
       auto net = *sub_.nets.begin();
@@ -443,67 +591,214 @@ bool WWIVMessageArea::AddMessage(const Message& message, const MessageAreaOption
     }
   }
 
-  auto text = StrCat(header.from(), "\r\n", daten_to_wwivnet_time(header.daten()), "\r\n",
-                     message.text().text());
+  text = StrCat(header.from(), "\r\n", daten_to_wwivnet_time(header.daten()), "\r\n",
+                message.text().text());
 
   // WWIV 4.x requires a control-Z to terminate the message, WWIV 5.x
   // does not, and removes it on read.
   if (text.back() != CZ) {
     text.push_back(CZ);
   }
+  return true;
+}
 
-  if (!savefile(text, &p.msg)) {
+bool WWIVMessageArea::AddMessage(const Message& message, const MessageAreaOptions& options) {
+  return AddMessages({&message}, options);
+}
+
+bool WWIVMessageArea::AddMessages(const std::vector<const Message*>& messages,
+                                  const MessageAreaOptions& options) {
+  if (messages.empty()) {
+    return true;
+  }
+
+  // Reserve the qscan values for all of the new messages at once.
+  int num_new = 0;
+  for (const auto* message : messages) {
+    const auto& header = dynamic_cast<const WWIVMessageHeader&>(message->header());
+    if (header.last_read() == 0) {
+      ++num_new;
+    } else {
+      VLOG(2) << "AddMessage called with existing qscan ptr: title: " << header.title()
+              << "; qscan: " << header.last_read();
+    }
+  }
+  uint32_t qscan = 0;
+  if (num_new > 0) {
+    // new messages.
+    VLOG(3) << "AddMessage needs " << num_new << " qscan value(s)";
+    qscan = next_qscan_value_and_increment_post(api_->root_directory(), num_new);
+    if (qscan == 0) {
+      LOG(ERROR) << "Failed to get qscan value!";
+      return false;
+    }
+  }
+
+  vector<postrec> posts(messages.size());
+  vector<string> texts(messages.size());
+  bool pending_net = false;
+  for (size_t i = 0; i < messages.size(); i++) {
+    const auto& header = dynamic_cast<const WWIVMessageHeader&>(messages[i]->header());
+    if (!sub_.nets.empty() && (sub_.anony & anony_val_net) && !header.pending_network()) {
+      // CreatePost marks this as needing network validation.
+      pending_net = true;
+    }
+    if (!CreatePost(*messages[i], options, posts[i], texts[i])) {
+      return false;
+    }
+    if (posts[i].qscan == 0) {
+      posts[i].qscan = qscan++;
+    }
+  }
+  if (pending_net) {
+    // Let the sysop know once, no matter how many posts need validation.
+    UserManager um(wwiv_api_->config());
+    SSM ssm(wwiv_api_->config(), um);
+    ssm.send_local(1, StrCat("Unvalidated net posts on: ", sub_.name));
+  }
+
+  vector<messagerec> msgs;
+  if (!savefiles(texts, msgs)) {
     LOG(ERROR) << "Failed to save message text.";
     return false;
   }
-  auto result = add_post(p);
+  for (size_t i = 0; i < posts.size(); i++) {
+    posts[i].msg = msgs[i];
+  }
+  auto result = add_posts(posts);
   if (result) {
-    DeleteExcess();
+    DeleteExcess(size_int(posts));
   }
   return result;
 }
 
 bool WWIVMessageArea::DeleteMessage(int message_number) {
-  auto num_messages = number_of_messages();
-  if (message_number < 1) {
+  const auto* view = sub_view();
+  if (!view) {
     return false;
-  } else if (message_number > num_messages) {
+  }
+  const auto record = record_number(*view, message_number);
+  if (record == 0) {
     return false;
   }
 
-  DataFile<postrec> sub(sub_filename_,
-                        File::modeBinary | File::modeCreateFile | File::modeReadWrite);
+  int num_records = 0;
+  int num_tombstones = 0;
+  {
+    DataFile<postrec> sub(sub_filename_,
+                          File::modeBinary | File::modeCreateFile | File::modeReadWrite);
+    if (!sub) {
+      // TODO: throw exception
+      return false;
+    }
+    postrec post;
+    if (!sub.Read(record, &post)) {
+      return false;
+    }
+    if (post.msg.storage_type != 2) {
+      // We only support type-2 on the WWIV API.
+      return false;
+    }
+    if (post.status & status_post_tombstone) {
+      // Already deleted.
+      return true;
+    }
+
+    // Just mark it as a tombstone, Compact will remove the text and post
+    // record.
+    post.status |= status_post_tombstone;
+    if (!sub.Write(record, &post)) {
+      return false;
+    }
+    auto wwiv_header = ReadHeader(sub);
+    num_records = wwiv_header.active_message_count();
+    const auto had_tombstones = wwiv_header.tombstone_message_count() > 0;
+    num_tombstones = wwiv_header.tombstone_message_count() + 1;
+    wwiv_header.set_tombstone_message_count(static_cast<uint16_t>(num_tombstones));
+    if (!WriteHeader(sub, wwiv_header)) {
+      return false;
+    }
+    const auto mod_count = wwiv_header.header().mod_count;
+    wwiv_api_->sub_cache().dupe_index(sub_filename_).Touch(mod_count, mod_count + 1);
+
+    // Update the live posts in place rather than rescanning the sub.
+    if (!had_tombstones) {
+      live_posts_.resize(num_records);
+      std::iota(std::begin(live_posts_), std::end(live_posts_), uint16_t{1});
+      live_posts_valid_ = true;
+    } else if (!live_posts_valid_ || live_posts_mod_count_ != mod_count ||
+               live_posts_num_records_ != num_records) {
+      live_posts_valid_ = false;
+    }
+    if (live_posts_valid_) {
+      auto it = std::lower_bound(std::begin(live_posts_), std::end(live_posts_), record);
+      if (it != std::end(live_posts_) && *it == record) {
+        live_posts_.erase(it);
+      }
+      live_posts_mod_count_ = mod_count + 1;
+      live_posts_num_records_ = num_records;
+    }
+  }
+
+  const auto percent = api_->options().compact_deleted_percent;
+  if (percent > 0 && num_tombstones * 100 > num_records * percent) {
+    VLOG(1) << "Compacting " << sub_filename_ << "; " << num_tombstones << " of " << num_records
+            << " messages are deleted.";
+    return Compact();
+  }
+  return true;
+}
+
+bool WWIVMessageArea::Compact() {
+  DataFile<postrec> sub(sub_filename_, File::modeBinary | File::modeReadWrite);
   if (!sub) {
-    // TODO: throw exception
     return false;
   }
-  postrec post;
-  sub.Read(message_number, &post);
-  if (post.msg.storage_type != 2) {
-    // We only support type-2 on the WWIV API.
+  WWIVMessageAreaHeader wwiv_header(ReadHeader(sub));
+  if (!wwiv_header.initialized()) {
+    return false;
+  }
+  const int num_messages = wwiv_header.active_message_count();
+  if (num_messages == 0) {
+    return true;
+  }
+  vector<postrec> posts(num_messages);
+  if (!sub.ReadRange(1, num_messages, &posts[0])) {
     return false;
   }
 
-  // Remove text
-  remove_link(post.msg);
-
-  // Remove post record.
-  for (int cur = message_number + 1; cur <= num_messages; cur++) {
-    postrec tmp;
-    sub.Read(cur, &tmp);
-    sub.Write(cur - 1, &tmp);
+  vector<messagerec> deleted_text;
+  vector<postrec> live;
+  live.reserve(posts.size());
+  for (const auto& p : posts) {
+    if (p.status & status_post_tombstone) {
+      if (p.msg.storage_type == STORAGE_TYPE) {
+        deleted_text.push_back(p.msg);
+      }
+    } else {
+      live.push_back(p);
+    }
+  }
+  if (live.size() == posts.size() && wwiv_header.tombstone_message_count() == 0) {
+    // Nothing to do.
+    return true;
   }
 
-  // Update header.
-  postrec header;
-  sub.Read(0, &header);
-  // decrement number of posts.
-  // TODO(rushfan): Should we check these?
-  --header.owneruser;
-  header.owneruser = static_cast<uint16_t>(std::max(0, num_messages - 1));
-  sub.Write(0, &header);
+  // Rewrite all of the posts at once. The file isn't truncated since
+  // other nodes may have it mapped, the header's count is what matters.
+  if (!sub.WriteRange(1, size_int(live), live.data())) {
+    return false;
+  }
+  wwiv_header.set_active_message_count(static_cast<uint16_t>(live.size()));
+  wwiv_header.set_tombstone_message_count(0);
+  if (!WriteHeader(sub, wwiv_header)) {
+    return false;
+  }
+  sub.Close();
 
-  return true;
+  VLOG(1) << "Compacted " << sub_filename_ << "; removed " << posts.size() - live.size()
+          << " deleted messages.";
+  return deleted_text.empty() || remove_links(deleted_text);
 }
 
 bool WWIVMessageArea::ResyncMessage(int& message_number) {
@@ -527,15 +822,11 @@ bool WWIVMessageArea::ResyncMessage(int& message_number) {
 }
 
 bool WWIVMessageArea::HasSubChanged() {
-  subfile_header_t last_read_header = this->header_;
-  subfile_header_t current_read_header = {};
-  {
-    DataFile<postrec> sub(sub_filename_, File::modeBinary | File::modeReadOnly);
-    WWIVMessageAreaHeader h = ReadHeader(sub);
-    current_read_header = h.raw_header();
+  const auto* sub = sub_view();
+  if (!sub) {
+    return true;
   }
-
-  return current_read_header.mod_count > last_read_header.mod_count;
+  return ReadHeader(*sub).raw_header().mod_count > header_.mod_count;
 }
 
 bool WWIVMessageArea::ResyncMessage(int& message_number, Message& raw_message) {
@@ -619,28 +910,47 @@ std::unique_ptr<Message> WWIVMessageArea::CreateMessage() {
 
 bool WWIVMessageArea::Exists(daten_t d, const std::string& title, uint16_t from_system,
                              uint16_t from_user) {
-  DataFile<postrec> sub(sub_filename_);
+  const auto* sub = sub_view();
   if (!sub) {
     return false;
   }
-  std::vector<postrec> headers;
-  if (!sub.ReadVector(headers)) {
-    return false;
-  }
+  const auto num_messages = ReadHeader(*sub).active_message_count();
+  auto& index = wwiv_api_->sub_cache().dupe_index(sub_filename_);
+  if (!index.current(sub_view_mod_count_, num_messages)) {
+    index.Rebuild(*sub, num_messages, sub_view_mod_count_);
+  }
+
+  // Since we don't have a global message id, use the combination of
+  // date + title + from system + from user.
+  bool found = false;
+  index.find(WWIVSubDupeIndex::key(d, title.c_str(), from_system, from_user), [&](int i) {
+    const auto* h = sub->at(i);
+    found = h != nullptr && !(h->status & status_post_tombstone) && h->daten == d &&
+            iequals(h->title, title) && h->ownersys == from_system && h->owneruser == from_user;
+    return found;
+  });
+  return found;
+}
 
-  for (const auto& h : headers) {
-    if (h.status & status_delete) {
-      continue;
-    }
-    // Since we don't have a global message id, use the combination of
-    // date + title + from system + from user.
-    if (h.daten == d && iequals(h.title, title) && h.ownersys == from_system &&
-        h.owneruser == from_user) {
-      return true;
+const MappedDataFile<postrec>* WWIVMessageArea::sub_view() {
+  if (sub_view_ && sub_view_->ok()) {
+    const auto* h = reinterpret_cast<const subfile_header_t*>(sub_view_->at(0));
+    // Older writers (like the BBS) don't always bump mod_count, so also
+    // remap if the header claims more posts than are currently mapped.
+    if (h->mod_count == sub_view_mod_count_ &&
+        h->active_message_count < sub_view_->number_of_records()) {
+      return sub_view_.get();
     }
   }
-
-  return false;
+  if (!sub_view_) {
+    sub_view_ = make_unique<MappedDataFile<postrec>>(sub_filename_);
+  }
+  if (!sub_view_->Open() || sub_view_->number_of_records() == 0) {
+    sub_view_->Close();
+    return nullptr;
+  }
+  sub_view_mod_count_ = reinterpret_cast<const subfile_header_t*>(sub_view_->at(0))->mod_count;
+  return sub_view_.get();
 }
 
 MessageAreaLastRead& WWIVMessageArea::last_read() const noexcept { return *last_read_; }
@@ -664,7 +974,7 @@ message_anonymous_t WWIVMessageArea::anonymous_type() const noexcept {
 
 // Implementation Details
 
-bool WWIVMessageArea::add_post(const postrec& post) {
+bool WWIVMessageArea::add_posts(const vector<postrec>& posts) {
   DataFile<postrec> sub(sub_filename_, File::modeBinary | File::modeReadWrite);
   if (!sub) {
     return false;
@@ -677,14 +987,28 @@ bool WWIVMessageArea::add_post(const postrec& post) {
     // This is an invalid header.
     return false;
   }
-  uint32_t msgnum = wwiv_header.increment_active_message_count();
+  const int first = wwiv_header.active_message_count() + 1;
+  const int last = first + size_int(posts) - 1;
+  if (last > std::numeric_limits<uint16_t>::max()) {
+    LOG(ERROR) << "Too many messages in sub: " << sub_filename_;
+    return false;
+  }
 
-  // add the new post
-  if (!sub.Write(msgnum, &post)) {
+  // add the new posts
+  if (!sub.WriteRange(first, size_int(posts), posts.data())) {
     return false;
   }
   // Write the header now.
-  return WriteHeader(sub, wwiv_header);
+  wwiv_header.set_active_message_count(static_cast<uint16_t>(last));
+  if (!WriteHeader(sub, wwiv_header)) {
+    return false;
+  }
+  const auto mod_count = wwiv_header.header().mod_count;
+  auto& index = wwiv_api_->sub_cache().dupe_index(sub_filename_);
+  for (int i = 0; i < size_int(posts); i++) {
+    index.Add(posts[i], first + i, i == 0 ? mod_count : mod_count + 1, mod_count + 1);
+  }
+  return true;
 }
 
 } // namespace msgapi
@@ -24,6 +24,7 @@
 #include <vector>
 
 #include "core/file.h"
+#include "core/mmap_file.h"
 #include "sdk/msgapi/message.h"
 #include "sdk/msgapi/message_api.h"
 #include "sdk/msgapi/message_wwiv.h"
@@ -46,6 +47,10 @@ public:
     header_.active_message_count = active_message_count;
   }
   uint16_t increment_active_message_count() { return ++header_.active_message_count; }
+  uint16_t tombstone_message_count() const { return header_.tombstone_message_count; }
+  void set_tombstone_message_count(uint16_t tombstone_message_count) {
+    header_.tombstone_message_count = tombstone_message_count;
+  }
   bool initialized() const { return initialized_; }
   void set_initialized(bool initialized) { initialized_ = initialized; }
 
@@ -91,7 +96,10 @@ public:
   std::unique_ptr<MessageHeader> ReadMessageHeader(int message_number) override;
   std::unique_ptr<MessageText> ReadMessageText(int message_number) override;
   bool AddMessage(const Message& message, const MessageAreaOptions& options) override;
+  bool AddMessages(const std::vector<const Message*>& messages,
+                   const MessageAreaOptions& options) override;
   bool DeleteMessage(int message_number) override;
+  bool Compact() override;
   bool ResyncMessage(int& message_number) override;
   bool ResyncMessage(int& message_number, Message& message) override;
 
@@ -102,13 +110,35 @@ public:
   message_anonymous_t anonymous_type() const noexcept override;
 
 private:
-  int DeleteExcess();
-  bool add_post(const postrec& post);
+  int DeleteExcess(int num_added);
+  // Fills in the post record and text to save for message.
+  bool CreatePost(const Message& message, const MessageAreaOptions& options, postrec& p,
+                  std::string& text);
+  // Appends posts to the sub with a single write.
+  bool add_posts(const std::vector<postrec>& posts);
   bool ParseMessageText(const postrec& header, int message_number, std::string& from_username,
                         std::string& date, std::string& to, std::string& in_reply_to,
                         std::string& text);
+  // Like ParseMessageText but only reads as much of the text as is needed
+  // for the header lines.
+  bool ParseMessageHeader(const postrec& header, std::string& from_username, std::string& date,
+                          std::string& to, std::string& in_reply_to);
   bool HasSubChanged();
   bool ResyncMessageImpl(int& message_number, Message& message);
+  /**
+   * Returns the read only view of the *.sub file, remapping it if the
+   * header's mod_count has changed since it was last mapped. Any pointers
+   * into a previously returned view are invalid after this call.
+   */
+  const wwiv::core::MappedDataFile<postrec>* sub_view();
+  /**
+   * Returns the record number in sub of message_number, skipping over
+   * tombstones, or 0 if there is no such message.
+   */
+  int record_number(const wwiv::core::MappedDataFile<postrec>& sub, int message_number);
+  // Returns the record numbers of the posts in sub that aren't tombstones.
+  const std::vector<uint16_t>& live_posts(const wwiv::core::MappedDataFile<postrec>& sub,
+                                          int num_records);
 
   static constexpr uint8_t STORAGE_TYPE = 2;
 
@@ -123,6 +153,17 @@ private:
   subfile_header_t header_;
   int subnum_{-1};
   std::unique_ptr<MessageAreaLastRead> last_read_;
+  // Memory mapped *.sub file used for all reads.
+  std::unique_ptr<wwiv::core::MappedDataFile<postrec>> sub_view_;
+  // mod_count from the header when sub_view_ was mapped.
+  uint64_t sub_view_mod_count_{0};
+  // Record numbers of the posts that aren't tombstones. Only used while the
+  // sub has tombstones, since otherwise message numbers are record numbers.
+  std::vector<uint16_t> live_posts_;
+  bool live_posts_valid_{false};
+  // mod_count and number of records of the sub when live_posts_ was built.
+  uint64_t live_posts_mod_count_{0};
+  int live_posts_num_records_{0};
 };
 
 } // namespace msgapi
@@ -0,0 +1,213 @@
+/**************************************************************************/
+/*                                                                        */
+/*                            WWIV Version 5                              */
+/*             Copyright (C)2017, WWIV Software Services                  */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "sdk/msgapi/sub_cache_wwiv.h"
+
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include "core/log.h"
+
+using std::string;
+using namespace wwiv::core;
+
+namespace wwiv {
+namespace sdk {
+namespace msgapi {
+
+WWIVSubIndex::WWIVSubIndex(const std::string& sub_filename) : file_(sub_filename) {}
+
+bool WWIVSubIndex::Refresh() {
+  if (file_.ok()) {
+    const auto* h = reinterpret_cast<const subfile_header_t*>(file_.at(0));
+    // Not every writer bumps mod_count (the BBS doesn't when deleting), so
+    // also check the number of posts.
+    if (h->mod_count == mod_count_ && h->active_message_count == header_message_count_ &&
+        header_message_count_ < file_.number_of_records()) {
+      return true;
+    }
+  }
+  if (!file_.Open() || file_.number_of_records() == 0) {
+    file_.Close();
+    num_messages_ = 0;
+    records_.clear();
+    by_qscan_.clear();
+    first_message_from_.clear();
+    return false;
+  }
+
+  const auto* h = reinterpret_cast<const subfile_header_t*>(file_.at(0));
+  mod_count_ = h->mod_count;
+  header_message_count_ = h->active_message_count;
+  const auto num_records = std::min<int>(header_message_count_, file_.number_of_records() - 1);
+
+  records_.clear();
+  by_qscan_.clear();
+  by_qscan_.reserve(num_records);
+  for (int i = 1; i <= num_records; i++) {
+    const auto* p = file_.at(i);
+    if (p->status & status_post_tombstone) {
+      continue;
+    }
+    records_.push_back(static_cast<uint16_t>(i));
+    by_qscan_.emplace_back(p->qscan, static_cast<uint16_t>(records_.size()));
+  }
+  num_messages_ = static_cast<int>(records_.size());
+  // Posts are almost always already in qscan order.
+  if (!std::is_sorted(std::begin(by_qscan_), std::end(by_qscan_))) {
+    std::sort(std::begin(by_qscan_), std::end(by_qscan_));
+  }
+  first_message_from_.resize(by_qscan_.size());
+  uint16_t lowest = std::numeric_limits<uint16_t>::max();
+  for (auto i = by_qscan_.size(); i-- > 0;) {
+    lowest = std::min(lowest, by_qscan_[i].second);
+    first_message_from_[i] = lowest;
+  }
+  VLOG(3) << "Rebuilt sub index for: " << file_.file().full_pathname() << "; " << num_messages_
+          << " messages; mod_count: " << mod_count_;
+  return true;
+}
+
+const postrec* WWIVSubIndex::post(int message_number) const noexcept {
+  const auto record = record_number(message_number);
+  return record > 0 ? file_.at(record) : nullptr;
+}
+
+int WWIVSubIndex::record_number(int message_number) const noexcept {
+  if (message_number < 1 || message_number > num_messages_) {
+    return 0;
+  }
+  return records_[message_number - 1];
+}
+
+uint32_t WWIVSubIndex::last_qscan() const noexcept {
+  const auto* p = post(num_messages_);
+  return p ? p->qscan : 0;
+}
+
+int WWIVSubIndex::first_message_after(uint32_t qscan) const noexcept {
+  auto it = std::upper_bound(
+      std::begin(by_qscan_), std::end(by_qscan_), qscan,
+      [](uint32_t q, const std::pair<uint32_t, uint16_t>& p) { return q < p.first; });
+  if (it == std::end(by_qscan_)) {
+    return num_messages_ + 1;
+  }
+  return first_message_from_[std::distance(std::begin(by_qscan_), it)];
+}
+
+int WWIVSubIndex::number_of_messages_after(uint32_t qscan) const noexcept {
+  auto it = std::upper_bound(
+      std::begin(by_qscan_), std::end(by_qscan_), qscan,
+      [](uint32_t q, const std::pair<uint32_t, uint16_t>& p) { return q < p.first; });
+  return static_cast<int>(std::distance(it, std::end(by_qscan_)));
+}
+
+// FNV-1a
+static constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+static constexpr uint64_t FNV_PRIME = 1099511628211ULL;
+
+static uint64_t fnv1a(uint64_t h, const void* data, std::size_t size) noexcept {
+  const auto* p = static_cast<const uint8_t*>(data);
+  for (std::size_t i = 0; i < size; i++) {
+    h = (h ^ p[i]) * FNV_PRIME;
+  }
+  return h;
+}
+
+uint64_t WWIVSubDupeIndex::key(daten_t daten, const char* title, uint16_t from_system,
+                               uint16_t from_user) noexcept {
+  uint64_t h = FNV_OFFSET_BASIS;
+  h = fnv1a(h, &daten, sizeof(daten));
+  h = fnv1a(h, &from_system, sizeof(from_system));
+  h = fnv1a(h, &from_user, sizeof(from_user));
+  for (; *title; ++title) {
+    const auto c = static_cast<uint8_t>(std::tolower(static_cast<unsigned char>(*title)));
+    h = (h ^ c) * FNV_PRIME;
+  }
+  return h;
+}
+
+uint64_t WWIVSubDupeIndex::key(const postrec& p) noexcept {
+  // The title may not be NUL terminated if it's the full length.
+  char title[sizeof(p.title) + 1]{};
+  std::copy(std::begin(p.title), std::end(p.title), title);
+  return key(p.daten, title, p.ownersys, p.owneruser);
+}
+
+void WWIVSubDupeIndex::Rebuild(const MappedDataFile<postrec>& sub, int num_messages,
+                               uint64_t mod_count) {
+  posts_.clear();
+  posts_.reserve(num_messages);
+  num_messages_ = 0;
+  for (int i = 1; i <= num_messages; i++) {
+    const auto* p = sub.at(i);
+    if (p == nullptr) {
+      break;
+    }
+    if (p->status & status_post_tombstone) {
+      continue;
+    }
+    posts_.emplace(key(*p), static_cast<uint16_t>(i));
+  }
+  num_messages_ = num_messages;
+  mod_count_ = mod_count;
+  valid_ = true;
+  VLOG(3) << "Rebuilt dupe index for: " << sub.file().full_pathname() << "; " << posts_.size()
+          << " posts.";
+}
+
+void WWIVSubDupeIndex::Add(const postrec& post, int message_number, uint64_t old_mod_count,
+                           uint64_t new_mod_count) {
+  if (!current(old_mod_count, message_number - 1)) {
+    valid_ = false;
+    return;
+  }
+  posts_.emplace(key(post), static_cast<uint16_t>(message_number));
+  num_messages_ = message_number;
+  mod_count_ = new_mod_count;
+}
+
+void WWIVSubDupeIndex::Touch(uint64_t old_mod_count, uint64_t new_mod_count) noexcept {
+  if (!valid_ || mod_count_ != old_mod_count) {
+    valid_ = false;
+    return;
+  }
+  mod_count_ = new_mod_count;
+}
+
+void WWIVSubDupeIndex::clear() noexcept {
+  valid_ = false;
+  posts_.clear();
+}
+
+const WWIVSubIndex* WWIVSubCache::get(const std::string& sub_filename) {
+  auto& index = subs_[sub_filename];
+  if (!index) {
+    index = std::make_unique<WWIVSubIndex>(sub_filename);
+  }
+  if (!index->Refresh()) {
+    return nullptr;
+  }
+  return index.get();
+}
+
+} // namespace msgapi
+} // namespace sdk
+} // namespace wwiv
@@ -0,0 +1,169 @@
+/**************************************************************************/
+/*                                                                        */
+/*                            WWIV Version 5                              */
+/*             Copyright (C)2017, WWIV Software Services                  */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#ifndef __INCLUDED_SDK_MSGAPI_SUB_CACHE_WWIV_H__
+#define __INCLUDED_SDK_MSGAPI_SUB_CACHE_WWIV_H__
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "core/mmap_file.h"
+#include "sdk/vardec.h"
+
+namespace wwiv {
+namespace sdk {
+namespace msgapi {
+
+/**
+ * Read only view of a single *.sub file along with an index of the posts
+ * sorted by qscan pointer. The posts themselves are never copied, they are
+ * read directly from a memory mapping of the file. The qscan index is only
+ * rebuilt when the header's mod_count or number of posts changes.
+ *
+ * Message numbers skip posts marked with status_post_tombstone, like the
+ * message API does, so they may differ from record numbers in the file
+ * until the sub is compacted.
+ */
+class WWIVSubIndex {
+public:
+  explicit WWIVSubIndex(const std::string& sub_filename);
+
+  /** Remaps the sub and rebuilds the index if it has changed. */
+  bool Refresh();
+
+  int number_of_messages() const noexcept { return num_messages_; }
+  uint64_t mod_count() const noexcept { return mod_count_; }
+  /** Returns message_number (1 based) or nullptr if it does not exist. */
+  const postrec* post(int message_number) const noexcept;
+  /** Returns the record number in the file of message_number, or 0. */
+  int record_number(int message_number) const noexcept;
+  /** qscan pointer of the last post in the sub, 0 if the sub is empty. */
+  uint32_t last_qscan() const noexcept;
+  /**
+   * Returns the lowest message number with a qscan pointer newer than
+   * qscan, or number_of_messages() + 1 if there are none.
+   */
+  int first_message_after(uint32_t qscan) const noexcept;
+  /** Returns the number of messages with a qscan pointer newer than qscan. */
+  int number_of_messages_after(uint32_t qscan) const noexcept;
+
+private:
+  wwiv::core::MappedDataFile<postrec> file_;
+  uint64_t mod_count_{0};
+  uint16_t header_message_count_{0};
+  int num_messages_{0};
+  // Record number of each message.
+  std::vector<uint16_t> records_;
+  // (qscan, message number) for every post, sorted by qscan.
+  std::vector<std::pair<uint32_t, uint16_t>> by_qscan_;
+  // Lowest message number in by_qscan_[i..end].
+  std::vector<uint16_t> first_message_from_;
+};
+
+/**
+ * Index of the posts in a *.sub file by (daten, from system, from user,
+ * title) used to find duplicate network posts without scanning the whole
+ * sub. Keys are only hashes, so callers must check the posts returned by
+ * find before treating them as duplicates.
+ *
+ * The index is current as of a header mod_count and number of messages.
+ * Writers that know the index was current before their change can keep it
+ * current with Add and Touch, anything else causes the caller to Rebuild.
+ */
+class WWIVSubDupeIndex {
+public:
+  /** Returns the key for a post, titles are compared case insensitively. */
+  static uint64_t key(daten_t daten, const char* title, uint16_t from_system,
+                      uint16_t from_user) noexcept;
+  static uint64_t key(const postrec& p) noexcept;
+
+  bool current(uint64_t mod_count, int num_messages) const noexcept {
+    return valid_ && mod_count == mod_count_ && num_messages == num_messages_;
+  }
+  /** Indexes posts 1 through num_messages from sub. */
+  void Rebuild(const wwiv::core::MappedDataFile<postrec>& sub, int num_messages,
+               uint64_t mod_count);
+  /**
+   * Adds post as message_number, which must be the new last message.
+   * The index is only updated if it was current as of old_mod_count.
+   */
+  void Add(const postrec& post, int message_number, uint64_t old_mod_count,
+           uint64_t new_mod_count);
+  /**
+   * Records a change to the sub that did not add or renumber any posts,
+   * such as marking one as deleted.
+   */
+  void Touch(uint64_t old_mod_count, uint64_t new_mod_count) noexcept;
+  void clear() noexcept;
+
+  /** Calls fn with each message number whose post has the same key. */
+  template <typename F> void find(uint64_t key, F fn) const {
+    auto range = posts_.equal_range(key);
+    for (auto it = range.first; it != range.second; ++it) {
+      if (fn(static_cast<int>(it->second))) {
+        return;
+      }
+    }
+  }
+
+private:
+  bool valid_{false};
+  uint64_t mod_count_{0};
+  int num_messages_{0};
+  std::unordered_multimap<uint64_t, uint16_t> posts_;
+};
+
+/**
+ * Cache of WWIVSubIndex keyed by the *.sub filename. This is shared by
+ * everything using the same WWIVMessageApi, so new-scans across many subs
+ * only need to read a sub again once it has changed.
+ */
+class WWIVSubCache {
+public:
+  /**
+   * Returns the up to date index for sub_filename or nullptr if it can not
+   * be read. The result is owned by the cache, any posts returned from it
+   * are only valid until the next call to get for the same sub.
+   */
+  const WWIVSubIndex* get(const std::string& sub_filename);
+  /**
+   * Returns the duplicate index for sub_filename. It is up to the caller
+   * to check whether it is current.
+   */
+  WWIVSubDupeIndex& dupe_index(const std::string& sub_filename) {
+    return dupes_[sub_filename];
+  }
+  void clear() {
+    subs_.clear();
+    dupes_.clear();
+  }
+
+private:
+  std::map<std::string, std::unique_ptr<WWIVSubIndex>> subs_;
+  std::map<std::string, WWIVSubDupeIndex> dupes_;
+};
+
+} // namespace msgapi
+} // namespace sdk
+} // namespace wwiv
+
+#endif // __INCLUDED_SDK_MSGAPI_SUB_CACHE_WWIV_H__
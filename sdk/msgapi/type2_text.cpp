@@ -17,13 +17,18 @@
 /**************************************************************************/
 #include "sdk/msgapi/type2_text.h"
 
+#include <algorithm>
+#include <cstring>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "core/datafile.h"
 #include "core/file.h"
+#include "core/log.h"
 #include "core/stl.h"
 #include "core/strings.h"
 #include "bbs/subacc.h"
@@ -48,6 +53,64 @@ using namespace wwiv::stl;
 using namespace wwiv::strings;
 
 constexpr char CZ = 26;
+static constexpr size_t MAX_GAT_SECTIONS = 1024;
+static constexpr int UNKNOWN_FREE_BLOCKS = -1;
+
+// Number of free blocks in each GAT section, keyed by the text filename.
+// These are only hints since other nodes may write to the same file, so the
+// GAT for a section is always reloaded from disk before allocating from it.
+static std::mutex free_blocks_mu;
+static std::map<std::string, std::vector<int>> free_blocks_by_file;
+
+static std::vector<int>& free_block_hints(const std::string& filename) {
+  auto& hints = free_blocks_by_file[filename];
+  if (hints.empty()) {
+    hints.resize(MAX_GAT_SECTIONS, UNKNOWN_FREE_BLOCKS);
+  }
+  return hints;
+}
+
+static int count_free_blocks(const vector<gati_t>& gat) {
+  // Block 0 is never used since a 0 entry in the GAT means free.
+  return static_cast<int>(std::count(std::begin(gat) + 1, std::end(gat), 0));
+}
+
+/**
+ * Returns num_blocks free blocks from gat, preferring a single contiguous
+ * run so the text can be written (and later read) as one extent. Falls
+ * back to the first free blocks found. Returns an empty vector if there
+ * is not enough room in this section.
+ */
+static vector<gati_t> find_free_blocks(const vector<gati_t>& gat, int num_blocks) {
+  vector<gati_t> blocks;
+  int run_start = 0;
+  int run_length = 0;
+  for (int i = 1; i < GAT_NUMBER_ELEMENTS; i++) {
+    if (gat[i] != 0) {
+      run_length = 0;
+      continue;
+    }
+    if (run_length++ == 0) {
+      run_start = i;
+    }
+    if (run_length == num_blocks) {
+      for (int b = run_start; b < run_start + num_blocks; b++) {
+        blocks.push_back(static_cast<gati_t>(b));
+      }
+      return blocks;
+    }
+  }
+
+  for (int i = 1; i < GAT_NUMBER_ELEMENTS && size_int(blocks) < num_blocks; i++) {
+    if (gat[i] == 0) {
+      blocks.push_back(static_cast<gati_t>(i));
+    }
+  }
+  if (size_int(blocks) < num_blocks) {
+    blocks.clear();
+  }
+  return blocks;
+}
 
 Type2Text::Type2Text(const std::string& text_filename)
   : filename_(text_filename) {}
@@ -55,24 +118,41 @@ Type2Text::Type2Text(const std::string& text_filename)
 // Implementation Details
 
 bool Type2Text::remove_link(messagerec& msg) {
+  return remove_links({msg});
+}
+
+bool Type2Text::remove_links(const std::vector<messagerec>& msgs) {
   unique_ptr<File> file(OpenMessageFile());
-  if (!file->IsOpen()) {
+  if (!file || !file->IsOpen()) {
     return false;
   }
-  size_t section = static_cast<int>(msg.stored_as / GAT_NUMBER_ELEMENTS);
-  vector<gati_t> gat = load_gat(*file, section);
-  uint32_t current_section = msg.stored_as % GAT_NUMBER_ELEMENTS;
-  while (current_section > 0 && current_section < GAT_NUMBER_ELEMENTS) {
-    uint32_t next_section = static_cast<long>(gat[current_section]);
-    gat[current_section] = 0;
-    current_section = next_section;
+  // Group by section so that each GAT is loaded and saved once.
+  std::map<size_t, vector<uint32_t>> chains_by_section;
+  for (const auto& msg : msgs) {
+    chains_by_section[msg.stored_as / GAT_NUMBER_ELEMENTS].push_back(msg.stored_as %
+                                                                      GAT_NUMBER_ELEMENTS);
+  }
+  for (const auto& e : chains_by_section) {
+    const auto section = e.first;
+    vector<gati_t> gat = load_gat(*file, section);
+    for (auto current_section : e.second) {
+      while (current_section > 0 && current_section < GAT_NUMBER_ELEMENTS) {
+        uint32_t next_section = static_cast<long>(gat[current_section]);
+        gat[current_section] = 0;
+        current_section = next_section;
+      }
+    }
+    save_gat(*file, section, gat);
+
+    if (section < MAX_GAT_SECTIONS) {
+      std::lock_guard<std::mutex> lock(free_blocks_mu);
+      free_block_hints(filename_)[section] = count_free_blocks(gat);
+    }
   }
-  save_gat(*file, section, gat);
   file->Close();
   return true;
 }
 
-
 /**
 * Opens the message area file {messageAreaFileName} and returns the file handle.
 * Note: This is a Private method to this module.
@@ -101,21 +181,19 @@ std::vector<gati_t> Type2Text::load_gat(File& file, size_t section) {
     file.set_length(section_pos);
     file_size = section_pos;
   }
-  file.Seek(section_pos, File::Whence::begin);
   if (file_size < static_cast<long>(section_pos + GAT_SECTION_SIZE)) {
     // TODO(rushfan): Check that gat is loaded.
-    file.Write(&gat[0], GAT_SECTION_SIZE);
+    file.WriteAt(section_pos, &gat[0], GAT_SECTION_SIZE);
   } else {
     // TODO(rushfan): Check that gat is loaded.
-    file.Read(&gat[0], GAT_SECTION_SIZE);
+    file.ReadAt(section_pos, &gat[0], GAT_SECTION_SIZE);
   }
   return gat;
 }
 
 void Type2Text::save_gat(File& file, size_t section, const std::vector<gati_t>& gat) {
   long section_pos = static_cast<long>(section * GATSECLEN);
-  file.Seek(section_pos, File::Whence::begin);
-  file.Write(&gat[0], GAT_SECTION_SIZE);
+  file.WriteAt(section_pos, &gat[0], GAT_SECTION_SIZE);
 
   // TODO(rushfan): Pass in the status manager. this is needed to
   // set a()->subchg if any of the subs receive a post so that 
@@ -126,7 +204,7 @@ void Type2Text::save_gat(File& file, size_t section, const std::vector<gati_t>&
   // a()->status_manager()->CommitTransaction(status);
 }
 
-bool Type2Text::readfile(const messagerec* msg, string* out) {
+bool Type2Text::readfile(const messagerec* msg, string* out, size_t max_blocks) {
   out->clear();
   unique_ptr<File> file(OpenMessageFile());
   if (!file) {
@@ -134,17 +212,50 @@ bool Type2Text::readfile(const messagerec* msg, string* out) {
     return false;
   }
   const size_t gat_section = msg->stored_as / GAT_NUMBER_ELEMENTS;
-  vector<gati_t> gat = load_gat(*file, gat_section);
+  max_blocks = std::min<size_t>(max_blocks, GAT_NUMBER_ELEMENTS);
 
+  // Resolve the whole chain of blocks before reading anything.  The first
+  // block is stored_as itself, so the GAT is only needed to go past it.
+  vector<gati_t> chain;
   uint32_t current_section = msg->stored_as % GAT_NUMBER_ELEMENTS;
-  while (current_section > 0 && current_section < GAT_NUMBER_ELEMENTS) {
-    file->Seek(MSG_STARTING(gat_section) + MSG_BLOCK_SIZE * static_cast<uint32_t>(current_section), File::Whence::begin);
-    char b[MSG_BLOCK_SIZE + 1];
-    file->Read(b, MSG_BLOCK_SIZE);
-    b[MSG_BLOCK_SIZE] = 0;
-    out->append(b);
-    current_section = gat[current_section];
+  if (max_blocks == 1) {
+    if (current_section > 0) {
+      chain.push_back(static_cast<gati_t>(current_section));
+    }
+  } else {
+    vector<gati_t> gat = load_gat(*file, gat_section);
+    while (current_section > 0 && current_section < GAT_NUMBER_ELEMENTS &&
+           chain.size() < max_blocks) {
+      chain.push_back(static_cast<gati_t>(current_section));
+      current_section = gat[current_section];
+    }
+  }
+
+  // Read each run of adjacent blocks (extent) with a single read.
+  out->resize(chain.size() * MSG_BLOCK_SIZE);
+  for (size_t i = 0; i < chain.size();) {
+    size_t run = 1;
+    while (i + run < chain.size() && chain[i + run] == chain[i] + run) {
+      ++run;
+    }
+    file->ReadAt(MSG_STARTING(gat_section) + MSG_BLOCK_SIZE * static_cast<uint32_t>(chain[i]),
+                 &(*out)[i * MSG_BLOCK_SIZE], run * MSG_BLOCK_SIZE);
+    i += run;
+  }
+
+  // Each block is NUL terminated if it's not full, so squeeze out
+  // everything after the NUL in each block.
+  size_t len = 0;
+  for (size_t i = 0; i < chain.size(); i++) {
+    const char* b = out->data() + i * MSG_BLOCK_SIZE;
+    const auto* nul = static_cast<const char*>(memchr(b, 0, MSG_BLOCK_SIZE));
+    const size_t block_len = nul ? static_cast<size_t>(nul - b) : MSG_BLOCK_SIZE;
+    if (len != i * MSG_BLOCK_SIZE) {
+      memmove(&(*out)[len], b, block_len);
+    }
+    len += block_len;
   }
+  out->resize(len);
 
   string::size_type last_cz = out->find_last_of(CZ);
   std::string::size_type last_block_start = out->length() - MSG_BLOCK_SIZE;
@@ -156,37 +267,138 @@ bool Type2Text::readfile(const messagerec* msg, string* out) {
 }
 
 bool Type2Text::savefile(const string& text, messagerec* msg) {
-  vector<gati_t> gati;
+  vector<messagerec> msgs;
+  if (!savefiles({text}, msgs)) {
+    msg->stored_as = 0xffffffff;
+    return false;
+  }
+  *msg = msgs.front();
+  return true;
+}
+
+bool Type2Text::savefiles(const vector<string>& texts, vector<messagerec>& msgs) {
+  msgs.assign(texts.size(), messagerec{2, 0xffffffff});
   unique_ptr<File> msgfile(OpenMessageFile());
-  if (!msgfile->IsOpen()) {
+  if (!msgfile || !msgfile->IsOpen()) {
     // Unable to write to the message file.
-    msg->stored_as = 0xffffffff;
     return false;
   }
+  // Sections past the end of the file are empty, no need to look at them
+  // until all of the existing ones are full.
+  auto num_existing_sections = std::min<size_t>(
+      MAX_GAT_SECTIONS, static_cast<size_t>((msgfile->length() + GATSECLEN - 1) / GATSECLEN));
+
+  std::unique_lock<std::mutex> lock(free_blocks_mu);
+  auto& hints = free_block_hints(filename_);
+
+  // The GAT of the section currently being allocated from, it's only saved
+  // once we move to another section or are done.
+  vector<gati_t> gat;
   size_t section = 0;
-  for (section = 0; section < 1024; section++) {
-    vector<gati_t> gat = load_gat(*msgfile, section);
-    int nNumBlocksRequired = static_cast<int>((text.length() + 511L) / MSG_BLOCK_SIZE);
-    gati_t i4 = 1;
-    gati.clear();
-    while (size_int(gati) < nNumBlocksRequired && i4 < GAT_NUMBER_ELEMENTS) {
-      if (gat[i4] == 0) {
-        gati.push_back(i4);
+  bool have_section = false;
+  // Text for a run of contiguous blocks not yet written, since texts
+  // allocated one after the other usually end up next to each other.
+  string pending;
+  long pending_pos = 0;
+
+  auto flush = [&]() {
+    if (!pending.empty()) {
+      msgfile->WriteAt(pending_pos, &pending[0], pending.size());
+      pending.clear();
+    }
+    if (have_section) {
+      save_gat(*msgfile, section, gat);
+    }
+  };
+  auto write_blocks = [&](long pos, const char* data, size_t len) {
+    if (!pending.empty() && pending_pos + static_cast<long>(pending.size()) != pos) {
+      msgfile->WriteAt(pending_pos, &pending[0], pending.size());
+      pending.clear();
+    }
+    if (pending.empty()) {
+      pending_pos = pos;
+    }
+    pending.append(data, len);
+  };
+
+  for (size_t m = 0; m < texts.size(); m++) {
+    const auto& text = texts[m];
+    const int num_blocks =
+        std::max<int>(1, static_cast<int>((text.length() + MSG_BLOCK_SIZE - 1) / MSG_BLOCK_SIZE));
+
+    // Try the section we already have loaded first.
+    vector<gati_t> blocks;
+    if (have_section) {
+      blocks = find_free_blocks(gat, num_blocks);
+    }
+    if (blocks.empty()) {
+      flush();
+      have_section = false;
+      auto try_section = [&](size_t s) {
+        gat = load_gat(*msgfile, s);
+        blocks = find_free_blocks(gat, num_blocks);
+        hints[s] = count_free_blocks(gat);
+        if (!blocks.empty()) {
+          section = s;
+          have_section = true;
+        }
+      };
+
+      // 1st pass, only look at sections that the hints claim have room.
+      for (size_t s = 0; s < num_existing_sections && !have_section; s++) {
+        if (hints[s] == UNKNOWN_FREE_BLOCKS || hints[s] >= num_blocks) {
+          try_section(s);
+        }
       }
-      ++i4;
-    }
-    if (size_int(gati) >= nNumBlocksRequired) {
-      gati.push_back(-1);
-      for (int i = 0; i < nNumBlocksRequired; i++) {
-        msgfile->Seek(MSG_STARTING(section) + MSG_BLOCK_SIZE * static_cast<long>(gati[i]), File::Whence::begin);
-        msgfile->Write((&text[i * MSG_BLOCK_SIZE]), MSG_BLOCK_SIZE);
-        gat[gati[i]] = gati[i + 1];
+      // 2nd pass, another node may have freed blocks in a section we think is full.
+      for (size_t s = 0; s < num_existing_sections && !have_section; s++) {
+        if (hints[s] != UNKNOWN_FREE_BLOCKS && hints[s] < num_blocks) {
+          try_section(s);
+        }
       }
-      save_gat(*msgfile, section, gat);
-      break;
+      // Finally, start a new section.
+      for (size_t s = num_existing_sections; s < MAX_GAT_SECTIONS && !have_section; s++) {
+        try_section(s);
+      }
+      if (!have_section) {
+        LOG(ERROR) << "No room for " << num_blocks << " blocks in message file: " << filename_;
+        // Give back the text saved so far so the blocks aren't leaked.
+        // remove_links needs both the file and hints, so release them first.
+        lock.unlock();
+        msgfile.reset();
+        msgs.resize(m);
+        if (!msgs.empty()) {
+          remove_links(msgs);
+        }
+        msgs.assign(texts.size(), messagerec{2, 0xffffffff});
+        return false;
+      }
+      num_existing_sections = std::max(num_existing_sections, section + 1);
+    }
+
+    // Link the blocks together, the last one points to 0xffff (end of chain).
+    for (size_t i = 0; i < blocks.size(); i++) {
+      gat[blocks[i]] = (i + 1 < blocks.size()) ? blocks[i + 1] : static_cast<gati_t>(-1);
+    }
+    hints[section] -= num_blocks;
+
+    // Queue each run of contiguous blocks as a single write. The text is
+    // padded with NULs to fill the last block.
+    string padded(text);
+    padded.resize(blocks.size() * MSG_BLOCK_SIZE, '\0');
+    for (size_t i = 0; i < blocks.size();) {
+      size_t run = 1;
+      while (i + run < blocks.size() && blocks[i + run] == blocks[i] + run) {
+        ++run;
+      }
+      write_blocks(MSG_STARTING(section) + MSG_BLOCK_SIZE * static_cast<long>(blocks[i]),
+                   &padded[i * MSG_BLOCK_SIZE], run * MSG_BLOCK_SIZE);
+      i += run;
     }
+    msgs[m].stored_as =
+        static_cast<uint32_t>(blocks[0]) + static_cast<uint32_t>(section) * GAT_NUMBER_ELEMENTS;
   }
-  msg->stored_as = static_cast<uint32_t>(gati[0]) + static_cast<uint32_t>(section) * GAT_NUMBER_ELEMENTS;
+  flush();
   return true;
 }
 
@@ -43,9 +43,22 @@ public:
 
   std::vector<gati_t> load_gat(wwiv::core::File& file, size_t section);
   void save_gat(wwiv::core::File& f, size_t section, const std::vector<gati_t>& gat);
-  bool readfile(const messagerec* msg, std::string* out);
+  /**
+   * Reads the text of msg into out. When max_blocks is given only the first
+   * max_blocks blocks of the text are read.
+   */
+  bool readfile(const messagerec* msg, std::string* out,
+                size_t max_blocks = GAT_NUMBER_ELEMENTS);
   bool savefile(const std::string& text, messagerec* message_record);
+  /**
+   * Saves all of texts, setting msgs to where each one is stored. The
+   * message file is opened once and each GAT section is saved once.
+   * On failure none of the texts are saved.
+   */
+  bool savefiles(const std::vector<std::string>& texts, std::vector<messagerec>& msgs);
   bool remove_link(messagerec& msg);
+  /** Removes the text of all of msgs, loading and saving each GAT section once. */
+  bool remove_links(const std::vector<messagerec>& msgs);
 
 private:
   std::unique_ptr<wwiv::core::File> OpenMessageFile();
@@ -17,11 +17,15 @@
 /**************************************************************************/
 #include "sdk/net/packets.h"
 
+#include <algorithm>
+#include <cstring>
+#include <limits>
 #include <string>
 
 #include "core/datetime.h"
 #include "core/file.h"
 #include "core/log.h"
+#include "core/metrics.h"
 #include "core/strings.h"
 #include "core/version.h"
 #include "networkb/net_util.h"
@@ -110,14 +114,145 @@ ReadPacketResponse read_packet(File& f, Packet& packet, bool process_de) {
   return ReadPacketResponse::OK;
 }
 
-bool write_wwivnet_packet(const string& filename, const net_networks_rec& net, const Packet& p) {
+uint16_t PacketView::list_at(std::size_t i) const noexcept {
+  uint16_t node = 0;
+  memcpy(&node, list_ + i * sizeof(uint16_t), sizeof(uint16_t));
+  return node;
+}
+
+std::vector<uint16_t> PacketView::list() const {
+  std::vector<uint16_t> result(list_size_);
+  if (list_size_ > 0) {
+    memcpy(&result[0], list_, list_size_ * sizeof(uint16_t));
+  }
+  return result;
+}
+
+Packet PacketView::ToPacket() const {
+  Packet p;
+  p.nh = nh;
+  p.list = list();
+  p.text_.reserve(text_.size() + splice_.size());
+  p.text_.append(text_.data(), splice_pos_);
+  p.text_.append(splice_);
+  p.text_.append(text_.data() + splice_pos_, text_.size() - splice_pos_);
+  return p;
+}
+
+PacketStream::PacketStream(const std::string& path, bool process_de)
+    : file_(path), in_memory_(false), process_de_(process_de) {}
+
+PacketStream::PacketStream(std::string_view data, bool process_de)
+    : file_(""), data_(data), in_memory_(true), process_de_(process_de) {}
+
+bool PacketStream::Open() {
+  pos_ = 0;
+  if (in_memory_) {
+    return true;
+  }
+  if (file_.Open()) {
+    return true;
+  }
+  // Empty files can't be mapped, but are fine.
+  return File::Exists(file_.full_pathname());
+}
+
+void PacketStream::Close() {
+  file_.Close();
+  pos_ = 0;
+}
+
+ReadPacketResponse PacketStream::Next(PacketView& view) {
+  const auto* data = in_memory_ ? data_.data() : reinterpret_cast<const char*>(file_.data());
+  const auto size = in_memory_ ? data_.size() : file_.size();
+  if (pos_ >= size) {
+    // at the end of the packet.
+    return ReadPacketResponse::END_OF_FILE;
+  }
+  if (size - pos_ < sizeof(net_header_rec)) {
+    LOG(INFO) << "error reading header, got short read of size: " << size - pos_
+              << "; expected: " << sizeof(net_header_rec);
+    pos_ = size;
+    return ReadPacketResponse::ERROR;
+  }
+  memcpy(&view.nh, data + pos_, sizeof(net_header_rec));
+  pos_ += sizeof(net_header_rec);
+
+  if (view.nh.method > 0) {
+    LOG(INFO) << "compression: de" << view.nh.method;
+  }
+
+  // Like read_packet, a short list or text is truncated to what's there.
+  view.list_ = data + pos_;
+  view.list_size_ = std::min<std::size_t>(view.nh.list_len, (size - pos_) / sizeof(uint16_t));
+  pos_ += view.list_size_ * sizeof(uint16_t);
+
+  if (view.nh.length > static_cast<uint32_t>(std::numeric_limits<int32_t>::max())) {
+    LOG(INFO) << "error reading header, got length too big (underflow?): " << view.nh.length;
+    pos_ = size;
+    return ReadPacketResponse::ERROR;
+  }
+  if (view.nh.method > 0 && process_de_ &&
+      view.nh.length > 146 /* Make sure we have enough for a header */) {
+    // HACK - this should do this in a shim DE
+    // 146 is the sizeof EN/DE header.
+    view.nh.length -= 146;
+    pos_ = std::min<std::size_t>(pos_ + 146, size);
+  }
+  const auto length = std::min<std::size_t>(view.nh.length, size - pos_);
+  view.text_ = std::string_view(data + pos_, length);
+  pos_ += length;
+  return ReadPacketResponse::OK;
+}
+
+// Checks the packet and appends the bytes written to a packet file for it
+// to out. list points to list_size (unaligned) uint16_t destinations.
+// If splice is not empty, it is written within text at splice_pos.
+static bool append_wwivnet_packet(const string& filename, const net_networks_rec& net,
+                                  const net_header_rec& nh, const char* list,
+                                  std::size_t list_size, std::string_view text,
+                                  std::string_view splice, std::size_t splice_pos, string& out) {
   VLOG(2) << "write_wwivnet_packet: " << filename;
-  LOG(INFO) << "write_wwivnet_packet: Writing type " << p.nh.main_type << "/" << p.nh.minor_type
+  LOG(INFO) << "write_wwivnet_packet: Writing type " << nh.main_type << "/" << nh.minor_type
             << " message to packet: " << filename;
-  if (p.nh.length != p.text().size()) {
+  if (nh.list_len > list_size) {
+    LOG(ERROR) << "Error while writing packet: " << net.dir << filename << " list is too short.";
+    return false;
+  }
+  if (nh.length != text.size() + splice.size()) {
     LOG(ERROR) << "Error while writing packet: " << net.dir << filename;
-    LOG(ERROR) << "Mismatched text and p.nh.length.  text =" << p.text().size()
-               << " nh.length = " << p.nh.length;
+    LOG(ERROR) << "Mismatched text and p.nh.length.  text =" << text.size() + splice.size()
+               << " nh.length = " << nh.length;
+    return false;
+  }
+  VLOG(2) << "p.nh.list_len: " << nh.list_len;
+  out.append(reinterpret_cast<const char*>(&nh), sizeof(net_header_rec));
+  if (nh.list_len) {
+    out.append(list, sizeof(uint16_t) * nh.list_len);
+  }
+  if (splice.empty()) {
+    out.append(text.data(), text.size());
+    return true;
+  }
+  out.append(text.data(), splice_pos);
+  out.append(splice.data(), splice.size());
+  out.append(text.data() + splice_pos, text.size() - splice_pos);
+  return true;
+}
+
+static bool append_wwivnet_packet(const string& filename, const net_networks_rec& net,
+                                  const Packet& p, string& out) {
+  if (p.nh.list_len != p.list.size()) {
+    LOG(WARNING) << "p.nh.list_len [" << p.nh.list_len << "] != p.list.size() [" << p.list.size()
+                 << "]";
+  }
+  return append_wwivnet_packet(filename, net, p.nh, reinterpret_cast<const char*>(p.list.data()),
+                               p.list.size(), p.text(), {}, 0, out);
+}
+
+bool write_wwivnet_packet(const string& filename, const net_networks_rec& net, const Packet& p) {
+  string data;
+  if (!append_wwivnet_packet(filename, net, p, data)) {
     return false;
   }
   File file(FilePath(net.dir, filename));
@@ -126,26 +261,157 @@ bool write_wwivnet_packet(const string& filename, const net_networks_rec& net, c
     return false;
   }
   file.Seek(0L, File::Whence::end);
-  auto num = file.Write(&p.nh, sizeof(net_header_rec));
-  if (num != sizeof(net_header_rec)) {
-    // Let's fail now since we didn't write this right.
+  auto num = file.Write(data);
+  if (num != static_cast<ssize_t>(data.size())) {
     LOG(ERROR) << "Error while writing packet: " << net.dir << filename << " num written (" << num
-               << ") != net_header_rec size.";
+               << ") != packet size (" << data.size() << ").";
     return false;
   }
-  if (p.nh.list_len != p.list.size()) {
-    LOG(WARNING) << "p.nh.list_len [" << p.nh.list_len << "] != p.list.size() [" << p.list.size()
-                 << "]";
+  return true;
+}
+
+bool PacketBatch::Write(const string& filename, const Packet& packet) {
+  if (!append_wwivnet_packet(filename, net_, packet, files_[filename])) {
+    return false;
   }
-  VLOG(2) << "p.nh.list_len: " << p.nh.list_len;
-  if (p.nh.list_len) {
-    file.Write(&p.list[0], sizeof(uint16_t) * (p.nh.list_len));
+  packets_++;
+  return true;
+}
+
+bool PacketBatch::Write(const string& filename, const PacketView& packet) {
+  if (!append_wwivnet_packet(filename, net_, packet.nh, packet.list_, packet.list_size_,
+                             packet.text_, packet.splice_, packet.splice_pos_, files_[filename])) {
+    return false;
+  }
+  packets_++;
+  return true;
+}
+
+std::string PacketBatch::Take(const string& filename) {
+  auto it = files_.find(filename);
+  if (it == files_.end()) {
+    return {};
+  }
+  auto data = std::move(it->second);
+  files_.erase(it);
+  return data;
+}
+
+std::future<bool> PacketQueue::Push(const string& name, std::string packets) {
+  std::unique_lock<std::mutex> lock(mu_);
+  cv_.wait(lock, [this] { return items_.size() < max_files_; });
+  items_.push_back(Item{name, std::move(packets), {}});
+  auto done = items_.back().done.get_future();
+  cv_.notify_all();
+  return done;
+}
+
+bool PacketQueue::Pop(Item& item) {
+  std::unique_lock<std::mutex> lock(mu_);
+  cv_.wait(lock, [this] { return closed_ || !items_.empty(); });
+  if (items_.empty()) {
+    return false;
+  }
+  item = std::move(items_.front());
+  items_.pop_front();
+  cv_.notify_all();
+  return true;
+}
+
+void PacketQueue::Close() {
+  std::lock_guard<std::mutex> lock(mu_);
+  closed_ = true;
+  cv_.notify_all();
+}
+
+PacketWriterPool::PacketWriterPool(const net_networks_rec& net, std::size_t flush_bytes)
+    : net_(net), flush_bytes_(flush_bytes) {}
+
+PacketWriterPool::~PacketWriterPool() { Close(); }
+
+// Accounts for the bytes appended to w, flushing if there are too many.
+bool PacketWriterPool::Append(Writer& w, std::size_t size_before) {
+  bytes_pending_ += w.buffer.size() - size_before;
+  if (bytes_pending_ > flush_bytes_) {
+    return Flush();
   }
-  file.Write(p.text());
-  file.Close();
   return true;
 }
 
+bool PacketWriterPool::Write(const string& filename, const Packet& packet) {
+  auto& w = writers_[filename];
+  const auto size = w.buffer.size();
+  if (!append_wwivnet_packet(filename, net_, packet, w.buffer)) {
+    return false;
+  }
+  return Append(w, size);
+}
+
+bool PacketWriterPool::Write(const string& filename, const PacketView& packet) {
+  auto& w = writers_[filename];
+  const auto size = w.buffer.size();
+  if (!append_wwivnet_packet(filename, net_, packet.nh, packet.list_, packet.list_size_,
+                             packet.text_, packet.splice_, packet.splice_pos_, w.buffer)) {
+    return false;
+  }
+  return Append(w, size);
+}
+
+bool PacketWriterPool::Write(const PacketBatch& batch) {
+  auto result = true;
+  for (const auto& f : batch.files()) {
+    auto& w = writers_[f.first];
+    const auto size = w.buffer.size();
+    w.buffer.append(f.second);
+    if (!Append(w, size)) {
+      result = false;
+    }
+  }
+  return result;
+}
+
+bool PacketWriterPool::Flush(const string& filename, Writer& w) {
+  if (w.buffer.empty()) {
+    return true;
+  }
+  const auto size = w.buffer.size();
+  bytes_pending_ -= size;
+  // The file is only held open while writing to it, networkb may send and
+  // remove it between flushes.
+  File file(FilePath(net_.dir, filename));
+  if (!file.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile)) {
+    LOG(ERROR) << "Error while writing packet: " << net_.dir << filename
+               << "Unable to open file.";
+    w.buffer.clear();
+    return false;
+  }
+  file.Seek(0L, File::Whence::end);
+  auto num = file.Write(w.buffer);
+  auto ok = num == static_cast<ssize_t>(size);
+  if (!ok) {
+    LOG(ERROR) << "Error while writing packet: " << file.full_pathname() << " num written ("
+               << num << ") != size (" << size << ").";
+  }
+  w.buffer.clear();
+  return file.Sync() && ok;
+}
+
+bool PacketWriterPool::Flush() {
+  auto result = true;
+  for (auto& w : writers_) {
+    if (!Flush(w.first, w.second)) {
+      result = false;
+    }
+  }
+  return result;
+}
+
+bool PacketWriterPool::Close() {
+  auto result = Flush();
+  writers_.clear();
+  return result;
+}
+
 static string NetInfoFileName(uint16_t type) {
   switch (type) {
   case net_info_bbslist:
@@ -238,6 +504,10 @@ static bool need_to_update_routing(uint16_t main_type) {
   return false;
 }
 
+bool PacketView::needs_routing_update() const noexcept {
+  return need_to_update_routing(nh.main_type);
+}
+
 static int number_of_header_lines(uint16_t main_type) {
   // either 3 or 4.
   switch (main_type) {
@@ -267,34 +537,66 @@ Packet::Packet(const net_header_rec& h, const std::vector<uint16_t>& l, const st
 Packet::Packet(const net_header_rec& h, const std::vector<uint16_t>& l, const ParsedPacketText& t)
     : Packet(h, l, ParsedPacketText::ToPacketText(t)) {}
 
-bool Packet::UpdateRouting(const net_networks_rec& net) {
-  if (!need_to_update_routing(nh.main_type)) {
-    return false;
-  }
-
+// The ^D0R routing line added by UpdateRouting.
+static std::string routing_information(const net_networks_rec& net) {
   std::ostringstream ss;
   ss << "\004"
      << "0R " << wwiv_net_version << " - " << date() << " " << times() << " " << net.name << " ->"
      << net.sysnum << "\r\n";
+  return ss.str();
+}
 
-  const auto routing_information = ss.str();
+// Returns the offset just past the header lines (either 3 or 4 lines
+// depending on the packet type) in text, which is where the routing line
+// goes. This walks the lines the same way as get_message_field, but only
+// looks at the header.
+static std::size_t routing_line_offset(uint16_t main_type, std::string_view text) {
+  static constexpr CharClass kStop{'\0', '\r', '\n'};
+  static constexpr std::size_t kMaxLine = 80;
+  const auto lines = number_of_header_lines(main_type);
+  std::size_t pos = 0;
+  for (auto i = 0; i < lines && pos < text.size(); i++) {
+    // Skip over this line
+    std::size_t count = 0;
+    while (pos < text.size() && !kStop.contains(text[pos]) && ++count < kMaxLine) {
+      pos++;
+    }
+    while (pos < text.size() && kStop.contains(text[pos])) {
+      pos++;
+    }
+  }
+  return pos;
+}
 
-  if (nh.length + routing_information.size() >= (32 * 1024)) {
+bool Packet::UpdateRouting(const net_networks_rec& net) {
+  if (!need_to_update_routing(nh.main_type)) {
+    return false;
+  }
+
+  const auto routing_info = routing_information(net);
+  if (nh.length + routing_info.size() >= (32 * 1024)) {
     LOG(INFO) << "Can't updating routing information, already have 32k of message.";
     return false;
   }
-  nh.length += routing_information.size();
+  nh.length += routing_info.size();
+  text_.insert(routing_line_offset(nh.main_type, text_), routing_info);
+  return true;
+}
 
-  // Need to skip over either 3 or 4 lines 1st depending on the packet type.
-  auto lines = number_of_header_lines(nh.main_type);
-  auto iter = text_.begin();
-  for (auto i = 0; i < lines; i++) {
-    // Skip over this line
-    get_message_field(text_, iter, {'\0', '\r', '\n'}, 80);
+bool PacketView::UpdateRouting(const net_networks_rec& net) {
+  if (!needs_routing_update()) {
+    return false;
   }
 
-  auto pos = std::distance(text_.begin(), iter);
-  text_.insert(pos, routing_information);
+  auto routing_info = routing_information(net);
+  if (nh.length + routing_info.size() >= (32 * 1024)) {
+    LOG(INFO) << "Can't updating routing information, already have 32k of message.";
+    return false;
+  }
+  nh.length += routing_info.size();
+  // Like Packet::UpdateRouting, newer routing lines go before older ones.
+  splice_pos_ = routing_line_offset(nh.main_type, text_);
+  splice_.insert(0, routing_info);
   return true;
 }
 
@@ -310,16 +612,16 @@ void Packet::set_text(std::string&& text) {
 
 uint16_t get_forsys(const wwiv::sdk::BbsListNet& b, uint16_t node) {
   VLOG(2) << "get_forsys (forward to systen number) for node: " << node;
-  auto n = b.node_config_for(node);
   if (node == 0) {
     return 0;
   }
-  if (n == nullptr || n->forsys == WWIVNET_NO_NODE) {
+  const auto forsys = b.forsys_for(node);
+  if (forsys == WWIVNET_NO_NODE) {
     VLOG(2) << "get_forsys: no route to node: " << node;
     return WWIVNET_NO_NODE;
   }
-  VLOG(2) << "get_forsys: route to node: " << node << "; is through node: " << n->forsys;
-  return n->forsys;
+  VLOG(2) << "get_forsys: route to node: " << node << "; is through node: " << forsys;
+  return forsys;
 }
 
 // static
@@ -595,26 +897,68 @@ bool send_post_to_subscribers(const std::vector<net_networks_rec>& nets, int ori
                               const std::string& original_subtype, const subboard_t& sub,
                               Packet& template_packet, std::set<uint16_t> subscribers_to_skip,
                               const subscribers_send_to_t& send_to) {
+  SubscriberFanout fanout(nets, '2');
+  auto result = fanout.Send(original_net_num, original_subtype, sub, template_packet,
+                            subscribers_to_skip, send_to);
+  return fanout.Flush() && result;
+}
+
+// Key used for the one pending file per network in the batches.
+static const char kPendingFile[] = "pending";
+
+SubscriberFanout::SubscriberFanout(const std::vector<net_networks_rec>& nets, char network_app_id)
+    : nets_(nets), network_app_id_(network_app_id) {}
+
+SubscriberFanout::~SubscriberFanout() { Flush(); }
+
+const std::vector<uint16_t>* SubscriberFanout::subscribers(const net_networks_rec& net,
+                                                          const std::string& subtype) {
+  const auto path = FilePath(net.dir, StrCat("n", subtype, ".net"));
+  auto it = subscribers_.find(path);
+  if (it == subscribers_.end()) {
+    std::set<uint16_t> s;
+    auto read = ReadSubcriberFile(path, s);
+    it = subscribers_.emplace(path, std::make_pair(read, std::vector<uint16_t>(s.begin(), s.end())))
+             .first;
+  }
+  return it->second.first ? &it->second.second : nullptr;
+}
+
+bool SubscriberFanout::Queue(int net_num, const net_header_rec& h,
+                             const std::vector<uint16_t>& list, const std::string& text) {
+  auto it = batches_.find(net_num);
+  if (it == batches_.end()) {
+    it = batches_.emplace(net_num, PacketBatch(nets_[net_num])).first;
+  }
+  Packet p(h, list, text);
+  return it->second.Write(kPendingFile, p);
+}
+
+bool SubscriberFanout::Send(int original_net_num, const std::string& original_subtype,
+                            const subboard_t& sub, const Packet& template_packet,
+                            const std::set<uint16_t>& subscribers_to_skip,
+                            subscribers_send_to_t send_to) {
   VLOG(1) << "DEBUG: send_post_to_subscribers; original subtype: " << original_subtype;
 
+  auto result = true;
   for (const auto& subnet : sub.nets) {
     auto h = template_packet.nh;
     VLOG(1) << "DEBUG: Current network subtype: " << subnet.stype;
-    VLOG(1) << "DEBUG: Current network is: " << nets[subnet.net_num].name;
+    VLOG(1) << "DEBUG: Current network is: " << nets_[subnet.net_num].name;
     // if subnet.host == 0, we are the host.
     // if subnet.net_num != context.network_number then we are
     // gating the sub to another network.
     bool are_we_hosting = subnet.host == 0;
     bool are_we_gating = subnet.net_num != original_net_num;
-    const auto& current_net = nets[subnet.net_num];
+    const auto& current_net = nets_[subnet.net_num];
     VLOG(1) << "DEBUG: are_we_hosting: " << std::boolalpha << are_we_hosting;
     VLOG(1) << "DEBUG: are_we_gating:  " << std::boolalpha << are_we_gating;
 
     if (!are_we_hosting && !are_we_gating &&
         send_to == subscribers_send_to_t::hosted_and_gated_only) {
       // Nothing to do here, so move on to the next subnet in the list
-      continue;
       VLOG(2) << "!hosting and !gating on: " << current_net.name;
+      continue;
     }
     if (are_we_gating) {
       // update fromsys
@@ -637,49 +981,72 @@ bool send_post_to_subscribers(const std::vector<net_networks_rec>& nets, int ori
       h.tosys = FTN_FAKE_OUTBOUND_NODE;
       VLOG(1) << "current network is FTN";
       h.list_len = 0;
-      write_wwivnet_packet_or_log(current_net, h, {}, text);
+      result &= Queue(subnet.net_num, h, {}, text);
     } else if (current_net.type == network_type_t::wwivnet) {
       if (subnet.host == 0) {
         // We are the host.
-        std::set<uint16_t> subscribers;
-        bool subscribers_read =
-            ReadSubcriberFile(current_net.dir, StrCat("n", subnet.stype, ".net"), subscribers);
-        if (subscribers_read) {
-          // Remove the original sender from the set of systems
-          // that we will resend this to.
-          subscribers.erase(template_packet.nh.fromsys);
-          for (const auto& skip : subscribers_to_skip) {
-            // Skip the subscribers to skip too.
-            subscribers.erase(skip);
-          }
-          VLOG(1) << "Removing subscriber (sender): " << template_packet.nh.fromsys;
-          VLOG(1) << "Read subscribers #: " << subscribers.size();
-          VLOG(1) << "Creating wwivnet packet to: ";
-          for (const auto x : subscribers) {
-            VLOG(1) << "        @" << x;
-          }
-
-          if (subscribers.empty()) {
-            VLOG(1) << "No subscribers left, skipping sending this packet";
-          }
-          h.list_len = static_cast<uint16_t>(subscribers.size());
-          h.tosys = 0;
-          write_wwivnet_packet_or_log(
-              current_net, h, std::vector<uint16_t>(subscribers.begin(), subscribers.end()), text);
-        } else {
+        const auto* all = subscribers(current_net, subnet.stype);
+        if (all == nullptr) {
           LOG(ERROR) << "Unable to read subscribers for " << current_net.dir << " " << subnet.stype;
+          continue;
+        }
+        // Remove the original sender and the subscribers to skip from
+        // the systems that we will resend this to.
+        VLOG(1) << "Removing subscriber (sender): " << template_packet.nh.fromsys;
+        std::vector<uint16_t> list;
+        list.reserve(all->size());
+        for (const auto s : *all) {
+          if (s != template_packet.nh.fromsys && subscribers_to_skip.count(s) == 0) {
+            list.push_back(s);
+          }
         }
+        VLOG(1) << "Read subscribers #: " << all->size() << "; sending to: " << list.size();
+        if (list.empty()) {
+          VLOG(1) << "No subscribers left, skipping sending this packet";
+          continue;
+        }
+        h.list_len = static_cast<uint16_t>(list.size());
+        h.tosys = 0;
+        result &= Queue(subnet.net_num, h, list, text);
       } else {
         // We are not the host.  Send message to host.
         h.tosys = subnet.host;
         h.list_len = 0;
-        write_wwivnet_packet_or_log(current_net, h, {}, text);
+        result &= Queue(subnet.net_num, h, {}, text);
       }
     }
   }
-  LOG(INFO) << "DEBUG: send_post_to_subscribers"
-            << "exiting with true";
-  return true;
+  return result;
+}
+
+bool SubscriberFanout::Flush() {
+  const auto stage = StrCat("network", network_app_id_);
+  auto& packets_written = Metrics::Global().counter(StrCat(stage, ".packets_written"));
+  auto& bytes_written = Metrics::Global().counter(StrCat(stage, ".bytes_written"));
+  auto result = true;
+  for (const auto& b : batches_) {
+    const auto& net = nets_[b.first];
+    for (const auto& f : b.second.files()) {
+      const auto fn = create_pend(net.dir, false, network_app_id_);
+      File file(FilePath(net.dir, fn));
+      if (fn.empty() || !file.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile)) {
+        LOG(ERROR) << "Error writing packets to: " << net.dir << " " << fn;
+        result = false;
+        continue;
+      }
+      file.Seek(0L, File::Whence::end);
+      if (file.Write(f.second) != static_cast<ssize_t>(f.second.size())) {
+        LOG(ERROR) << "Error writing packets to: " << net.dir << " " << fn;
+        result = false;
+        continue;
+      }
+      packets_written.Add(b.second.packets());
+      bytes_written.Add(f.second.size());
+      VLOG(1) << "Wrote " << f.second.size() << " bytes of packets to: " << fn;
+    }
+  }
+  batches_.clear();
+  return result;
 }
 
 } // namespace net
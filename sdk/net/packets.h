@@ -18,14 +18,23 @@
 #ifndef __INCLUDED_SDK_NET_PACKETS_H__
 #define __INCLUDED_SDK_NET_PACKETS_H__
 
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
 #include <functional>
+#include <future>
+#include <initializer_list>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "core/command_line.h"
 #include "core/file.h"
+#include "core/mmap_file.h"
 #include "sdk/bbslist.h"
 #include "sdk/config.h"
 #include "sdk/msgapi/message.h"
@@ -125,13 +134,36 @@ private:
   std::string text_;
 };
 
+/**
+ * A set of characters with a constant time lookup, used for the stop
+ * characters passed to get_message_field.
+ */
+class CharClass final {
+public:
+  constexpr CharClass(std::initializer_list<char> chars) noexcept : chars_{} {
+    for (auto c : chars) {
+      chars_[static_cast<uint8_t>(c)] = true;
+    }
+  }
+  CharClass(const std::set<char>& chars) noexcept : chars_{} {
+    for (auto c : chars) {
+      chars_[static_cast<uint8_t>(c)] = true;
+    }
+  }
+
+  constexpr bool contains(char c) const noexcept { return chars_[static_cast<uint8_t>(c)]; }
+
+private:
+  bool chars_[256];
+};
+
 /**
  * Gets the next message field from a packet text c with iterator iter.
  * The next message field will be the next set of characters that do not include
  * anything in the set of stop characters (stop) and less than a total of max.
  */
 template <typename C, typename I>
-static std::string get_message_field(const C& c, I& iter, std::set<char> stop, std::size_t max) {
+static std::string get_message_field(const C& c, I& iter, const CharClass& stop, std::size_t max) {
   // No need to continue if we're already at the end.
   if (iter == c.end()) {
     return "";
@@ -139,13 +171,13 @@ static std::string get_message_field(const C& c, I& iter, std::set<char> stop, s
 
   const auto begin = iter;
   std::size_t count = 0;
-  while (iter != std::end(c) && stop.find(*iter) == std::end(stop) && ++count < max) {
+  while (iter != std::end(c) && !stop.contains(*iter) && ++count < max) {
     iter++;
   }
   std::string result(begin, iter);
 
   // Stop over stop chars
-  while (iter != std::end(c) && stop.find(*iter) != std::end(stop)) {
+  while (iter != std::end(c) && stop.contains(*iter)) {
     iter++;
   }
 
@@ -162,9 +194,194 @@ uint16_t get_forsys(const wwiv::sdk::BbsListNet& b, uint16_t node);
 
 ReadPacketResponse read_packet(wwiv::core::File& file, Packet& packet, bool process_de);
 
+/**
+ * A packet read from a PacketStream. The header is copied, but the list and
+ * text point into the stream's mapping of the file, so a PacketView is only
+ * valid until the PacketStream is closed. Use ToPacket to get a Packet that
+ * can be changed (i.e. by UpdateRouting) or kept.
+ */
+class PacketView final {
+public:
+  net_header_rec nh{};
+
+  std::size_t list_size() const noexcept { return list_size_; }
+  uint16_t list_at(std::size_t i) const noexcept;
+  /** Copies the list of destinations. */
+  std::vector<uint16_t> list() const;
+  /**
+   * The text as it is in the file. This does not include the routing line
+   * added by UpdateRouting, use ToPacket to get the whole text.
+   */
+  std::string_view text() const noexcept { return text_; }
+
+  /** True if Packet::UpdateRouting would add routing information. */
+  bool needs_routing_update() const noexcept;
+  /**
+   * Like Packet::UpdateRouting, but the routing line is kept apart from the
+   * text and only spliced into it when the packet is written or copied, so
+   * the text is never moved.
+   */
+  bool UpdateRouting(const net_networks_rec& net);
+  Packet ToPacket() const;
+
+private:
+  friend class PacketStream;
+  friend class PacketBatch;
+  friend class PacketWriterPool;
+  const char* list_{nullptr};
+  std::size_t list_size_{0};
+  std::string_view text_;
+  // Routing line to insert at splice_pos_ within text_.
+  std::string splice_;
+  std::size_t splice_pos_{0};
+};
+
+/**
+ * Reads the packets in a packet file (like p*.net or local.net) from a
+ * memory mapping of the file, without any copying or allocations per
+ * packet. Use in place of read_packet when the packets are only looked at
+ * or written elsewhere.
+ *
+ * Example:
+ *   PacketStream stream(FilePath(net.dir, LOCAL_NET), false);
+ *   if (!stream.Open()) { ... }
+ *   PacketView v;
+ *   while (stream.Next(v) == ReadPacketResponse::OK) { ... }
+ */
+class PacketStream final {
+public:
+  PacketStream(const std::string& path, bool process_de);
+  /**
+   * Reads the packets in data, which is the contents of a packet file
+   * already in memory (i.e. from a PacketQueue). data must outlive the
+   * stream and any views read from it.
+   */
+  PacketStream(std::string_view data, bool process_de);
+
+  /** Maps the file. Returns false if it does not exist. */
+  bool Open();
+  void Close();
+  /** Reads the next packet into view, see read_packet. */
+  ReadPacketResponse Next(PacketView& view);
+
+private:
+  wwiv::core::MemoryMappedFile file_;
+  // Only used when reading from memory.
+  const std::string_view data_;
+  const bool in_memory_;
+  const bool process_de_;
+  std::size_t pos_{0};
+};
+
 bool write_wwivnet_packet(const std::string& filename, const net_networks_rec& net,
                           const Packet& packet);
 
+/**
+ * Packets for many packet files queued in memory, in the order they were
+ * written. Lets packets be routed on worker threads and then appended to
+ * the packet files in a fixed order with PacketWriterPool::Write.
+ */
+class PacketBatch final {
+public:
+  explicit PacketBatch(const net_networks_rec& net) : net_(net) {}
+
+  bool Write(const std::string& filename, const Packet& packet);
+  bool Write(const std::string& filename, const PacketView& packet);
+
+  /** The bytes to append to each packet file. */
+  const std::map<std::string, std::string>& files() const noexcept { return files_; }
+  /** Removes the packets for filename from the batch and returns them. */
+  std::string Take(const std::string& filename);
+  /** The number of packets written to the batch. */
+  int packets() const noexcept { return packets_; }
+
+private:
+  net_networks_rec net_;
+  std::map<std::string, std::string> files_;
+  int packets_{0};
+};
+
+/**
+ * Hands the contents of packet files from one stage of the network
+ * processing to the next in memory, like the local.net packets network1
+ * routes to network2 when networkc runs both of them. Push blocks while
+ * max_files are waiting so the reader doesn't fall too far behind.
+ */
+class PacketQueue final {
+public:
+  struct Item {
+    // Name of the file the packets came from, for logging.
+    std::string name;
+    std::string packets;
+    std::promise<bool> done;
+  };
+
+  explicit PacketQueue(std::size_t max_files = 16) : max_files_(max_files) {}
+  PacketQueue(const PacketQueue&) = delete;
+  PacketQueue& operator=(const PacketQueue&) = delete;
+
+  /**
+   * Queues packets (the contents of a packet file). The future is set by
+   * the reader once it's done with them.
+   */
+  std::future<bool> Push(const std::string& name, std::string packets);
+  /** Waits for the next item. Returns false once closed and empty. */
+  bool Pop(Item& item);
+  /** No more items will be pushed. */
+  void Close();
+
+private:
+  const std::size_t max_files_;
+  std::mutex mu_;
+  std::condition_variable cv_;
+  std::deque<Item> items_;
+  bool closed_{false};
+};
+
+/**
+ * Appends packets to many packet files in net.dir (like the s<node>.net
+ * files network1 routes to), as write_wwivnet_packet does.
+ *
+ * Packets are buffered in memory and written with one write per file by
+ * Flush, which opens each file, appends to it, fsyncs and closes it again.
+ * Flush happens automatically once more than flush_bytes are waiting to be
+ * written.
+ */
+class PacketWriterPool final {
+public:
+  static constexpr std::size_t DEFAULT_FLUSH_BYTES = 1 << 20;
+
+  PacketWriterPool(const net_networks_rec& net, std::size_t flush_bytes = DEFAULT_FLUSH_BYTES);
+  PacketWriterPool(const PacketWriterPool&) = delete;
+  PacketWriterPool& operator=(const PacketWriterPool&) = delete;
+  /** Flushes all of the packet files, see Close. */
+  ~PacketWriterPool();
+
+  /** Queues packet to be appended to filename. */
+  bool Write(const std::string& filename, const Packet& packet);
+  bool Write(const std::string& filename, const PacketView& packet);
+  /** Queues all of the packets in batch. */
+  bool Write(const PacketBatch& batch);
+  /** Writes all of the queued packets and syncs the files to disk. */
+  bool Flush();
+  /** Flushes all of the packet files and forgets them. */
+  bool Close();
+
+  std::size_t bytes_pending() const noexcept { return bytes_pending_; }
+
+private:
+  struct Writer {
+    std::string buffer;
+  };
+  bool Append(Writer& writer, std::size_t size_before);
+  bool Flush(const std::string& filename, Writer& writer);
+
+  const net_networks_rec net_;
+  const std::size_t flush_bytes_;
+  std::size_t bytes_pending_{0};
+  std::map<std::string, Writer> writers_;
+};
+
 bool send_local_email(const net_networks_rec& network, net_header_rec& nh, const std::string& text,
                       const std::string& byname, const std::string& title);
 
@@ -206,6 +423,47 @@ bool send_post_to_subscribers(const std::vector<net_networks_rec>& nets, int ori
                               Packet& template_packet, std::set<uint16_t> subscribers_to_skip,
                               const subscribers_send_to_t& send_to);
 
+/**
+ * Sends posts on to the other subscribers of their subs like
+ * send_post_to_subscribers, but for all of the posts in a run.
+ *
+ * Each subscriber list (n<subtype>.net) is only read once and kept as a
+ * sorted array. Each post becomes one packet per network, with all of the
+ * subscribers in the list. The packets for each network are queued and
+ * written to a single pending file by Flush, instead of creating a pending
+ * file for every packet.
+ */
+class SubscriberFanout final {
+public:
+  SubscriberFanout(const std::vector<net_networks_rec>& nets, char network_app_id);
+  SubscriberFanout(const SubscriberFanout&) = delete;
+  SubscriberFanout& operator=(const SubscriberFanout&) = delete;
+  /** Flushes any queued packets. */
+  ~SubscriberFanout();
+
+  /** Queues the packets to send template_packet on, see send_post_to_subscribers. */
+  bool Send(int original_net_num, const std::string& original_subtype, const subboard_t& sub,
+            const Packet& template_packet, const std::set<uint16_t>& subscribers_to_skip,
+            subscribers_send_to_t send_to);
+  /** Writes the queued packets to a new pending file for each network. */
+  bool Flush();
+  /** Forgets the subscriber lists read so far, call after changing one. */
+  void Reload() { subscribers_.clear(); }
+
+private:
+  /** The sorted subscribers of subtype on net, or nullptr if they can't be read. */
+  const std::vector<uint16_t>* subscribers(const net_networks_rec& net, const std::string& subtype);
+  bool Queue(int net_num, const net_header_rec& h, const std::vector<uint16_t>& list,
+             const std::string& text);
+
+  const std::vector<net_networks_rec>& nets_;
+  const char network_app_id_;
+  // Full path of the subscriber file to its sorted subscribers.
+  std::map<std::string, std::pair<bool, std::vector<uint16_t>>> subscribers_;
+  // Network number to the packets queued for it.
+  std::map<int, PacketBatch> batches_;
+};
+
 } // namespace net
 } // namespace sdk
 } // namespace wwiv
@@ -94,8 +94,7 @@ bool UserManager::readuser_nocache(User *pUser, int user_number) {
     return false;
   }
   long pos = static_cast<long>(userrec_length_) * static_cast<long>(user_number);
-  userList.Seek(pos, File::Whence::begin);
-  userList.Read(&pUser->data, userrec_length_);
+  userList.ReadAt(pos, &pUser->data, userrec_length_);
   pUser->FixUp();
   return true;
 }
@@ -108,8 +107,7 @@ bool UserManager::writeuser_nocache(User *pUser, int user_number) {
   File userList(FilePath(data_directory_, USER_LST));
   if (userList.Open(File::modeReadWrite | File::modeBinary | File::modeCreateFile)) {
     auto pos = static_cast<long>(userrec_length_) * static_cast<long>(user_number);
-    userList.Seek(pos, File::Whence::begin);
-    userList.Write(&pUser->data, userrec_length_);
+    userList.WriteAt(pos, &pUser->data, userrec_length_);
     return true;
   }
   return false;
@@ -529,8 +529,11 @@ struct subfile_header_t {
   uint32_t password_crc32;
   // in WWIV type-2 message bases, this is always 0.
   uint32_t base_message_num;
+  // Number of posts marked with status_post_tombstone, these are still
+  // included in active_message_count until the sub is compacted.
+  uint16_t tombstone_message_count;
   // UNUSED
-  uint8_t padding_1[49];
+  uint8_t padding_1[47];
   // Number of messages in this area.
   uint16_t active_message_count;
   // UNUSED
@@ -834,6 +837,8 @@ struct batchrec {
 #define status_pending_net 0x08
 #define status_post_source_verified 0x10
 #define status_post_new_net 0x20
+// Deleted through the message API, removed by the next compaction.
+#define status_post_tombstone 0x40
 
 // mailrec.status
 #define status_multimail 0x01
@@ -0,0 +1,161 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "core/datafile.h"
+#include "core/file.h"
+#include "core_test/file_helper.h"
+#include "sdk/bbslist.h"
+#include "sdk/filenames.h"
+#include "gtest/gtest.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+using namespace wwiv::core;
+using namespace wwiv::sdk;
+
+class BbsListTest : public testing::Test {
+public:
+  void SetUp() override {
+    helper_.CreateTempFile(BBSLIST_NET, "@1 *111-111-1111 #9600 \"One\"\n"
+                                        "@2 *222-222-2222 #9600 \"Two\"\n"
+                                        "@3 *333-333-3333 #9600 \"Three\"\n");
+    helper_.CreateTempFile(CONNECT_NET, "@1 2=1.0\n@2 1=1.0 3=1.0\n@3 2=1.0\n");
+  }
+
+  static net_system_list_rec CreateSystem(uint16_t sysnum, uint16_t forsys, int16_t numhops) {
+    net_system_list_rec n{};
+    n.sysnum = sysnum;
+    n.forsys = forsys;
+    n.numhops = numhops;
+    return n;
+  }
+
+protected:
+  FileHelper helper_;
+};
+
+TEST_F(BbsListTest, ParseBbsListNet) {
+  auto b = BbsListNet::ParseBbsListNet(1, helper_.TempDir());
+  ASSERT_EQ(3u, b.node_config().size());
+  EXPECT_EQ(2, b.forsys_for(2));
+  EXPECT_EQ(2, b.forsys_for(3));
+  EXPECT_EQ(2, b.node_config_for(3)->numhops);
+  EXPECT_EQ(WWIVNET_NO_NODE, b.forsys_for(4));
+}
+
+TEST_F(BbsListTest, RoutingTable_WriteAndRead) {
+  const auto dir = helper_.TempDir();
+  auto b = BbsListNet::ParseBbsListNet(1, dir);
+  const auto crc = BbsRoutingTable::SourceChecksum(1, dir);
+  EXPECT_EQ(crc, b.source_crc());
+  ASSERT_TRUE(BbsRoutingTable::Write(dir, 1, crc, b));
+
+  BbsRoutingTable table(dir);
+  ASSERT_TRUE(table.Open());
+  EXPECT_EQ(crc, table.header().source_crc);
+  EXPECT_EQ(BbsRoutingTable::BbsDataChecksum(dir), table.header().bbsdata_crc);
+  EXPECT_TRUE(table.IsCurrentFor(dir));
+  EXPECT_EQ(2, table.route_for(3).forsys);
+  EXPECT_EQ(2, table.route_for(3).numhops);
+  EXPECT_EQ(WWIVNET_NO_NODE, table.route_for(4).forsys);
+}
+
+TEST_F(BbsListTest, RoutingTable_Missing) {
+  BbsRoutingTable table(helper_.TempDir());
+  EXPECT_FALSE(table.Open());
+}
+
+TEST_F(BbsListTest, ReadBbsDataNet_UsesRoutingTable) {
+  const auto dir = helper_.TempDir();
+  vector<net_system_list_rec> systems{CreateSystem(1, 1, 0), CreateSystem(2, 2, 1), CreateSystem(3, 2, 2)};
+  {
+    DataFile<net_system_list_rec> file(FilePath(dir, BBSDATA_NET), File::modeBinary |
+                                       File::modeReadWrite | File::modeCreateFile);
+    ASSERT_TRUE(file.WriteVector(systems));
+  }
+  // Use a different route in the table than bbsdata.net to see which one is used.
+  BbsListNet routes{CreateSystem(1, 1, 0), CreateSystem(2, 2, 1), CreateSystem(3, 3, 1)};
+  ASSERT_TRUE(BbsRoutingTable::Write(dir, 1, 0, routes));
+
+  auto b = BbsListNet::ReadBbsDataNet(dir);
+  EXPECT_EQ(3, b.forsys_for(3));
+  EXPECT_EQ(WWIVNET_NO_NODE, b.forsys_for(4));
+  EXPECT_EQ(2, b.node_config_for(3)->forsys);
+}
+
+TEST_F(BbsListTest, ReadBbsDataNet_IgnoresStaleRoutingTable) {
+  const auto dir = helper_.TempDir();
+  vector<net_system_list_rec> systems{CreateSystem(1, 1, 0), CreateSystem(2, 2, 1), CreateSystem(3, 2, 2)};
+  {
+    DataFile<net_system_list_rec> file(FilePath(dir, BBSDATA_NET), File::modeBinary |
+                                       File::modeReadWrite | File::modeCreateFile);
+    ASSERT_TRUE(file.WriteVector(systems));
+  }
+  BbsListNet routes{CreateSystem(1, 1, 0), CreateSystem(2, 2, 1), CreateSystem(3, 3, 1)};
+  ASSERT_TRUE(BbsRoutingTable::Write(dir, 1, 0, routes));
+
+  // Rewrite bbsdata.net with the same number of systems, the size matches
+  // so only the CRC can tell them apart.
+  const auto mtime = File(FilePath(dir, BBSDATA_NET)).last_write_time();
+  systems[2].numhops = 3;
+  {
+    DataFile<net_system_list_rec> file(FilePath(dir, BBSDATA_NET), File::modeBinary |
+                                       File::modeReadWrite | File::modeCreateFile);
+    ASSERT_TRUE(file.WriteVector(systems));
+  }
+  ASSERT_TRUE(File(FilePath(dir, BBSDATA_NET)).set_last_write_time(mtime + 10));
+  auto b = BbsListNet::ReadBbsDataNet(dir);
+  EXPECT_EQ(2, b.forsys_for(3));
+}
+
+TEST_F(BbsListTest, ReadBbsDataNet_TouchedBbsDataNet) {
+  const auto dir = helper_.TempDir();
+  vector<net_system_list_rec> systems{CreateSystem(1, 1, 0), CreateSystem(2, 2, 1), CreateSystem(3, 2, 2)};
+  {
+    DataFile<net_system_list_rec> file(FilePath(dir, BBSDATA_NET), File::modeBinary |
+                                       File::modeReadWrite | File::modeCreateFile);
+    ASSERT_TRUE(file.WriteVector(systems));
+  }
+  BbsListNet routes{CreateSystem(1, 1, 0), CreateSystem(2, 2, 1), CreateSystem(3, 3, 1)};
+  ASSERT_TRUE(BbsRoutingTable::Write(dir, 1, 0, routes));
+
+  // Only the mtime changed, the CRC still matches so the table is used.
+  File bbsdata(FilePath(dir, BBSDATA_NET));
+  ASSERT_TRUE(bbsdata.set_last_write_time(bbsdata.last_write_time() + 10));
+  auto b = BbsListNet::ReadBbsDataNet(dir);
+  EXPECT_EQ(3, b.forsys_for(3));
+}
+
+TEST_F(BbsListTest, ParseBbsListNet_UsesRoutingTableUntilSourcesChange) {
+  const auto dir = helper_.TempDir();
+  BbsListNet routes{CreateSystem(1, 1, 0), CreateSystem(2, 2, 1), CreateSystem(3, 3, 1)};
+  ASSERT_TRUE(BbsRoutingTable::Write(dir, 1, BbsRoutingTable::SourceChecksum(1, dir), routes));
+  {
+    auto b = BbsListNet::ParseBbsListNet(1, dir);
+    EXPECT_EQ(3, b.forsys_for(3));
+    EXPECT_EQ(1, b.node_config_for(3)->numhops);
+  }
+
+  helper_.CreateTempFile(CONNECT_NET, "@1 2=1.0\n@2 1=1.0 3=1.0\n@3 2=1.0 4=1.0\n");
+  auto b = BbsListNet::ParseBbsListNet(1, dir);
+  EXPECT_EQ(2, b.forsys_for(3));
+  EXPECT_EQ(2, b.node_config_for(3)->numhops);
+}
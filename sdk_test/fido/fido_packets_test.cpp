@@ -0,0 +1,141 @@
+/**************************************************************************/
+/*                                                                        */
+/*                          WWIV Version 5.x                              */
+/*                Copyright (C)2017, WWIV Software Services               */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/**************************************************************************/
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <string>
+
+#include "core/file.h"
+#include "core/strings.h"
+#include "core_test/file_helper.h"
+#include "sdk/fido/fido_packets.h"
+
+using std::string;
+using namespace wwiv::core;
+using namespace wwiv::sdk::fido;
+using namespace wwiv::sdk::net;
+using namespace wwiv::strings;
+
+class FidoPacketsTest : public testing::Test {
+public:
+  static string Message(uint16_t orig_node, const string& subject, const string& text) {
+    fido_packed_message_t nh{};
+    nh.message_type = 2;
+    nh.orig_node = orig_node;
+    nh.orig_net = 100;
+    string s(reinterpret_cast<const char*>(&nh), sizeof(fido_packed_message_t));
+    s.append("01 Jan 17  12:00:00");
+    s.push_back('\0');
+    s.append("All");
+    s.push_back('\0');
+    s.append("Sysop");
+    s.push_back('\0');
+    s.append(subject);
+    s.push_back('\0');
+    s.append(text);
+    s.push_back('\0');
+    return s;
+  }
+
+  string CreatePacket(const string& long_text) {
+    packet_header_2p_t header{};
+    header.orig_zone = 1;
+    strcpy(header.password, "pw");
+    string s(reinterpret_cast<const char*>(&header), sizeof(packet_header_2p_t));
+    s.append(Message(1, "Hello", "Hello World\r"));
+    s.append(Message(2, "Long", long_text));
+    // End of packet.
+    s.append(2, '\0');
+    return CreatePacketFile("test.pkt", s);
+  }
+
+  string CreatePacketFile(const string& name, const string& contents) {
+    // CreateTempFile stops at the first null.
+    const auto path = helper_.CreateTempFilePath(name);
+    File f(path);
+    f.Open(File::modeBinary | File::modeCreateFile | File::modeReadWrite | File::modeTruncate);
+    f.Write(contents);
+    return path;
+  }
+
+  FileHelper helper_;
+};
+
+TEST_F(FidoPacketsTest, Reader) {
+  const string long_text(1000, 'x');
+  FidoPacketReader reader(CreatePacket(long_text));
+  ASSERT_TRUE(reader.Open());
+  packet_header_2p_t header{};
+  ASSERT_TRUE(reader.ReadHeader(header));
+  EXPECT_EQ(1, header.orig_zone);
+  EXPECT_STREQ("pw", header.password);
+
+  FidoPackedMessage msg;
+  ASSERT_EQ(ReadPacketResponse::OK, reader.Next(msg));
+  EXPECT_EQ(1, msg.nh.orig_node);
+  EXPECT_EQ("01 Jan 17  12:00:00", msg.vh.date_time);
+  EXPECT_EQ("All", msg.vh.to_user_name);
+  EXPECT_EQ("Sysop", msg.vh.from_user_name);
+  EXPECT_EQ("Hello", msg.vh.subject);
+  EXPECT_EQ("Hello World\r", msg.vh.text);
+
+  ASSERT_EQ(ReadPacketResponse::OK, reader.Next(msg));
+  EXPECT_EQ(2, msg.nh.orig_node);
+  EXPECT_EQ(long_text, msg.vh.text);
+
+  EXPECT_EQ(ReadPacketResponse::END_OF_FILE, reader.Next(msg));
+}
+
+TEST_F(FidoPacketsTest, SameAsReadPackedMessage) {
+  const string long_text(1000, 'x');
+  const auto path = CreatePacket(long_text);
+  FidoPacketReader reader(path);
+  ASSERT_TRUE(reader.Open());
+  File f(path);
+  ASSERT_TRUE(f.Open(File::modeBinary | File::modeReadOnly));
+  packet_header_2p_t header{};
+  ASSERT_TRUE(reader.ReadHeader(header));
+  ASSERT_EQ(sizeof(packet_header_2p_t), f.Read(&header, sizeof(packet_header_2p_t)));
+
+  for (int i = 0; i < 3; i++) {
+    FidoPackedMessage expected;
+    FidoPackedMessage actual;
+    const auto expected_response = read_packed_message(f, expected);
+    ASSERT_EQ(expected_response, reader.Next(actual)) << i;
+    if (expected_response != ReadPacketResponse::OK) {
+      break;
+    }
+    EXPECT_EQ(expected.nh.orig_node, actual.nh.orig_node);
+    EXPECT_EQ(expected.vh.date_time, actual.vh.date_time);
+    EXPECT_EQ(expected.vh.to_user_name, actual.vh.to_user_name);
+    EXPECT_EQ(expected.vh.from_user_name, actual.vh.from_user_name);
+    EXPECT_EQ(expected.vh.subject, actual.vh.subject);
+    EXPECT_EQ(expected.vh.text, actual.vh.text);
+  }
+}
+
+TEST_F(FidoPacketsTest, Reader_Truncated) {
+  packet_header_2p_t header{};
+  string s(reinterpret_cast<const char*>(&header), sizeof(packet_header_2p_t));
+  s.append(Message(1, "Hello", "Hello World"), 0, 5);
+  FidoPacketReader reader(CreatePacketFile("short.pkt", s));
+  ASSERT_TRUE(reader.Open());
+  ASSERT_TRUE(reader.ReadHeader(header));
+  FidoPackedMessage msg;
+  EXPECT_EQ(ReadPacketResponse::ERROR, reader.Next(msg));
+}
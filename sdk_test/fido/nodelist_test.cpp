@@ -21,9 +21,12 @@
 #include <cstring>
 #include <type_traits>
 
+#include "core/file.h"
 #include "core/stl.h"
 #include "core/strings.h"
+#include "core_test/file_helper.h"
 #include "sdk/fido/nodelist.h"
+#include "sdk/fido/nodelist_index.h"
 
 using std::cout;
 using std::endl;
@@ -72,6 +75,62 @@ TEST(NodelistTest, Zone) {
   EXPECT_EQ(e.keyword_, NodelistKeyword::zone);
 }
 
+TEST(NodelistTest, ParseDataLine_Flags) {
+  NodelistEntry e{};
+  ASSERT_TRUE(NodelistEntry::ParseDataLine(
+      "Pvt,2,name,loc,sysop,-Unpublished-,300,MO,INA:foo.org,IBN:bar.org:24556,ITN:2323,IVN,LO", e));
+  EXPECT_EQ(NodelistKeyword::pvt, e.keyword_);
+  EXPECT_EQ(2, e.number_);
+  EXPECT_EQ(300u, e.baud_rate_);
+  EXPECT_TRUE(e.mo_);
+  EXPECT_TRUE(e.lo_);
+  EXPECT_FALSE(e.cm_);
+  EXPECT_EQ("foo.org", e.hostname_);
+  EXPECT_TRUE(e.binkp_);
+  EXPECT_EQ("bar.org", e.binkp_hostname_);
+  EXPECT_EQ(24556, e.binkp_port_);
+  EXPECT_TRUE(e.telnet_);
+  EXPECT_EQ("foo.org", e.telnet_hostname_);
+  EXPECT_EQ(2323, e.telnet_port_);
+  // Internet flags need a value.
+  EXPECT_FALSE(e.vmodem_);
+}
+
+TEST(NodelistTest, ParseDataLine_TooShort) {
+  NodelistEntry e{};
+  EXPECT_FALSE(NodelistEntry::ParseDataLine("Host,1,name,loc,sysop", e));
+  // Without a keyword, the baud rate is needed too.
+  EXPECT_FALSE(NodelistEntry::ParseDataLine(",1,name,loc,sysop,phone", e));
+  EXPECT_TRUE(NodelistEntry::ParseDataLine(",1,name,loc,sysop,phone,300", e));
+}
+
+TEST(NodelistTest, ParseText_SameForAnyNumberOfThreads) {
+  std::string text;
+  for (int zone = 1; zone <= 3; zone++) {
+    text += StrCat("Zone,", zone, ",Zone_", zone, ",loc,sysop,-Unpublished-,300,CM\r\n");
+    for (int region = 1; region <= 3; region++) {
+      text += StrCat("Region,", zone * 10 + region, ",Region,loc,sysop,-Unpublished-,300\r\n");
+      text += StrCat(",1,Node,loc,sysop,-Unpublished-,300,INA:z", zone, ".org,IBN\r\n");
+      text += StrCat("Host,", zone * 100 + region, ",Net,loc,sysop,-Unpublished-,300\r\n");
+      for (int node = 1; node <= 5; node++) {
+        text += StrCat(",", node, ",Node,loc,sysop,-Unpublished-,300,CM\r\n");
+      }
+    }
+  }
+
+  const auto expected = Nodelist::ParseText(text, 1);
+  ASSERT_EQ(3u * 3u * 6u, expected.size());
+  for (int threads = 2; threads <= 8; threads++) {
+    const auto entries = Nodelist::ParseText(text, threads);
+    ASSERT_EQ(expected.size(), entries.size()) << threads;
+    for (std::size_t i = 0; i < entries.size(); i++) {
+      EXPECT_EQ(expected[i].address_, entries[i].address_) << threads;
+      EXPECT_EQ(expected[i].hostname_, entries[i].hostname_) << threads;
+    }
+  }
+  EXPECT_EQ(FidoAddress("3:303/5"), expected.back().address_);
+}
+
 TEST(NodelistTest, Smoke) {
   std::vector<std::string> lines = SplitString(raw, "\n");
 
@@ -127,4 +186,109 @@ TEST(NodelistTest, Nodes) {
   auto nets = nl.nodes(1, 261);
   std::vector<uint16_t>expected{1, 1300};
   EXPECT_EQ(expected, nets);
-}
\ No newline at end of file
+}
+
+TEST(NodelistTest, Ranges) {
+  std::vector<std::string> lines = SplitString(raw, "\n");
+  Nodelist nl(lines);
+  ASSERT_TRUE(nl);
+
+  auto all = nl.entries();
+  ASSERT_EQ(6, all.size());
+  EXPECT_EQ(FidoAddress("1:10/1"), all.front().address_);
+  EXPECT_EQ(FidoAddress("1:261/1300"), all[5].address_);
+
+  auto n261 = nl.entries(1, 261);
+  ASSERT_EQ(2, n261.size());
+  // Views into the nodelist, not copies.
+  EXPECT_EQ(nl.entry(1, 261, 1), &n261[0]);
+  EXPECT_EQ(nl.entry(1, 261, 1300), &n261[1]);
+  EXPECT_EQ(all.end(), n261.end());
+
+  EXPECT_EQ(all.size(), nl.entries(1).size());
+  EXPECT_TRUE(nl.entries(2).empty());
+  EXPECT_TRUE(nl.entries(1, 262).empty());
+  EXPECT_TRUE(nl.nets(2).empty());
+  EXPECT_TRUE(nl.nodes(1, 262).empty());
+}
+
+TEST(NodelistTest, Index_CompiledOnFirstLoad) {
+  FileHelper helper;
+  const auto path = helper.CreateTempFile("nodelist.123", raw);
+  std::vector<std::string> lines = SplitString(raw, "\n");
+  Nodelist expected(lines);
+
+  Nodelist text(path);
+  ASSERT_TRUE(text);
+  NodelistIndex index(path);
+  ASSERT_TRUE(index.Open());
+  EXPECT_EQ(expected.entries().size(), index.size());
+
+  Nodelist nl(path);
+  ASSERT_TRUE(nl);
+  EXPECT_EQ(expected.zones(), nl.zones());
+  EXPECT_EQ(expected.nets(1), nl.nets(1));
+  EXPECT_EQ(expected.nodes(1, 261), nl.nodes(1, 261));
+  EXPECT_EQ(expected.entries(1).size(), nl.entries(1).size());
+  EXPECT_TRUE(nl.contains(FidoAddress("1:123/789")));
+  EXPECT_FALSE(nl.contains(FidoAddress("1:102/943")));
+  EXPECT_FALSE(nl.contains(FidoAddress("1:261/1.1")));
+
+  const auto* e = nl.entry(1, 261, 1300);
+  ASSERT_TRUE(e != nullptr);
+  EXPECT_EQ(FidoAddress("1:261/1300"), e->address_);
+  EXPECT_EQ("Weather Station BBS (Mystic)", e->name_);
+  EXPECT_EQ("Sysop Name261 1300", e->sysop_name_);
+  EXPECT_EQ("Bel Air MD", e->location_);
+  EXPECT_TRUE(e->cm_);
+  EXPECT_TRUE(e->binkp_);
+  EXPECT_EQ("bbs.weather-station.org", e->binkp_hostname_);
+  EXPECT_EQ(24557, e->binkp_port_);
+  EXPECT_FALSE(e->telnet_);
+  EXPECT_EQ(e, &nl.entry(FidoAddress("1:261/1300")));
+  EXPECT_EQ(nullptr, nl.entry(1, 261, 2));
+}
+
+TEST(NodelistTest, Index_StaleIndexIsIgnored) {
+  FileHelper helper;
+  const auto path = helper.CreateTempFile("nodelist.123", raw);
+  ASSERT_TRUE(Nodelist(path));
+  {
+    NodelistIndex index(path);
+    ASSERT_TRUE(index.Open());
+  }
+
+  const auto changed = StrCat(raw, ",1301,New_BBS,Bel_Air_MD,Sysop,-Unpublished-,300,CM\n");
+  helper.CreateTempFile("nodelist.123", changed);
+  {
+    NodelistIndex index(path);
+    EXPECT_FALSE(index.Open());
+  }
+
+  Nodelist nl(path);
+  ASSERT_TRUE(nl);
+  EXPECT_TRUE(nl.contains(FidoAddress("1:261/1301")));
+  NodelistIndex index(path);
+  ASSERT_TRUE(index.Open());
+  EXPECT_TRUE(index.find(1, 261, 1301) != nullptr);
+}
+
+TEST(NodelistTest, Index_TouchedNodelistIsStillUsed) {
+  FileHelper helper;
+  const auto path = helper.CreateTempFile("nodelist.123", raw);
+  ASSERT_TRUE(Nodelist(path));
+  wwiv::core::File f(path);
+  ASSERT_TRUE(f.set_last_write_time(f.last_write_time() + 60));
+
+  // Same contents, so the checksum still matches.
+  NodelistIndex index(path);
+  EXPECT_TRUE(index.Open());
+}
+
+TEST(NodelistTest, FindLatestNodelist_SkipsIndex) {
+  FileHelper helper;
+  const auto path = helper.CreateTempFile("nodelist.123", raw);
+  ASSERT_TRUE(Nodelist(path));
+  ASSERT_TRUE(wwiv::core::File::Exists(NodelistIndex::index_filename(path)));
+  EXPECT_EQ("nodelist.123", Nodelist::FindLatestNodelist(helper.TempDir(), "nodelist"));
+}
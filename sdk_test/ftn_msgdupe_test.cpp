@@ -134,4 +134,108 @@ TEST_F(FtnMsgDupeTest, Remove) {
   EXPECT_TRUE(dupe.is_dupe(1, 2));
   dupe.remove(1, 2);
   EXPECT_FALSE(dupe.is_dupe(1, 2));
-}
\ No newline at end of file
+}
+TEST_F(FtnMsgDupeTest, Persists) {
+  {
+    FtnMessageDupe dupe(config_.datadir(), true, 10);
+    ASSERT_TRUE(dupe.IsInitialized());
+    dupe.add(1, 2);
+    dupe.add(3, 4);
+  }
+  FtnMessageDupe dupe(config_.datadir(), true, 10);
+  ASSERT_TRUE(dupe.IsInitialized());
+  EXPECT_EQ(2u, dupe.size());
+  EXPECT_TRUE(dupe.is_dupe(1, 0));
+  EXPECT_TRUE(dupe.is_dupe(0, 4));
+  EXPECT_FALSE(dupe.is_dupe(2, 1));
+  EXPECT_TRUE(File::Exists(FilePath(config_.datadir(), MSGDUPE_IDX)));
+}
+
+TEST_F(FtnMsgDupeTest, LockedWhileOpen) {
+  {
+    FtnMessageDupe dupe(config_.datadir(), true, 10);
+    ASSERT_TRUE(dupe.IsInitialized());
+    FtnMessageDupe other(config_.datadir(), true, 10, std::chrono::milliseconds(10));
+    EXPECT_FALSE(other.IsInitialized());
+    EXPECT_FALSE(other.add(1, 2));
+  }
+  FtnMessageDupe dupe(config_.datadir(), true, 10);
+  EXPECT_TRUE(dupe.IsInitialized());
+}
+
+TEST_F(FtnMsgDupeTest, EvictsOldest) {
+  FtnMessageDupe dupe(config_.datadir(), true, 3);
+  for (uint32_t i = 1; i <= 4; i++) {
+    dupe.add(i, i + 100);
+  }
+  EXPECT_EQ(3u, dupe.size());
+  EXPECT_FALSE(dupe.is_dupe(1, 0));
+  EXPECT_FALSE(dupe.is_dupe(0, 101));
+  for (uint32_t i = 2; i <= 4; i++) {
+    EXPECT_TRUE(dupe.is_dupe(i, 0)) << i;
+    EXPECT_TRUE(dupe.is_dupe(0, i + 100)) << i;
+  }
+}
+
+TEST_F(FtnMsgDupeTest, EvictsOldest_ManyWraps) {
+  const uint32_t capacity = 100;
+  FtnMessageDupe dupe(config_.datadir(), false, capacity);
+  const uint32_t num = 1000;
+  for (uint32_t i = 1; i <= num; i++) {
+    // Reuse a few msgid values so that tables hold the same key more than once.
+    dupe.add(i * 7919, (i % 150) + 1);
+  }
+  for (uint32_t i = 1; i <= num; i++) {
+    EXPECT_EQ(i > num - capacity, dupe.is_dupe(i * 7919, 0)) << i;
+  }
+  EXPECT_TRUE(dupe.is_dupe(0, (num % 150) + 1));
+  // This msgid was last added by entry num - capacity, which was evicted.
+  EXPECT_FALSE(dupe.is_dupe(0, ((num - capacity) % 150) + 1));
+}
+
+TEST_F(FtnMsgDupeTest, ImportsLegacyFile) {
+  std::vector<msgids> ids;
+  for (uint32_t i = 1; i <= 5; i++) {
+    msgids id{};
+    id.header = i;
+    id.msgid = i + 100;
+    ids.push_back(id);
+  }
+  ASSERT_TRUE(CreateDupes(ids));
+  FtnMessageDupe dupe(config_.datadir(), true, 3);
+  ASSERT_TRUE(dupe.IsInitialized());
+  EXPECT_EQ(3u, dupe.size());
+  EXPECT_FALSE(dupe.is_dupe(2, 102));
+  EXPECT_TRUE(dupe.is_dupe(3, 0));
+  EXPECT_TRUE(dupe.is_dupe(0, 105));
+  EXPECT_FALSE(File::Exists(FilePath(config_.datadir(), MSGDUPE_DAT)));
+}
+
+TEST_F(FtnMsgDupeTest, CapacityChange_KeepsNewest) {
+  {
+    FtnMessageDupe dupe(config_.datadir(), true, 10);
+    for (uint32_t i = 1; i <= 5; i++) {
+      dupe.add(i, 0);
+    }
+    dupe.remove(4, 0);
+  }
+  FtnMessageDupe dupe(config_.datadir(), true, 3);
+  ASSERT_TRUE(dupe.IsInitialized());
+  EXPECT_EQ(3u, dupe.capacity());
+  EXPECT_EQ(3u, dupe.size());
+  EXPECT_FALSE(dupe.is_dupe(1, 0));
+  EXPECT_TRUE(dupe.is_dupe(2, 0));
+  EXPECT_TRUE(dupe.is_dupe(3, 0));
+  EXPECT_FALSE(dupe.is_dupe(4, 0));
+  EXPECT_TRUE(dupe.is_dupe(5, 0));
+}
+
+TEST_F(FtnMsgDupeTest, CreateMessageID_Static_DoesNotOpenDupes) {
+  ASSERT_TRUE(CreateDupes({msgids{1, 2}}));
+  FidoAddress a{"1:2/3"};
+  auto line = FtnMessageDupe::CreateMessageID(config_.datadir(), a);
+  EXPECT_TRUE(starts_with(line, "1:2/3 "));
+  EXPECT_TRUE(File::Exists(FilePath(config_.datadir(), MSGID_DAT)));
+  EXPECT_TRUE(File::Exists(FilePath(config_.datadir(), MSGDUPE_DAT)));
+  EXPECT_FALSE(File::Exists(FilePath(config_.datadir(), MSGDUPE_IDX)));
+}
@@ -0,0 +1,155 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)2017, WWIV Software Services                  */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "core/datafile.h"
+#include "core/file.h"
+#include "core_test/file_helper.h"
+#include "sdk/msgapi/sub_cache_wwiv.h"
+#include "sdk/vardec.h"
+
+using std::string;
+using std::vector;
+using namespace wwiv::core;
+using namespace wwiv::sdk::msgapi;
+
+class WWIVSubCacheTest : public testing::Test {
+public:
+  void SetUp() override { path_ = helper_.CreateTempFilePath("a1.sub"); }
+
+  // Writes a sub with one post per entry in qscans, posts with a qscan
+  // in tombstones are marked as deleted through the message API.
+  void WriteSub(const vector<uint32_t>& qscans, uint64_t mod_count,
+                const vector<uint32_t>& tombstones = {}) {
+    DataFile<postrec> sub(path_, File::modeBinary | File::modeCreateFile | File::modeReadWrite |
+                                     File::modeTruncate);
+    ASSERT_TRUE(sub);
+    subfile_header_t h{};
+    strcpy(h.signature, "WWIV\x1A");
+    h.active_message_count = static_cast<uint16_t>(qscans.size());
+    h.mod_count = mod_count;
+    h.tombstone_message_count = static_cast<uint16_t>(tombstones.size());
+    sub.Write(reinterpret_cast<const postrec*>(&h));
+    for (auto q : qscans) {
+      postrec p{};
+      p.qscan = q;
+      if (std::find(tombstones.begin(), tombstones.end(), q) != tombstones.end()) {
+        p.status |= status_post_tombstone;
+      }
+      sub.Write(&p);
+    }
+  }
+
+  FileHelper helper_;
+  string path_;
+  WWIVSubCache cache_;
+};
+
+TEST_F(WWIVSubCacheTest, Empty) {
+  WriteSub({}, 1);
+  auto* index = cache_.get(path_);
+  ASSERT_NE(nullptr, index);
+  EXPECT_EQ(0, index->number_of_messages());
+  EXPECT_EQ(0u, index->last_qscan());
+  EXPECT_EQ(1, index->first_message_after(0));
+  EXPECT_EQ(0, index->number_of_messages_after(0));
+}
+
+TEST_F(WWIVSubCacheTest, DoesNotExist) {
+  EXPECT_EQ(nullptr, cache_.get(path_));
+}
+
+TEST_F(WWIVSubCacheTest, FirstMessageAfter) {
+  WriteSub({10, 20, 30, 40}, 1);
+  auto* index = cache_.get(path_);
+  ASSERT_NE(nullptr, index);
+  EXPECT_EQ(4, index->number_of_messages());
+  EXPECT_EQ(40u, index->last_qscan());
+  EXPECT_EQ(20u, index->post(2)->qscan);
+  EXPECT_EQ(nullptr, index->post(5));
+
+  EXPECT_EQ(1, index->first_message_after(0));
+  EXPECT_EQ(1, index->first_message_after(9));
+  EXPECT_EQ(2, index->first_message_after(10));
+  EXPECT_EQ(4, index->first_message_after(35));
+  EXPECT_EQ(5, index->first_message_after(40));
+  EXPECT_EQ(4, index->number_of_messages_after(0));
+  EXPECT_EQ(2, index->number_of_messages_after(20));
+  EXPECT_EQ(0, index->number_of_messages_after(40));
+}
+
+TEST_F(WWIVSubCacheTest, FirstMessageAfter_OutOfOrder) {
+  WriteSub({10, 50, 20, 30}, 1);
+  auto* index = cache_.get(path_);
+  ASSERT_NE(nullptr, index);
+  // Message 2 is the first one newer than 25 even though 3 has a lower qscan.
+  EXPECT_EQ(2, index->first_message_after(25));
+  EXPECT_EQ(2, index->number_of_messages_after(25));
+  EXPECT_EQ(2, index->first_message_after(30));
+  EXPECT_EQ(5, index->first_message_after(50));
+}
+
+TEST_F(WWIVSubCacheTest, RefreshesWhenChanged) {
+  WriteSub({10, 20}, 1);
+  ASSERT_NE(nullptr, cache_.get(path_));
+  EXPECT_EQ(2, cache_.get(path_)->number_of_messages());
+
+  WriteSub({10, 20, 30}, 2);
+  auto* index = cache_.get(path_);
+  ASSERT_NE(nullptr, index);
+  EXPECT_EQ(3, index->number_of_messages());
+  EXPECT_EQ(30u, index->last_qscan());
+
+  // Same mod_count but fewer messages (the BBS deleting a post).
+  WriteSub({20, 30}, 2);
+  index = cache_.get(path_);
+  ASSERT_NE(nullptr, index);
+  EXPECT_EQ(2, index->number_of_messages());
+  EXPECT_EQ(1, index->first_message_after(10));
+}
+
+TEST_F(WWIVSubCacheTest, SkipsTombstones) {
+  WriteSub({10, 20, 30, 40}, 1, {20, 40});
+  auto* index = cache_.get(path_);
+  ASSERT_NE(nullptr, index);
+  EXPECT_EQ(2, index->number_of_messages());
+  EXPECT_EQ(30u, index->post(2)->qscan);
+  EXPECT_EQ(3, index->record_number(2));
+  EXPECT_EQ(0, index->record_number(3));
+  EXPECT_EQ(30u, index->last_qscan());
+  EXPECT_EQ(2, index->first_message_after(15));
+  EXPECT_EQ(1, index->number_of_messages_after(15));
+  EXPECT_EQ(3, index->first_message_after(30));
+}
+
+TEST(WWIVSubDupeIndexTest, Key) {
+  postrec p{};
+  p.daten = 1234;
+  p.ownersys = 1;
+  p.owneruser = 2;
+  strcpy(p.title, "Hello World");
+  EXPECT_EQ(WWIVSubDupeIndex::key(p), WWIVSubDupeIndex::key(1234, "hello world", 1, 2));
+  EXPECT_NE(WWIVSubDupeIndex::key(p), WWIVSubDupeIndex::key(1235, "Hello World", 1, 2));
+  EXPECT_NE(WWIVSubDupeIndex::key(p), WWIVSubDupeIndex::key(1234, "Hello World", 2, 2));
+  EXPECT_NE(WWIVSubDupeIndex::key(p), WWIVSubDupeIndex::key(1234, "Hello World", 1, 1));
+  EXPECT_NE(WWIVSubDupeIndex::key(p), WWIVSubDupeIndex::key(1234, "Hello World!", 1, 2));
+}
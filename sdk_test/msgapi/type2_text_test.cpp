@@ -0,0 +1,188 @@
+/**************************************************************************/
+/*                                                                        */
+/*                              WWIV Version 5.x                          */
+/*             Copyright (C)2017, WWIV Software Services                  */
+/*                                                                        */
+/*    Licensed  under the  Apache License, Version  2.0 (the "License");  */
+/*    you may not use this  file  except in compliance with the License.  */
+/*    You may obtain a copy of the License at                             */
+/*                                                                        */
+/*                http://www.apache.org/licenses/LICENSE-2.0              */
+/*                                                                        */
+/*    Unless  required  by  applicable  law  or agreed to  in  writing,   */
+/*    software  distributed  under  the  License  is  distributed on an   */
+/*    "AS IS"  BASIS, WITHOUT  WARRANTIES  OR  CONDITIONS OF ANY  KIND,   */
+/*    either  express  or implied.  See  the  License for  the specific   */
+/*    language governing permissions and limitations under the License.   */
+/*                                                                        */
+#include "gtest/gtest.h"
+
+#include <string>
+#include <vector>
+
+#include "core/file.h"
+#include "core_test/file_helper.h"
+#include "sdk/msgapi/type2_text.h"
+
+using std::string;
+using std::vector;
+using namespace wwiv::core;
+using namespace wwiv::sdk::msgapi;
+
+class Type2TextTest : public testing::Test {
+public:
+  void SetUp() override { path_ = helper_.CreateTempFile("test.dat", ""); }
+
+  // Returns the chain of blocks used by msg.
+  vector<gati_t> blocks(Type2Text& t, const messagerec& msg) {
+    File f(path_);
+    f.Open(File::modeBinary | File::modeReadWrite);
+    auto gat = t.load_gat(f, msg.stored_as / GAT_NUMBER_ELEMENTS);
+    vector<gati_t> result;
+    for (auto b = static_cast<gati_t>(msg.stored_as % GAT_NUMBER_ELEMENTS);
+         b > 0 && b < GAT_NUMBER_ELEMENTS; b = gat[b]) {
+      result.push_back(b);
+    }
+    return result;
+  }
+
+  FileHelper helper_;
+  string path_;
+};
+
+TEST_F(Type2TextTest, SaveAndRead) {
+  Type2Text t(path_);
+  const string text = string(1500, 'x') + "\x1a";
+  messagerec m{2, 0};
+  ASSERT_TRUE(t.savefile(text, &m));
+
+  string out;
+  ASSERT_TRUE(t.readfile(&m, &out));
+  EXPECT_EQ(string(1500, 'x'), out);
+  EXPECT_EQ(3u, blocks(t, m).size());
+}
+
+TEST_F(Type2TextTest, ReadFirstBlocks) {
+  Type2Text t(path_);
+  const string text = string(MSG_BLOCK_SIZE, 'a') + string(MSG_BLOCK_SIZE, 'b') + "c";
+  messagerec m{2, 0};
+  ASSERT_TRUE(t.savefile(text, &m));
+
+  string out;
+  ASSERT_TRUE(t.readfile(&m, &out, 1));
+  EXPECT_EQ(string(MSG_BLOCK_SIZE, 'a'), out);
+  ASSERT_TRUE(t.readfile(&m, &out, 2));
+  EXPECT_EQ(text.substr(0, 2 * MSG_BLOCK_SIZE), out);
+  ASSERT_TRUE(t.readfile(&m, &out, 10));
+  EXPECT_EQ(text, out);
+}
+
+TEST_F(Type2TextTest, SaveMany) {
+  Type2Text t(path_);
+  vector<string> texts;
+  for (int i = 1; i <= 10; i++) {
+    texts.push_back(string(i * 300, static_cast<char>('a' + i)));
+  }
+  vector<messagerec> msgs;
+  ASSERT_TRUE(t.savefiles(texts, msgs));
+  ASSERT_EQ(texts.size(), msgs.size());
+  for (size_t i = 0; i < texts.size(); i++) {
+    string out;
+    ASSERT_TRUE(t.readfile(&msgs[i], &out));
+    EXPECT_EQ(texts[i], out);
+  }
+  // A new text doesn't reuse any of the blocks saved above.
+  messagerec m{2, 0};
+  ASSERT_TRUE(t.savefile("hello", &m));
+  for (const auto& msg : msgs) {
+    EXPECT_NE(msg.stored_as, m.stored_as);
+  }
+  string out;
+  ASSERT_TRUE(t.readfile(&msgs.back(), &out));
+  EXPECT_EQ(texts.back(), out);
+}
+
+TEST_F(Type2TextTest, PrefersContiguousBlocks) {
+  Type2Text t(path_);
+  messagerec a{2, 0}, b{2, 0}, c{2, 0}, d{2, 0};
+  ASSERT_TRUE(t.savefile(string(1000, 'a'), &a));
+  ASSERT_TRUE(t.savefile(string(500, 'b'), &b));
+  ASSERT_TRUE(t.savefile(string(1000, 'c'), &c));
+  ASSERT_TRUE(t.remove_link(b));
+
+  // d needs 3 blocks so won't fit in the hole left by b.
+  ASSERT_TRUE(t.savefile(string(1500, 'd'), &d));
+  auto d_blocks = blocks(t, d);
+  ASSERT_EQ(3u, d_blocks.size());
+  EXPECT_EQ(d_blocks[0] + 1, d_blocks[1]);
+  EXPECT_EQ(d_blocks[1] + 1, d_blocks[2]);
+
+  // A single block will reuse the hole.
+  messagerec e{2, 0};
+  ASSERT_TRUE(t.savefile("e", &e));
+  EXPECT_EQ(blocks(t, b), blocks(t, e));
+
+  string out;
+  ASSERT_TRUE(t.readfile(&c, &out));
+  EXPECT_EQ(string(1000, 'c'), out);
+  ASSERT_TRUE(t.readfile(&d, &out));
+  EXPECT_EQ(string(1500, 'd'), out);
+}
+
+TEST_F(Type2TextTest, FullSectionUsesNextSection) {
+  Type2Text t(path_);
+  messagerec full{2, 0};
+  // Block 0 is never used, so this fills section 0.
+  ASSERT_TRUE(t.savefile(string((GAT_NUMBER_ELEMENTS - 1) * MSG_BLOCK_SIZE, 'x'), &full));
+  EXPECT_EQ(0u, full.stored_as / GAT_NUMBER_ELEMENTS);
+
+  messagerec m{2, 0};
+  ASSERT_TRUE(t.savefile("hello", &m));
+  EXPECT_EQ(1u, m.stored_as / GAT_NUMBER_ELEMENTS);
+}
+
+TEST_F(Type2TextTest, ReusesBlocksFreedElsewhere) {
+  Type2Text t(path_);
+  messagerec full{2, 0};
+  ASSERT_TRUE(t.savefile(string((GAT_NUMBER_ELEMENTS - 1) * MSG_BLOCK_SIZE, 'x'), &full));
+
+  // Simulate another node freeing the whole section behind our back.
+  {
+    File f(path_);
+    ASSERT_TRUE(f.Open(File::modeBinary | File::modeReadWrite));
+    t.save_gat(f, 0, vector<gati_t>(GAT_NUMBER_ELEMENTS));
+  }
+
+  messagerec m{2, 0};
+  ASSERT_TRUE(t.savefile("hello", &m));
+  EXPECT_EQ(0u, m.stored_as / GAT_NUMBER_ELEMENTS);
+}
+
+TEST_F(Type2TextTest, ReadFragmentedChain) {
+  Type2Text t(path_);
+  messagerec m{2, 0};
+  ASSERT_TRUE(t.savefile("x", &m));
+
+  // Build the chain 5 -> 3 -> 4 -> 9 by hand, with the last block not full.
+  const vector<gati_t> chain{5, 3, 4, 9};
+  const string parts[] = {string(MSG_BLOCK_SIZE, 'a'), string(MSG_BLOCK_SIZE, 'b'),
+                          string(MSG_BLOCK_SIZE, 'c'), string(10, 'd')};
+  {
+    File f(path_);
+    ASSERT_TRUE(f.Open(File::modeBinary | File::modeReadWrite));
+    auto gat = t.load_gat(f, 0);
+    for (size_t i = 0; i < chain.size(); i++) {
+      gat[chain[i]] = (i + 1 < chain.size()) ? chain[i + 1] : static_cast<gati_t>(-1);
+      string block(parts[i]);
+      block.resize(MSG_BLOCK_SIZE, '\0');
+      f.Seek(MSG_STARTING(0) + MSG_BLOCK_SIZE * chain[i], File::Whence::begin);
+      f.Write(block);
+    }
+    t.save_gat(f, 0, gat);
+  }
+
+  messagerec fragmented{2, 5};
+  string out;
+  ASSERT_TRUE(t.readfile(&fragmented, &out));
+  EXPECT_EQ(parts[0] + parts[1] + parts[2] + parts[3], out);
+}
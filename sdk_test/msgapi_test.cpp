@@ -164,3 +164,179 @@ TEST_F(MsgApiTest, Resynch_MessageNumber) {
   a2->ResyncMessage(msgnum);
   EXPECT_EQ(1, msgnum);
 }
+
+TEST_F(MsgApiTest, SeesMessagesAddedByOtherArea) {
+  subboard_t sub{};
+  sub.filename = "a1";
+  ASSERT_TRUE(api->Create(sub, -1));
+  unique_ptr<MessageArea> writer(api->Open(sub, -1));
+  unique_ptr<MessageArea> reader(api->Open(sub, -1));
+  EXPECT_EQ(0, reader->number_of_messages());
+
+  for (int i = 1; i <= 50; i++) {
+    auto title = StrCat("Title", i);
+    unique_ptr<Message> m(CreateMessage(*writer, 1, "From", title, "Line1\r\n"));
+    EXPECT_TRUE(writer->AddMessage(*m, {}));
+    // The reader's mapped view of the sub must pick up the new post.
+    ASSERT_EQ(i, reader->number_of_messages());
+    EXPECT_EQ(title, reader->ReadMessageHeader(i)->title());
+  }
+
+  // 1 of 50 is below the compaction threshold, so this is only marked,
+  // but the reader no longer sees it.
+  EXPECT_TRUE(writer->DeleteMessage(1));
+  EXPECT_EQ(49, reader->number_of_messages());
+  EXPECT_EQ("Title2", reader->ReadMessageHeader(1)->title());
+  EXPECT_EQ("Title50", reader->ReadMessageHeader(49)->title());
+
+  EXPECT_TRUE(writer->Compact());
+  EXPECT_EQ(49, reader->number_of_messages());
+  EXPECT_EQ("Title2", reader->ReadMessageHeader(1)->title());
+}
+
+TEST_F(MsgApiTest, ReadMessageHeader) {
+  subboard_t sub{};
+  sub.filename = "a1";
+  ASSERT_TRUE(api->Create(sub, -1));
+  unique_ptr<MessageArea> area(api->Open(sub, -1));
+
+  unique_ptr<Message> m(CreateMessage(*area, 1, "From", "Title", "RE: Short\r\nText\r\n"));
+  EXPECT_TRUE(area->AddMessage(*m, {}));
+
+  // Enough control lines to push the RE: line past the second block.
+  string controls;
+  for (int i = 0; i < 40; i++) {
+    controls += StrCat("\x04", "0Control Line ", string(20, 'x'), "\r\n");
+  }
+  m = CreateMessage(*area, 1, "From2", "Title2", StrCat(controls, "RE: Long\r\nText\r\n"));
+  EXPECT_TRUE(area->AddMessage(*m, {}));
+
+  auto h = area->ReadMessageHeader(1);
+  ASSERT_TRUE(h != nullptr);
+  EXPECT_EQ("Title", h->title());
+  EXPECT_EQ("From", h->from());
+  EXPECT_EQ("Short", h->in_reply_to());
+
+  h = area->ReadMessageHeader(2);
+  ASSERT_TRUE(h != nullptr);
+  EXPECT_EQ("From2", h->from());
+  EXPECT_EQ("Long", h->in_reply_to());
+  EXPECT_EQ(area->ReadMessage(2)->header().in_reply_to(), h->in_reply_to());
+}
+
+TEST_F(MsgApiTest, Exists) {
+  subboard_t sub{};
+  sub.filename = "a1";
+  ASSERT_TRUE(api->Create(sub, -1));
+  unique_ptr<MessageArea> area(api->Open(sub, -1));
+  vector<daten_t> dates;
+  for (int i = 1; i <= 5; i++) {
+    unique_ptr<Message> m(CreateMessage(*area, 1, "From", StrCat("Title", i), "Text"));
+    dates.push_back(m->header().daten());
+    EXPECT_TRUE(area->AddMessage(*m, {}));
+  }
+
+  EXPECT_TRUE(area->Exists(dates[0], "Title1", 0, 1));
+  EXPECT_TRUE(area->Exists(dates[4], "TITLE5", 0, 1));
+  EXPECT_FALSE(area->Exists(dates[0], "Title2", 0, 1));
+  EXPECT_FALSE(area->Exists(dates[0], "Title1", 1, 1));
+  EXPECT_FALSE(area->Exists(dates[0], "Title1", 0, 2));
+
+  // Posts added through another area are seen too.
+  unique_ptr<MessageArea> other(api->Open(sub, -1));
+  unique_ptr<Message> m(CreateMessage(*other, 2, "From", "Other", "Text"));
+  const auto other_date = m->header().daten();
+  EXPECT_TRUE(other->AddMessage(*m, {}));
+  EXPECT_TRUE(area->Exists(other_date, "Other", 0, 2));
+
+  EXPECT_TRUE(area->DeleteMessage(1));
+  EXPECT_FALSE(area->Exists(dates[0], "Title1", 0, 1));
+  EXPECT_TRUE(area->Compact());
+  EXPECT_FALSE(area->Exists(dates[0], "Title1", 0, 1));
+  EXPECT_TRUE(area->Exists(dates[1], "Title2", 0, 1));
+  EXPECT_TRUE(area->Exists(other_date, "Other", 0, 2));
+}
+
+TEST_F(MsgApiTest, AddMessages) {
+  subboard_t sub{};
+  sub.filename = "a1";
+  ASSERT_TRUE(api->Create(sub, -1));
+  unique_ptr<MessageArea> area(api->Open(sub, -1));
+  unique_ptr<Message> first(CreateMessage(*area, 1, "From", "Title0", "Text0"));
+  ASSERT_TRUE(area->AddMessage(*first, {}));
+
+  vector<unique_ptr<Message>> messages;
+  vector<const Message*> batch;
+  for (int i = 1; i <= 20; i++) {
+    messages.push_back(CreateMessage(*area, 1, "From", StrCat("Title", i),
+                                     StrCat(string(i * 100, 'x'), "\r\n")));
+    batch.push_back(messages.back().get());
+  }
+  ASSERT_TRUE(area->AddMessages(batch, {}));
+  ASSERT_EQ(21, area->number_of_messages());
+
+  uint32_t last_qscan = 0;
+  for (int i = 1; i <= 21; i++) {
+    unique_ptr<Message> m(area->ReadMessage(i));
+    ASSERT_TRUE(m != nullptr);
+    EXPECT_EQ(StrCat("Title", i - 1), m->header().title());
+    if (i > 1) {
+      EXPECT_EQ(StrCat(string((i - 1) * 100, 'x'), "\r\n"), m->text().text());
+    }
+    // Each message gets its own increasing qscan value.
+    EXPECT_GT(m->header().last_read(), last_qscan);
+    last_qscan = m->header().last_read();
+    EXPECT_TRUE(area->Exists(m->header().daten(), m->header().title(), 0, 1));
+  }
+}
+
+TEST_F(MsgApiTest, Compact) {
+  subboard_t sub{};
+  sub.filename = "a1";
+  ASSERT_TRUE(api->Create(sub, -1));
+  unique_ptr<MessageArea> area(api->Open(sub, -1));
+  for (int i = 1; i <= 10; i++) {
+    unique_ptr<Message> m(CreateMessage(*area, 1, "From", StrCat("Title", i), StrCat("Text", i)));
+    EXPECT_TRUE(area->AddMessage(*m, {}));
+  }
+  EXPECT_TRUE(area->DeleteMessage(2));
+  EXPECT_EQ(9, area->number_of_messages());
+  // Deleting message 2 renumbered the ones after it.
+  EXPECT_EQ("Title5", area->ReadMessageHeader(4)->title());
+  EXPECT_TRUE(area->DeleteMessage(4));
+  EXPECT_EQ(8, area->number_of_messages());
+  EXPECT_EQ("Title6", area->ReadMessageHeader(4)->title());
+
+  EXPECT_TRUE(area->Compact());
+  ASSERT_EQ(8, area->number_of_messages());
+  EXPECT_EQ("Title1", area->ReadMessageHeader(1)->title());
+  EXPECT_EQ("Title3", area->ReadMessageHeader(2)->title());
+  EXPECT_EQ("Title6", area->ReadMessageHeader(4)->title());
+  unique_ptr<Message> m(area->ReadMessage(8));
+  ASSERT_TRUE(m != nullptr);
+  EXPECT_EQ("Text10\r\n", m->text().text());
+
+  // Compacting again is a no-op.
+  EXPECT_TRUE(area->Compact());
+  EXPECT_EQ(8, area->number_of_messages());
+}
+
+TEST_F(MsgApiTest, Compact_KeepsHiddenPosts) {
+  subboard_t sub{};
+  sub.filename = "a1";
+  ASSERT_TRUE(api->Create(sub, -1));
+  unique_ptr<MessageArea> area(api->Open(sub, -1));
+  for (int i = 1; i <= 10; i++) {
+    unique_ptr<Message> m(CreateMessage(*area, 1, "From", StrCat("Title", i), StrCat("Text", i)));
+    // status_delete hides a post from non-sysops, it isn't deleted.
+    m->header().set_deleted(i == 3);
+    EXPECT_TRUE(area->AddMessage(*m, {}));
+  }
+  EXPECT_TRUE(area->DeleteMessage(1));
+
+  EXPECT_TRUE(area->Compact());
+  ASSERT_EQ(9, area->number_of_messages());
+  auto h = area->ReadMessageHeader(2);
+  EXPECT_EQ("Title3", h->title());
+  EXPECT_TRUE(h->deleted());
+}
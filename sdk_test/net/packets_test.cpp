@@ -19,10 +19,15 @@
 #include "core/strings.h"
 #include "core_test/file_helper.h"
 #include "networkb/net_util.h"
+#include "sdk/filenames.h"
 #include "sdk/net/packets.h"
+#include "sdk/subscribers.h"
+#include "sdk/subxtr.h"
 #include "gtest/gtest.h"
 
 #include <cstdint>
+#include <future>
+#include <set>
 #include <string>
 
 using std::endl;
@@ -131,6 +136,16 @@ TEST_F(PacketsTest, GetMessageField) {
   EXPECT_STREQ("d", remaining.c_str());
 }
 
+TEST_F(PacketsTest, CharClass) {
+  static constexpr CharClass stop{'\0', '\r', '\n'};
+  static_assert(stop.contains('\r'), "constexpr lookup");
+  EXPECT_TRUE(stop.contains('\0'));
+  EXPECT_TRUE(stop.contains('\n'));
+  EXPECT_FALSE(stop.contains('a'));
+  EXPECT_FALSE(stop.contains('\xff'));
+  EXPECT_TRUE(CharClass(std::set<char>{'\xff'}).contains('\xff'));
+}
+
 TEST_F(PacketsTest, FromPacketText_FromPacketText_NewPost) {
   const string s("a\000b\000c\r\nd\r\ne", 11);
   auto pp = ParsedPacketText::FromPacketText(main_type_new_post, s);
@@ -176,3 +191,335 @@ TEST_F(PacketsTest, FromPacketText_Malformed) {
   EXPECT_EQ(pp.sender(), "");
   EXPECT_EQ(pp.date(), "");
 }
+
+// Reads all of the packets in packet file path.
+static std::vector<Packet> read_packets(const string& path) {
+  std::vector<Packet> packets;
+  File f(path);
+  if (!f.Open(File::modeBinary | File::modeReadOnly)) {
+    return packets;
+  }
+  for (;;) {
+    Packet p;
+    if (read_packet(f, p, false) != ReadPacketResponse::OK) {
+      return packets;
+    }
+    packets.push_back(p);
+  }
+}
+
+static Packet CreatePacket(uint16_t tosys, std::vector<uint16_t> list, const string& text) {
+  net_header_rec nh{};
+  nh.tosys = tosys;
+  nh.main_type = main_type_email;
+  nh.list_len = static_cast<uint16_t>(list.size());
+  nh.length = static_cast<uint32_t>(text.size());
+  return Packet(nh, list, text);
+}
+
+TEST_F(PacketsTest, PacketWriterPool_Smoke) {
+  net_networks_rec net{};
+  net.dir = helper_.TempDir();
+  {
+    PacketWriterPool pool(net);
+    EXPECT_TRUE(pool.Write("s1.net", CreatePacket(1, {}, "Hello")));
+    EXPECT_TRUE(pool.Write("s2.net", CreatePacket(0, {2, 3}, "World")));
+    EXPECT_TRUE(pool.Write("s1.net", CreatePacket(1, {}, "Again")));
+    // Nothing is written until flushed.
+    EXPECT_FALSE(File::Exists(FilePath(net.dir, "s1.net")));
+    EXPECT_TRUE(pool.Close());
+    EXPECT_EQ(0u, pool.bytes_pending());
+  }
+
+  auto s1 = read_packets(FilePath(net.dir, "s1.net"));
+  ASSERT_EQ(2u, s1.size());
+  EXPECT_EQ("Hello", s1[0].text());
+  EXPECT_EQ("Again", s1[1].text());
+
+  auto s2 = read_packets(FilePath(net.dir, "s2.net"));
+  ASSERT_EQ(1u, s2.size());
+  EXPECT_EQ("World", s2[0].text());
+  EXPECT_EQ(std::vector<uint16_t>({2, 3}), s2[0].list);
+}
+
+TEST_F(PacketsTest, PacketWriterPool_AppendsAndFlushesAtThreshold) {
+  net_networks_rec net{};
+  net.dir = helper_.TempDir();
+  ASSERT_TRUE(write_wwivnet_packet("s1.net", net, CreatePacket(1, {}, "First")));
+
+  // Flush once more than 100 bytes are waiting.
+  PacketWriterPool pool(net, 100);
+  const string text(40, 'x');
+  const auto path = FilePath(net.dir, "s1.net");
+  const auto packet_size = sizeof(net_header_rec) + text.size();
+  const auto initial_size = helper_.ReadFile(path).size();
+  EXPECT_TRUE(pool.Write("s1.net", CreatePacket(1, {}, text)));
+  EXPECT_EQ(packet_size, pool.bytes_pending());
+  EXPECT_EQ(initial_size, helper_.ReadFile(path).size());
+  EXPECT_TRUE(pool.Write("s1.net", CreatePacket(1, {}, text)));
+  EXPECT_EQ(0u, pool.bytes_pending());
+  EXPECT_EQ(initial_size + 2 * packet_size, helper_.ReadFile(path).size());
+  ASSERT_TRUE(pool.Close());
+
+  auto s1 = read_packets(path);
+  ASSERT_EQ(3u, s1.size());
+  EXPECT_EQ("First", s1[0].text());
+  EXPECT_EQ(text, s1[2].text());
+}
+
+TEST_F(PacketsTest, PacketWriterPool_FileRemovedBetweenFlushes) {
+  net_networks_rec net{};
+  net.dir = helper_.TempDir();
+  const auto path = FilePath(net.dir, "s1.net");
+  PacketWriterPool pool(net);
+  EXPECT_TRUE(pool.Write("s1.net", CreatePacket(1, {}, "Sent")));
+  ASSERT_TRUE(pool.Flush());
+  // Like networkb removing s1.net once it has been sent.
+  ASSERT_TRUE(File::Remove(path));
+  EXPECT_TRUE(pool.Write("s1.net", CreatePacket(1, {}, "Later")));
+  ASSERT_TRUE(pool.Close());
+
+  auto s1 = read_packets(path);
+  ASSERT_EQ(1u, s1.size());
+  EXPECT_EQ("Later", s1[0].text());
+}
+
+TEST_F(PacketsTest, PacketWriterPool_BadLength) {
+  net_networks_rec net{};
+  net.dir = helper_.TempDir();
+  PacketWriterPool pool(net);
+  auto p = CreatePacket(1, {}, "Hello");
+  p.nh.length = 1;
+  EXPECT_FALSE(pool.Write("s1.net", p));
+  EXPECT_EQ(0u, pool.bytes_pending());
+}
+
+TEST_F(PacketsTest, PacketStream_Smoke) {
+  net_networks_rec net{};
+  net.dir = helper_.TempDir();
+  ASSERT_TRUE(write_wwivnet_packet("p1.net", net, CreatePacket(1, {}, "Hello")));
+  ASSERT_TRUE(write_wwivnet_packet("p1.net", net, CreatePacket(0, {2, 3}, "World")));
+
+  PacketStream stream(FilePath(net.dir, "p1.net"), false);
+  ASSERT_TRUE(stream.Open());
+  PacketView v;
+  ASSERT_EQ(ReadPacketResponse::OK, stream.Next(v));
+  EXPECT_EQ(1, v.nh.tosys);
+  EXPECT_EQ(0u, v.list_size());
+  EXPECT_EQ("Hello", v.text());
+
+  ASSERT_EQ(ReadPacketResponse::OK, stream.Next(v));
+  ASSERT_EQ(2u, v.list_size());
+  EXPECT_EQ(2, v.list_at(0));
+  EXPECT_EQ(3, v.list_at(1));
+  EXPECT_EQ("World", v.text());
+
+  auto p = v.ToPacket();
+  EXPECT_EQ(std::vector<uint16_t>({2, 3}), p.list);
+  EXPECT_EQ("World", p.text());
+  EXPECT_EQ(5u, p.nh.length);
+
+  EXPECT_EQ(ReadPacketResponse::END_OF_FILE, stream.Next(v));
+}
+
+TEST_F(PacketsTest, PacketStream_EmptyAndMissing) {
+  PacketStream empty(helper_.CreateTempFile("p1.net", ""), false);
+  ASSERT_TRUE(empty.Open());
+  PacketView v;
+  EXPECT_EQ(ReadPacketResponse::END_OF_FILE, empty.Next(v));
+
+  PacketStream missing(FilePath(helper_.TempDir(), "p2.net"), false);
+  EXPECT_FALSE(missing.Open());
+}
+
+TEST_F(PacketsTest, PacketStream_ShortHeader) {
+  PacketStream stream(helper_.CreateTempFile("p1.net", "abc"), false);
+  ASSERT_TRUE(stream.Open());
+  PacketView v;
+  EXPECT_EQ(ReadPacketResponse::ERROR, stream.Next(v));
+}
+
+TEST_F(PacketsTest, PacketStream_TruncatedList) {
+  net_header_rec nh{};
+  nh.tosys = 1;
+  nh.list_len = 3;
+  nh.length = 0;
+  // Only the first of the 3 list entries made it into the file.
+  std::string data(reinterpret_cast<const char*>(&nh), sizeof(net_header_rec));
+  const uint16_t node = 2;
+  data.append(reinterpret_cast<const char*>(&node), sizeof(uint16_t));
+
+  PacketStream stream(std::string_view(data), false);
+  ASSERT_TRUE(stream.Open());
+  PacketView v;
+  ASSERT_EQ(ReadPacketResponse::OK, stream.Next(v));
+  EXPECT_EQ(1u, v.list_size());
+
+  net_networks_rec net{};
+  net.dir = helper_.TempDir();
+  PacketBatch batch(net);
+  EXPECT_FALSE(batch.Write("s1.net", v));
+  EXPECT_EQ(0, batch.packets());
+  PacketWriterPool pool(net);
+  EXPECT_FALSE(pool.Write("s1.net", v));
+  EXPECT_EQ(0u, pool.bytes_pending());
+}
+
+TEST_F(PacketsTest, PacketWriterPool_WriteView) {
+  net_networks_rec net{};
+  net.dir = helper_.TempDir();
+  ASSERT_TRUE(write_wwivnet_packet("p1.net", net, CreatePacket(0, {2, 3}, "World")));
+
+  PacketStream stream(FilePath(net.dir, "p1.net"), false);
+  ASSERT_TRUE(stream.Open());
+  PacketView v;
+  ASSERT_EQ(ReadPacketResponse::OK, stream.Next(v));
+  {
+    PacketWriterPool pool(net);
+    EXPECT_TRUE(pool.Write("s2.net", v));
+  }
+  EXPECT_EQ(helper_.ReadFile(FilePath(net.dir, "p1.net")),
+            helper_.ReadFile(FilePath(net.dir, "s2.net")));
+}
+
+TEST_F(PacketsTest, PacketBatch_SameAsDirectWrites) {
+  net_networks_rec net{};
+  net.dir = helper_.TempDir();
+  const auto p1 = CreatePacket(2, {}, "Hello");
+  const auto p2 = CreatePacket(3, {}, "World");
+  const auto p3 = CreatePacket(2, {}, "Again");
+  ASSERT_TRUE(write_wwivnet_packet("d2.net", net, p1));
+  ASSERT_TRUE(write_wwivnet_packet("d3.net", net, p2));
+  ASSERT_TRUE(write_wwivnet_packet("d2.net", net, p3));
+
+  PacketBatch batch(net);
+  EXPECT_TRUE(batch.Write("s2.net", p1));
+  EXPECT_TRUE(batch.Write("s3.net", p2));
+  EXPECT_TRUE(batch.Write("s2.net", p3));
+  EXPECT_EQ(2u, batch.files().size());
+  {
+    PacketWriterPool pool(net);
+    EXPECT_TRUE(pool.Write(batch));
+  }
+  EXPECT_EQ(helper_.ReadFile(FilePath(net.dir, "d2.net")),
+            helper_.ReadFile(FilePath(net.dir, "s2.net")));
+  EXPECT_EQ(helper_.ReadFile(FilePath(net.dir, "d3.net")),
+            helper_.ReadFile(FilePath(net.dir, "s3.net")));
+}
+
+TEST_F(PacketsTest, PacketQueue_InMemoryStream) {
+  net_networks_rec net{};
+  net.dir = helper_.TempDir();
+  PacketBatch batch(net);
+  ASSERT_TRUE(batch.Write(LOCAL_NET, CreatePacket(1, {}, "Hello")));
+  ASSERT_TRUE(batch.Write("s2.net", CreatePacket(2, {}, "World")));
+  ASSERT_TRUE(batch.Write(LOCAL_NET, CreatePacket(1, {}, "Again")));
+  auto local = batch.Take(LOCAL_NET);
+  EXPECT_EQ(1u, batch.files().size());
+  EXPECT_TRUE(batch.Take(LOCAL_NET).empty());
+
+  PacketQueue queue;
+  auto reader = std::async(std::launch::async, [&queue] {
+    std::vector<string> texts;
+    PacketQueue::Item item;
+    while (queue.Pop(item)) {
+      PacketStream stream(std::string_view(item.packets), false);
+      EXPECT_TRUE(stream.Open());
+      PacketView v;
+      while (stream.Next(v) == ReadPacketResponse::OK) {
+        texts.emplace_back(v.text());
+      }
+      item.done.set_value(true);
+    }
+    return texts;
+  });
+  auto done = queue.Push("p1.net", local);
+  EXPECT_TRUE(done.get());
+  queue.Close();
+  EXPECT_EQ(std::vector<string>({"Hello", "Again"}), reader.get());
+}
+
+TEST_F(PacketsTest, SubscriberFanout_OnePendingFile) {
+  net_networks_rec net{};
+  net.dir = helper_.TempDir();
+  net.type = network_type_t::wwivnet;
+  net.sysnum = 1;
+  const std::vector<net_networks_rec> nets{net};
+  ASSERT_TRUE(WriteSubcriberFile(net.dir, "nMYSUB.net", {2, 3, 4}));
+  subboard_t sub{};
+  subboard_network_data_t sn{};
+  sn.stype = "MYSUB";
+  sub.nets.push_back(sn);
+
+  auto post = [](uint16_t fromsys, const string& title) {
+    const auto text = CreateFakePacketText("MYSUB", title, "Sysop #1", "Today", "Hello");
+    net_header_rec nh{};
+    nh.fromsys = fromsys;
+    nh.main_type = main_type_new_post;
+    nh.length = static_cast<uint32_t>(text.size());
+    return Packet(nh, {}, text);
+  };
+  {
+    SubscriberFanout fanout(nets, '2');
+    const auto hosted = subscribers_send_to_t::hosted_and_gated_only;
+    EXPECT_TRUE(fanout.Send(0, "MYSUB", sub, post(2, "One"), {}, hosted));
+    EXPECT_TRUE(fanout.Send(0, "MYSUB", sub, post(3, "Two"), {4}, hosted));
+    // Everyone is skipped, so nothing is sent.
+    EXPECT_TRUE(fanout.Send(0, "MYSUB", sub, post(2, "Three"), {3, 4}, hosted));
+    // Nothing is written until flushed.
+    EXPECT_FALSE(File::Exists(FilePath(net.dir, "p1-2-0.net")));
+    EXPECT_TRUE(fanout.Flush());
+  }
+  EXPECT_FALSE(File::Exists(FilePath(net.dir, "p1-2-1.net")));
+
+  auto packets = read_packets(FilePath(net.dir, "p1-2-0.net"));
+  ASSERT_EQ(2u, packets.size());
+  EXPECT_EQ(0, packets[0].nh.tosys);
+  EXPECT_EQ(std::vector<uint16_t>({3, 4}), packets[0].list);
+  EXPECT_EQ(2, packets[0].nh.list_len);
+  EXPECT_EQ(std::vector<uint16_t>({2}), packets[1].list);
+  EXPECT_EQ(1, packets[1].nh.list_len);
+  EXPECT_EQ(post(3, "Two").text(), packets[1].text());
+}
+
+TEST_F(PacketsTest, PacketView_UpdateRouting) {
+  net_networks_rec net{};
+  net.dir = helper_.TempDir();
+  to_char_array(net.name, "My Network");
+  net.sysnum = 2;
+  const string body = "Hello World";
+  auto text = CreateFakePacketText("MYSUB", "This is a title", "Sysop #1",
+                                   daten_to_wwivnet_time(daten_t_now()), body);
+  auto packet = CreatePacket(3, {}, text);
+  packet.nh.main_type = main_type_new_post;
+  ASSERT_TRUE(write_wwivnet_packet("p1.net", net, packet));
+
+  PacketStream stream(FilePath(net.dir, "p1.net"), false);
+  ASSERT_TRUE(stream.Open());
+  PacketView v;
+  ASSERT_EQ(ReadPacketResponse::OK, stream.Next(v));
+  ASSERT_TRUE(v.UpdateRouting(net));
+  // The text in the file isn't changed.
+  EXPECT_EQ(text, v.text());
+  EXPECT_GT(v.nh.length, text.size());
+
+  const auto p = v.ToPacket();
+  EXPECT_EQ(p.nh.length, p.text().size());
+  auto iter = p.text().begin();
+  for (int i = 0; i < 4; i++) {
+    get_message_field(p.text(), iter, {'\0', '\r', '\n'}, 80);
+  }
+  auto route = get_message_field(p.text(), iter, {'\0', '\r', '\n'}, 80);
+  EXPECT_TRUE(starts_with(route, "\004"
+                                 "0R"));
+  EXPECT_TRUE(ends_with(route, "->2"));
+  EXPECT_TRUE(ends_with(p.text(), body + "\x1a"));
+
+  {
+    PacketWriterPool pool(net);
+    EXPECT_TRUE(pool.Write("s3.net", v));
+  }
+  ASSERT_TRUE(write_wwivnet_packet("d3.net", net, p));
+  EXPECT_EQ(helper_.ReadFile(FilePath(net.dir, "d3.net")),
+            helper_.ReadFile(FilePath(net.dir, "s3.net")));
+}
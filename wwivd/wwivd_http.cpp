@@ -27,10 +27,13 @@
 #include <cereal/types/string.hpp>
 #include <cereal/types/vector.hpp>
 
+#include "core/file.h"
+#include "core/findfiles.h"
 #include "core/http_server.h"
 #include "core/inifile.h"
 #include "core/jsonfile.h"
 #include "core/log.h"
+#include "core/metrics.h"
 #include "core/net.h"
 #include "core/os.h"
 #include "core/scope_exit.h"
@@ -38,9 +41,11 @@
 #include "core/socket_connection.h"
 #include "core/stl.h"
 #include "core/strings.h"
+#include "core/textfile.h"
 #include "core/version.h"
 #include "core/wwivport.h"
 #include "sdk/config.h"
+#include "sdk/networks.h"
 #include "core/datetime.h"
 #include "wwivd/connection_data.h"
 #include "wwivd/node_manager.h"
@@ -104,6 +109,49 @@ private:
   std::map<const string, std::shared_ptr<NodeManager>>* nodes_;
 };
 
+// The metrics for wwivd itself, and the last snapshot written by each of the
+// network commands (i.e. network1.metrics.json) in each network directory.
+static string MetricsJson(const Config& config) {
+  std::ostringstream ss;
+  ss << "{\"wwivd\":" << Metrics::Global().ToJson() << ",\"networks\":{";
+  Networks networks(config);
+  auto first = true;
+  for (const auto& net : networks.networks()) {
+    ss << (first ? "" : ",") << JsonString(net.name) << ":{";
+    first = false;
+    auto first_file = true;
+    FindFiles ff(net.dir, "*.metrics.json", FindFilesType::files);
+    for (const auto& f : ff) {
+      TextFile file(FilePath(net.dir, f.name), "rt");
+      const auto snapshot = file.ReadFileIntoString();
+      if (snapshot.empty()) {
+        continue;
+      }
+      const auto command = f.name.substr(0, f.name.find('.'));
+      ss << (first_file ? "" : ",") << JsonString(command) << ":" << snapshot;
+      first_file = false;
+    }
+    ss << "}";
+  }
+  ss << "}}";
+  return ss.str();
+}
+
+class MetricsHandler : public HttpHandler {
+public:
+  MetricsHandler(const Config* config) : config_(config) {}
+
+  HttpResponse Handle(HttpMethod, const std::string&, std::vector<std::string>) override {
+    HttpResponse response(200);
+    response.headers.emplace("Content-Type: ", "text/json");
+    response.text = MetricsJson(*config_);
+    return response;
+  }
+
+private:
+  const Config* config_;
+};
+
 void HandleHttpConnection(ConnectionData data, accepted_socket_t r) {
   auto sock = r.client_socket;
   const auto& b = data.c->blocking;
@@ -120,6 +168,9 @@ void HandleHttpConnection(ConnectionData data, accepted_socket_t r) {
     HttpServer h(std::make_unique<SocketConnection>(r.client_socket));
     StatusHandler status(data.nodes);
     h.add(HttpMethod::GET, "/status", &status);
+    MetricsHandler metrics(data.config);
+    h.add(HttpMethod::GET, "/metrics", &metrics);
+    Metrics::Global().counter("wwivd.http_connections").Add();
     h.Run();
 
   }
@@ -121,23 +121,22 @@ static int dump_stored_message(const std::string& filename) {
 }
 
 static int dump_packet_file(const std::string& filename) {
-  File f(filename);
-  if (!f.Open(File::modeBinary | File::modeReadOnly)) {
+  FidoPacketReader f(filename);
+  if (!f.Open()) {
     LOG(ERROR) << "Unable to open file: " << filename;
     return 1;
   }
 
   bool done = false;
   packet_header_2p_t header = {};
-  auto num_header_read = f.Read(&header, sizeof(packet_header_2p_t));
-  if (num_header_read < sizeof(packet_header_2p_t)) {
+  if (!f.ReadHeader(header)) {
     LOG(ERROR) << "Read less than packet header";
     return 1;
   }
 
   while (!done) {
     FidoPackedMessage msg;
-    ReadPacketResponse response = read_packed_message(f, msg);
+    ReadPacketResponse response = f.Next(msg);
     if (response == ReadPacketResponse::END_OF_FILE) {
       return 0;
     } else if (response == ReadPacketResponse::ERROR) {
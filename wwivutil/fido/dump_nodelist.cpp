@@ -49,14 +49,14 @@ static int dump_file(const std::string& filename) {
     return 1;
   }
 
-  const auto& entries = n.entries();
+  const auto entries = n.entries();
 
   auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
   cout << "Parsed " << entries.size() << " in " << elapsed.count() << " milliseconds. " << std::endl;
   cout << "Parsed " << entries.size() << " in " << elapsed.count()/1000 << " seconds. " << std::endl;
 
   for (const auto& e : entries) {
-    cout << e.first << ":" << e.second.name_ << std::endl;
+    cout << e.address_ << ":" << e.name_ << std::endl;
   }
   return 0;
 }
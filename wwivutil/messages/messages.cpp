@@ -147,6 +147,67 @@ public:
   }
 };
 
+class CompactMessageCommand : public UtilCommand {
+public:
+  CompactMessageCommand()
+      : UtilCommand("compact", "Removes deleted messages from a message area in place.") {}
+
+  virtual ~CompactMessageCommand() {}
+
+  std::string GetUsage() const override final {
+    std::ostringstream ss;
+    ss << "Usage:   compact <base sub filename>" << endl;
+    ss << "Example: compact general" << endl;
+    return ss.str();
+  }
+
+  int Execute() override final {
+    if (remaining().empty()) {
+      clog << "Missing sub basename." << endl;
+      cout << GetUsage() << GetHelp() << endl;
+      return 2;
+    }
+
+    const string basename(remaining().front());
+    wwiv::sdk::msgapi::MessageApiOptions options;
+    auto api = make_unique<WWIVMessageApi>(options, *config()->config(),
+                                           config()->networks().networks(), new NullLastReadImpl());
+
+    subboard_t sub{};
+    const auto& datadir = config()->config()->datadir();
+    const auto& nets = config()->networks().networks();
+    Subs subs(datadir, nets);
+    if (!find_sub(subs, basename, sub)) {
+      // set default.
+      sub.storage_type = 2;
+      sub.filename = basename;
+    }
+
+    unique_ptr<MessageArea> area;
+    try {
+      area.reset(api->Open(sub, -1));
+    } catch (const bad_message_area&) {
+      clog << "Error opening message area: '" << basename << "'." << endl;
+      return 1;
+    }
+    if (!area) {
+      clog << "Unable to Open message area: '" << sub.filename << "'." << endl;
+      return 1;
+    }
+
+    auto before = area->number_of_messages();
+    if (!area->Compact()) {
+      LOG(ERROR) << "Unable to compact message area: '" << basename << "'; Try packing this sub.";
+      return 1;
+    }
+    cout << "Message Sub: '" << basename << "' had " << before << " messages, now has "
+         << area->number_of_messages() << "." << endl;
+    return 0;
+  }
+
+  bool AddSubCommands() override final { return true; }
+};
+
 class PostMessageCommand : public UtilCommand {
 public:
   PostMessageCommand() : UtilCommand("post", "Posts a new message.") {}
@@ -349,18 +410,39 @@ public:
       }
       unique_ptr<MessageArea> newarea(api->Open(newsub, -1));
       auto total = area->number_of_messages();
+      // Add the messages in batches so the new area is only written to
+      // once per batch.
+      static constexpr size_t BATCH_SIZE = 100;
+      vector<unique_ptr<Message>> messages;
+      auto add_batch = [&]() {
+        vector<const Message*> batch;
+        for (const auto& m : messages) {
+          batch.push_back(m.get());
+        }
+        if (!newarea->AddMessages(batch, {})) {
+          LOG(ERROR) << "Error adding " << batch.size() << " messages starting with: "
+                     << batch.front()->header().title();
+        }
+        messages.clear();
+      };
       for (auto i = 1; i <= total; i++) {
         unique_ptr<Message> message(area->ReadMessage(i));
         if (!message) {
           LOG(ERROR) << "Unable to load message #" << i;
           continue;
         }
-        if (!newarea->AddMessage(*message.get(), {})) {
-          LOG(ERROR) << "Error adding message: " << message->header().title();
-        } else {
-          cout << "[" << i << "]";
+        if (message->header().deleted()) {
+          continue;
+        }
+        messages.push_back(std::move(message));
+        cout << "[" << i << "]";
+        if (messages.size() >= BATCH_SIZE) {
+          add_batch();
         }
       }
+      if (!messages.empty()) {
+        add_batch();
+      }
     }
 
     // Copy "new" versions back to sub and dat
@@ -425,6 +507,9 @@ bool MessagesCommand::AddSubCommands() {
   if (!add(make_unique<DeleteMessageCommand>())) {
     return false;
   }
+  if (!add(make_unique<CompactMessageCommand>())) {
+    return false;
+  }
   if (!add(make_unique<PostMessageCommand>())) {
     return false;
   }